@@ -0,0 +1,76 @@
+// Measures the build time and memory footprint of the Adaptive Cubic infill octree
+// and the time to extract the infill lines from it layer by layer.
+//
+// Usage: adaptive_octree [mesh.stl]
+// A sphere is used if no mesh is provided.
+
+#include <iostream>
+#include <iomanip>
+
+#include <libslic3r/TriangleMesh.hpp>
+#include <libslic3r/Surface.hpp>
+#include <libslic3r/Fill/FillAdaptive.hpp>
+
+#include "libnest2d/tools/benchmark.h"
+
+using namespace Slic3r;
+
+int main(const int argc, const char *argv[])
+{
+    TriangleMesh mesh;
+    if (argc > 1) {
+        if (! mesh.ReadSTLFile(argv[1])) {
+            std::cerr << "Failed to load " << argv[1] << std::endl;
+            return EXIT_FAILURE;
+        }
+    } else
+        mesh = TriangleMesh(its_make_sphere(50., 2. * PI / 360.));
+
+    // Center the mesh and rotate it to the coordinate system of the octree, the same way PrintObject does it.
+    indexed_triangle_set its = mesh.its;
+    BoundingBoxf3 bbox = mesh.bounding_box();
+    Transform3d trafo = Transform3d::Identity();
+    trafo.rotate(FillAdaptive::transform_to_octree());
+    trafo.translate(- bbox.center());
+    its_transform(its, trafo);
+    const double z_min = - 0.5 * bbox.size().z();
+    const double z_max =   0.5 * bbox.size().z();
+    std::cout << "Triangles: " << its.indices.size() << std::endl;
+
+    for (double line_spacing : { 10., 5., 2.5, 1.25 }) {
+        for (bool support_overhangs_only : { false, true }) {
+            Benchmark b;
+            b.start();
+            FillAdaptive::OctreePtr octree = FillAdaptive::build_octree(its, {}, line_spacing, support_overhangs_only);
+            b.stop();
+            const double build_time = b.getElapsedSec();
+            FillAdaptive::OctreeStats stats = FillAdaptive::octree_stats(*octree);
+
+            // Extract the infill lines for all layers of 0.2mm.
+            FillAdaptive::Filler filler;
+            filler.adapt_fill_octree = octree.get();
+            filler.spacing           = 0.45;
+            filler.angle             = 0.f;
+            filler.bounding_box      = get_extents(mesh.horizontal_projection());
+            FillParams params;
+            params.density           = float(0.45 / line_spacing);
+            Surface surface(stInternal, ExPolygon(Polygon(filler.bounding_box.polygon())));
+            size_t num_lines = 0;
+            size_t num_layers = 0;
+            b.start();
+            for (double z = z_min + 0.1; z < z_max; z += 0.2, ++ num_layers) {
+                filler.z        = z;
+                filler.layer_id = num_layers;
+                num_lines += filler.fill_surface(&surface, params).size();
+            }
+            b.stop();
+
+            std::cout << std::fixed << std::setprecision(3) <<
+                "line spacing " << line_spacing << (support_overhangs_only ? " (support)" : "") <<
+                ": build " << build_time << " s, " << stats.num_nodes << " nodes, " << (stats.memory_bytes >> 10) << " kB, " <<
+                num_layers << " layers with " << num_lines << " lines in " << b.getElapsedSec() << " s" << std::endl;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,56 @@
+// Measures the cost of expanding a layer change custom G-code by the PlaceholderParser per layer,
+// comparing the compiled template with the same template processed by the macro processor grammar as a whole.
+//
+// Usage: placeholder_parser [num_layers]
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+#include <libslic3r/PlaceholderParser.hpp>
+#include <libslic3r/PrintConfig.hpp>
+
+#include "libnest2d/tools/benchmark.h"
+
+using namespace Slic3r;
+
+int main(const int argc, const char *argv[])
+{
+    const int num_layers = argc > 1 ? std::stoi(argv[1]) : 10000;
+
+    PlaceholderParser parser;
+    parser.apply_config(DynamicPrintConfig::full_print_config());
+    parser.set("current_extruder", 0);
+
+    const std::string layer_gcode =
+        ";AFTER_LAYER_CHANGE\n"
+        ";[layer_z]\n"
+        "G92 E0\n"
+        "M117 Layer {layer_num} Z {layer_z}\n"
+        "M104 S{temperature[current_extruder]}\n"
+        "; retract [retract_length_0] travel [travel_speed]\n"
+        "{if layer_num == 2}M221 S{extrusion_multiplier[0] * 100}{endif}\n"
+        "{if layer_z > 10 and layer_z < 10.3}M600{endif}\n";
+    // Enclosing the template into a single code block lets the grammar process it as a whole,
+    // which is how all the templates were processed before they were compiled.
+    const std::string layer_gcode_single_block = "{if true}" + layer_gcode + "{endif}";
+
+    for (const std::string *templ : { &layer_gcode_single_block, &layer_gcode }) {
+        Benchmark b;
+        size_t    num_chars = 0;
+        b.start();
+        for (int layer_num = 1; layer_num <= num_layers; ++ layer_num) {
+            DynamicConfig config;
+            config.set_key_value("layer_num", new ConfigOptionInt(layer_num));
+            config.set_key_value("layer_z",   new ConfigOptionFloat(0.2 * layer_num));
+            num_chars += parser.process(*templ, 0, &config).size();
+        }
+        b.stop();
+        std::cout << std::fixed << std::setprecision(3) <<
+            (templ == &layer_gcode ? "compiled template:     " : "single grammar block:  ") <<
+            num_layers << " layers, " << num_chars << " characters in " << b.getElapsedSec() << " s, " <<
+            1e6 * b.getElapsedSec() / num_layers << " us per layer" << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
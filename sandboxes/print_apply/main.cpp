@@ -0,0 +1,66 @@
+// Measures the cost of copying and diffing a full printer config and of Print::apply() with a full printer config,
+// which is called by the UI with a copy of the full config on every change of a parameter.
+//
+// Usage: print_apply [num_iterations]
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+#include <libslic3r/Model.hpp>
+#include <libslic3r/Print.hpp>
+#include <libslic3r/PrintConfig.hpp>
+#include <libslic3r/TriangleMesh.hpp>
+
+#include "libnest2d/tools/benchmark.h"
+
+using namespace Slic3r;
+
+template<typename Fn>
+static void measure(const char *name, int num_iterations, Fn &&fn)
+{
+    Benchmark b;
+    b.start();
+    for (int i = 0; i < num_iterations; ++ i)
+        fn(i);
+    b.stop();
+    std::cout << std::fixed << std::setprecision(3) << name << num_iterations << " iterations in " << b.getElapsedSec() << " s, " <<
+        1e6 * b.getElapsedSec() / num_iterations << " us per iteration" << std::endl;
+}
+
+int main(const int argc, const char *argv[])
+{
+    const int num_iterations = argc > 1 ? std::stoi(argv[1]) : 1000;
+
+    const DynamicPrintConfig full_config = DynamicPrintConfig::full_print_config();
+    std::cout << full_config.size() << " options in the full print config" << std::endl;
+
+    Model model;
+    ModelObject *object = model.add_object("cube", "", make_cube(20., 20., 20.));
+    object->add_instance();
+    model.center_instances_around_point({ 100., 100. });
+
+    size_t num_keys = 0;
+    measure("copy:                     ", num_iterations, [&full_config, &num_keys](int) {
+        DynamicPrintConfig config(full_config);
+        num_keys += config.size();
+    });
+    measure("diff of a copy:           ", num_iterations, [&full_config, &num_keys](int) {
+        DynamicPrintConfig config(full_config);
+        config.set_key_value("layer_height", new ConfigOptionFloat(0.1));
+        num_keys += full_config.diff(config).size();
+    });
+
+    Print print;
+    print.apply(model, full_config);
+    measure("Print::apply() unchanged: ", num_iterations, [&print, &model, &full_config](int) {
+        print.apply(model, full_config);
+    });
+    measure("Print::apply() changed:   ", num_iterations, [&print, &model, &full_config](int i) {
+        DynamicPrintConfig config(full_config);
+        config.set_key_value("perimeters", new ConfigOptionInt(2 + i % 2));
+        print.apply(model, std::move(config));
+    });
+
+    return num_keys > 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -8,6 +8,7 @@
 #include <libslic3r/AABBTreeIndirect.hpp>
 #include <libslic3r/TriangleMesh.hpp>
 
+#include <algorithm>
 #include <numeric>
 
 #ifdef SLIC3R_HOLE_RAYCASTER
@@ -20,9 +21,13 @@ class AABBMesh::AABBImpl {
 private:
     AABBTreeIndirect::Tree3f m_tree;
     double                   m_triangle_ray_epsilon;
+    VertexFaceIndex          m_vfidx; // vertex-face index
+    std::vector<Vec3i>       m_fnidx; // face-neighbor index
 
 public:
-    void init(const indexed_triangle_set &its, bool calculate_epsilon)
+    AABBImpl(const indexed_triangle_set &its, bool calculate_epsilon)
+        : m_vfidx{its}
+        , m_fnidx{its_face_neighbors(its)}
     {
         m_triangle_ray_epsilon = 0.000001;
         if (calculate_epsilon) {
@@ -35,10 +40,13 @@ public:
             its.vertices, its.indices);
     }
 
+    const VertexFaceIndex &vertex_face_index() const { return m_vfidx; }
+    const std::vector<Vec3i> &face_neighbor_index() const { return m_fnidx; }
+
     void intersect_ray(const indexed_triangle_set &its,
                        const Vec3d &               s,
                        const Vec3d &               dir,
-                       igl::Hit &                  hit)
+                       igl::Hit &                  hit) const
     {
         AABBTreeIndirect::intersect_ray_first_hit(its.vertices, its.indices,
                                                   m_tree, s, dir, hit, m_triangle_ray_epsilon);
@@ -47,7 +55,7 @@ public:
     void intersect_ray(const indexed_triangle_set &its,
                        const Vec3d &               s,
                        const Vec3d &               dir,
-                       std::vector<igl::Hit> &     hits)
+                       std::vector<igl::Hit> &     hits) const
     {
         AABBTreeIndirect::intersect_ray_all_hits(its.vertices, its.indices,
                                                  m_tree, s, dir, hits, m_triangle_ray_epsilon);
@@ -56,7 +64,7 @@ public:
     double squared_distance(const indexed_triangle_set & its,
                             const Vec3d &                point,
                             int &                        i,
-                            Eigen::Matrix<double, 1, 3> &closest)
+                            Eigen::Matrix<double, 1, 3> &closest) const
     {
         size_t idx_unsigned = 0;
         Vec3d  closest_vec3d(closest);
@@ -70,54 +78,153 @@ public:
     }
 };
 
-template<class M> void AABBMesh::init(const M &mesh, bool calculate_epsilon)
+AABBMeshCache::Index AABBMeshCache::get(const std::shared_ptr<const indexed_triangle_set> &source,
+                                        const Transform3d &trafo,
+                                        bool               calculate_epsilon)
 {
-    // Build the AABB accelaration tree
-    m_aabb->init(*m_tm, calculate_epsilon);
+    assert(source);
+
+    // Same owner, regardless of the member of the owner the pointer is aliasing.
+    auto same_source = [&source](const Entry &e) {
+        return !e.source.owner_before(source) && !source.owner_before(e.source);
+    };
+
+    auto same_key = [&same_source, &trafo, calculate_epsilon](const Entry &e) {
+        return same_source(e) && e.calculate_epsilon == calculate_epsilon &&
+               e.trafo.matrix() == trafo.matrix();
+    };
+
+    // The last user of the index may release it at any time, the locked
+    // pointers are null then.
+    auto lock_index = [](const Entry &e) {
+        return Index{e.mesh.lock(), e.aabb.lock()};
+    };
+
+    auto is_valid = [&trafo](const Index &index) {
+        return index.aabb && (index.mesh || trafo.matrix().isIdentity(0.));
+    };
+
+    if (m_enabled) {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        purge_expired();
+        for (const Entry &e : m_entries)
+            if (same_key(e)) {
+                if (Index index = lock_index(e); is_valid(index)) {
+                    ++m_hits;
+                    return index;
+                }
+                break;
+            }
+    }
+
+    ++m_misses;
+
+    Index index;
+    if (! trafo.matrix().isIdentity(0.)) {
+        indexed_triangle_set its = *source;
+        its_transform(its, trafo, true);
+        index.mesh = std::make_shared<const indexed_triangle_set>(std::move(its));
+    }
+
+    const indexed_triangle_set &its = index.mesh ? *index.mesh : *source;
+    index.aabb = std::make_shared<const AABBMesh::AABBImpl>(its, calculate_epsilon);
+
+    if (! m_enabled)
+        return index;
+
+    std::lock_guard<std::mutex> lk(m_mutex);
+    purge_expired();
+
+    // Another thread might have indexed the same mesh meanwhile, its index
+    // is kept and returned, so that all the users share a single one.
+    for (Entry &e : m_entries)
+        if (same_key(e)) {
+            if (Index shared = lock_index(e); is_valid(shared))
+                return shared;
+
+            e.mesh = index.mesh;
+            e.aabb = index.aabb;
+            return index;
+        }
+
+    m_entries.push_back({source, trafo, calculate_epsilon, index.mesh, index.aabb});
+
+    return index;
 }
 
-AABBMesh::AABBMesh(const indexed_triangle_set &tmesh, bool calculate_epsilon)
-    : m_tm(&tmesh)
-    , m_aabb(new AABBImpl())
-    , m_vfidx{tmesh}
-    , m_fnidx{its_face_neighbors(tmesh)}
+void AABBMeshCache::purge_expired()
 {
-    init(tmesh, calculate_epsilon);
+    auto it = std::remove_if(m_entries.begin(), m_entries.end(),
+                             [](const Entry &e) { return e.expired(); });
+    m_entries.erase(it, m_entries.end());
 }
 
-AABBMesh::AABBMesh(const TriangleMesh &mesh, bool calculate_epsilon)
-    : m_tm(&mesh.its)
-    , m_aabb(new AABBImpl())
-    , m_vfidx{mesh.its}
-    , m_fnidx{its_face_neighbors(mesh.its)}
+void AABBMeshCache::clear()
 {
-    init(mesh, calculate_epsilon);
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_entries.clear();
 }
 
-AABBMesh::~AABBMesh() {}
+size_t AABBMeshCache::size() const
+{
+    std::lock_guard<std::mutex> lk(m_mutex);
+    return m_entries.size();
+}
 
-AABBMesh::AABBMesh(const AABBMesh &other)
-    : m_tm(other.m_tm)
-    , m_aabb(new AABBImpl(*other.m_aabb))
-    , m_vfidx{other.m_vfidx}
-    , m_fnidx{other.m_fnidx}
-{}
+void AABBMeshCache::reset_stats()
+{
+    m_hits   = 0;
+    m_misses = 0;
+}
 
-AABBMesh &AABBMesh::operator=(const AABBMesh &other)
+AABBMeshCache &AABBMeshCache::instance()
 {
-    m_tm = other.m_tm;
-    m_aabb.reset(new AABBImpl(*other.m_aabb));
-    m_vfidx = other.m_vfidx;
-    m_fnidx = other.m_fnidx;
+    static AABBMeshCache cache;
+    return cache;
+}
 
-    return *this;
+AABBMesh::AABBMesh(const indexed_triangle_set &tmesh, bool calculate_epsilon)
+    : m_tm(&tmesh)
+    , m_aabb(std::make_shared<const AABBImpl>(tmesh, calculate_epsilon))
+{}
+
+AABBMesh::AABBMesh(const TriangleMesh &mesh, bool calculate_epsilon)
+    : AABBMesh(mesh.its, calculate_epsilon)
+{}
+
+AABBMesh::AABBMesh(std::shared_ptr<const indexed_triangle_set> mesh, bool calculate_epsilon)
+    : AABBMesh(std::move(mesh), Transform3d::Identity(), calculate_epsilon)
+{}
+
+AABBMesh::AABBMesh(std::shared_ptr<const indexed_triangle_set> mesh,
+                   const Transform3d                          &trafo,
+                   bool                                        calculate_epsilon)
+{
+    AABBMeshCache::Index index = AABBMeshCache::instance().get(mesh, trafo, calculate_epsilon);
+    m_tm_owner = index.mesh ? std::move(index.mesh) : std::move(mesh);
+    m_tm       = m_tm_owner.get();
+    m_aabb     = std::move(index.aabb);
 }
 
+AABBMesh::~AABBMesh() {}
+
+AABBMesh::AABBMesh(const AABBMesh &other) = default;
+
+AABBMesh &AABBMesh::operator=(const AABBMesh &other) = default;
+
 AABBMesh &AABBMesh::operator=(AABBMesh &&other) = default;
 
 AABBMesh::AABBMesh(AABBMesh &&other) = default;
 
+const VertexFaceIndex &AABBMesh::vertex_face_index() const
+{
+    return m_aabb->vertex_face_index();
+}
 
+const std::vector<Vec3i> &AABBMesh::face_neighbor_index() const
+{
+    return m_aabb->face_neighbor_index();
+}
 
 const std::vector<Vec3f>& AABBMesh::vertices() const
 {
@@ -215,6 +322,37 @@ AABBMesh::query_ray_hits(const Vec3d &s, const Vec3d &dir) const
     return outs;
 }
 
+std::vector<AABBMesh::hit_result>
+AABBMesh::query_ray_hit(const std::vector<Vec3d> &sources, const std::vector<Vec3d> &dirs) const
+{
+    assert(sources.size() == dirs.size());
+
+    std::vector<hit_result> hits(sources.size());
+
+    // Use a reasonable granularity to account for the worker thread synchronization cost.
+    static constexpr size_t gransize = 64;
+
+    execution::for_each(ex_tbb, size_t(0), sources.size(), [this, &sources, &dirs, &hits](size_t idx) {
+        hits[idx] = query_ray_hit(sources[idx], dirs[idx]);
+    }, gransize);
+
+    return hits;
+}
+
+std::vector<AABBMesh::hit_result>
+AABBMesh::query_ray_hit(const std::vector<Vec3d> &sources, const Vec3d &dir) const
+{
+    std::vector<hit_result> hits(sources.size());
+
+    static constexpr size_t gransize = 64;
+
+    execution::for_each(ex_tbb, size_t(0), sources.size(), [this, &sources, &dir, &hits](size_t idx) {
+        hits[idx] = query_ray_hit(sources[idx], dir);
+    }, gransize);
+
+    return hits;
+}
+
 
 #ifdef SLIC3R_HOLE_RAYCASTER
 AABBMesh::hit_result IndexedMesh::filter_hits(
@@ -5,7 +5,9 @@
 #ifndef PRUSASLICER_AABBMESH_H
 #define PRUSASLICER_AABBMESH_H
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 #include <libslic3r/Point.hpp>
@@ -28,14 +30,22 @@ class TriangleMesh;
 
 // An index-triangle structure coupled with an AABB index to support ray
 // casting and other higher level operations.
+//
+// The AABB tree and the vertex-face and face-neighbor indices are immutable
+// once built and they are shared by the copies of an AABBMesh, copying is
+// cheap. All the queries are const and may be called from multiple threads.
 class AABBMesh {
+public:
     class AABBImpl;
 
+private:
     const indexed_triangle_set* m_tm;
 
-    std::unique_ptr<AABBImpl> m_aabb;
-    VertexFaceIndex m_vfidx;    // vertex-face index
-    std::vector<Vec3i> m_fnidx; // face-neighbor index
+    // Keeps alive the mesh if it was passed in a shared pointer, or its
+    // transformed copy.
+    std::shared_ptr<const indexed_triangle_set> m_tm_owner;
+
+    std::shared_ptr<const AABBImpl> m_aabb;
 
 #ifdef SLIC3R_HOLE_RAYCASTER
     // This holds a copy of holes in the mesh. Initialized externally
@@ -43,14 +53,22 @@ class AABBMesh {
     std::vector<sla::DrainHole> m_holes;
 #endif
 
-    template<class M> void init(const M &mesh, bool calculate_epsilon);
-
 public:
 
     // calculate_epsilon ... calculate epsilon for triangle-ray intersection from an average triangle edge length.
     // If set to false, a default epsilon is used, which works for "reasonable" meshes.
+    // The mesh is referenced, it has to outlive the AABBMesh.
     explicit AABBMesh(const indexed_triangle_set &tmesh, bool calculate_epsilon = false);
     explicit AABBMesh(const TriangleMesh &mesh, bool calculate_epsilon = false);
+
+    // The mesh is kept alive by the AABBMesh. The acceleration structures are
+    // taken from AABBMeshCache, thus they are built only once for the same
+    // mesh object and transformation. With a transformation, the AABBMesh
+    // works on a transformed copy of the mesh, also shared through the cache.
+    explicit AABBMesh(std::shared_ptr<const indexed_triangle_set> mesh, bool calculate_epsilon = false);
+    AABBMesh(std::shared_ptr<const indexed_triangle_set> mesh,
+             const Transform3d                          &trafo,
+             bool                                        calculate_epsilon = false);
     
     AABBMesh(const AABBMesh& other);
     AABBMesh& operator=(const AABBMesh&);
@@ -124,6 +142,13 @@ public:
     // Casts a ray on the mesh and returns all hits
     std::vector<hit_result> query_ray_hits(const Vec3d &s, const Vec3d &dir) const;
 
+    // Casting a batch of rays in parallel, one result per ray in the order
+    // of the sources.
+    std::vector<hit_result> query_ray_hit(const std::vector<Vec3d> &sources,
+                                          const std::vector<Vec3d> &dirs) const;
+    std::vector<hit_result> query_ray_hit(const std::vector<Vec3d> &sources,
+                                          const Vec3d              &dir) const;
+
     double squared_distance(const Vec3d& p, int& i, Vec3d& c) const;
     inline double squared_distance(const Vec3d &p) const
     {
@@ -136,8 +161,88 @@ public:
 
     const indexed_triangle_set * get_triangle_mesh() const { return m_tm; }
 
-    const VertexFaceIndex &vertex_face_index() const { return m_vfidx; }
-    const std::vector<Vec3i> &face_neighbor_index() const { return m_fnidx; }
+    const VertexFaceIndex &vertex_face_index() const;
+    const std::vector<Vec3i> &face_neighbor_index() const;
+
+    // Whether the acceleration structures are shared with other.
+    bool shares_index_with(const AABBMesh &other) const { return m_aabb && m_aabb == other.m_aabb; }
+};
+
+// Cache of the acceleration structures of AABBMeshes created from shared
+// meshes.
+//
+// The same mesh is often raycast by several independent users, e.g. the SLA
+// support point generator and the support tree builder of every rerun of the
+// support steps, or the raycasters of the GUI gizmos. The key is the identity
+// of the mesh object (the owner of the shared pointer) and the transformation,
+// so a mesh revision, which is always a new object, is indexed only once.
+// The cache holds only weak references, it does not retain any index: an
+// entry lives as long as its source mesh and at least one AABBMesh using the
+// index. Expired entries are dropped on the next access to the cache.
+class AABBMeshCache
+{
+public:
+    struct Stats
+    {
+        size_t hits   = 0;
+        size_t misses = 0;
+
+        double hit_rate() const
+        {
+            return hits + misses > 0 ? double(hits) / double(hits + misses) : 0.;
+        }
+    };
+
+    // The possibly transformed mesh and its acceleration structures. The mesh
+    // is null for the identity transformation, the source is used then.
+    struct Index
+    {
+        std::shared_ptr<const indexed_triangle_set> mesh;
+        std::shared_ptr<const AABBMesh::AABBImpl>   aabb;
+    };
+
+    Index get(const std::shared_ptr<const indexed_triangle_set> &source,
+              const Transform3d                                 &trafo,
+              bool                                               calculate_epsilon);
+
+    // A disabled cache builds every index and neither reads nor stores any.
+    void set_enabled(bool enabled) { m_enabled = enabled; }
+    bool is_enabled() const { return m_enabled; }
+
+    void   clear();
+    size_t size() const;
+    Stats  stats() const { return {m_hits, m_misses}; }
+    void   reset_stats();
+
+    // The cache shared by all the AABBMeshes of the application.
+    static AABBMeshCache &instance();
+
+private:
+    struct Entry
+    {
+        std::weak_ptr<const indexed_triangle_set> source;
+        Transform3d trafo;
+        bool        calculate_epsilon;
+        // Null for the identity transformation.
+        std::weak_ptr<const indexed_triangle_set> mesh;
+        std::weak_ptr<const AABBMesh::AABBImpl>   aabb;
+
+        bool expired() const
+        {
+            return source.expired() || aabb.expired() ||
+                   (!trafo.matrix().isIdentity(0.) && mesh.expired());
+        }
+    };
+
+    void purge_expired();
+
+    mutable std::mutex m_mutex;
+
+    std::vector<Entry> m_entries;
+
+    std::atomic<size_t> m_hits{0};
+    std::atomic<size_t> m_misses{0};
+    std::atomic<bool>   m_enabled{true};
 };
 
 
@@ -149,6 +149,30 @@ template<> struct KernelTraits_<VariantKernel> {
         return ret;
     }
 
+    template<class ArrItem>
+    static void placement_fitness_batch(const VariantKernel        &kernel,
+                                        const ArrItem              &itm,
+                                        const std::vector<Vec2crd> &transl,
+                                        std::vector<double>        &fitness)
+    {
+        boost::apply_visitor([&](auto &k) {
+            KernelTraits<decltype(k)>::placement_fitness_batch(k, itm, transl, fitness);
+        }, kernel);
+    }
+
+    template<class ArrItem>
+    static double fitness_upper_bound(const VariantKernel &kernel,
+                                      const ArrItem       &itm,
+                                      const BoundingBox   &transl_bounds)
+    {
+        double ret = NaNd;
+        boost::apply_visitor([&](auto &k) {
+            ret = KernelTraits<decltype(k)>::fitness_upper_bound(k, itm, transl_bounds);
+        }, kernel);
+
+        return ret;
+    }
+
     template<class ArrItem, class Bed, class Ctx, class RemIt>
     static bool on_start_packing(VariantKernel &kernel,
                                  ArrItem &itm,
@@ -60,6 +60,39 @@ void EdgeCache::sample_contour(double accuracy, std::vector<ContourLocation> &sa
     }
 }
 
+BoundingBox EdgeCache::bounding_box(const ContourLocation &from, double to) const
+{
+    assert(from.contour_id <= m_holes.size());
+
+    const ContourCache &cache = from.contour_id > 0 ?
+                                    m_holes[from.contour_id - 1] :
+                                    m_contour;
+
+    const Points              &pts       = cache.poly->points;
+    const std::vector<double> &distances = cache.distances;
+
+    BoundingBox ret;
+    ret.merge(coords(cache, from.dist));
+    ret.merge(coords(cache, to));
+
+    // Vertex i + 1 lies at distances[i] along the circumference
+    auto merge_vertices = [&](double a, double b) {
+        auto it = std::lower_bound(distances.begin(), distances.end(),
+                                   a * distances.back());
+        for (; it != distances.end() && *it <= b * distances.back(); ++it)
+            ret.merge(pts[(it - distances.begin() + 1) % pts.size()]);
+    };
+
+    if (from.dist <= to) {
+        merge_vertices(from.dist, to);
+    } else {
+        merge_vertices(from.dist, 1.);
+        merge_vertices(0., to);
+    }
+
+    return ret;
+}
+
 Vec2crd coords(const Polygon &poly, const std::vector<double> &distances, double distance)
 {
     assert(poly.size() > 1 && distance >= .0 && distance <= 1.0);
@@ -8,6 +8,7 @@
 #include <vector>
 
 #include <libslic3r/ExPolygon.hpp>
+#include <libslic3r/BoundingBox.hpp>
 
 namespace Slic3r { namespace arr2 {
 
@@ -68,6 +69,11 @@ public:
                    coords(m_holes[loc.contour_id - 1], loc.dist) :
                    coords(m_contour, loc.dist);
     }
+
+    // Bounding box of the circumference going forward from location 'from'
+    // to the distance 'to' on the same contour, wrapping around its start if
+    // 'to' is smaller than from.dist.
+    BoundingBox bounding_box(const ContourLocation &from, double to) const;
 };
 
 }} // namespace Slic3r::arr2
@@ -32,6 +32,30 @@ struct GravityKernel {
         return - (center - active_sink).squaredNorm();
     }
 
+    template<class ArrItem>
+    void placement_fitness_batch(const ArrItem              &itm,
+                                 const std::vector<Vec2crd> &transl,
+                                 std::vector<double>        &fitness) const
+    {
+        Vec2d center = unscaled(envelope_centroid(itm));
+
+        fitness.resize(transl.size());
+        for (size_t i = 0; i < transl.size(); ++i)
+            fitness[i] = - (center + unscaled(transl[i]) - active_sink).squaredNorm();
+    }
+
+    // The item center closest to the sink within the translated centers
+    template<class ArrItem>
+    double fitness_upper_bound(const ArrItem &itm, const BoundingBox &transl_bounds) const
+    {
+        Vec2d center = unscaled(envelope_centroid(itm));
+        Vec2d minc   = center + unscaled(transl_bounds.min);
+        Vec2d maxc   = center + unscaled(transl_bounds.max);
+        Vec2d closest = active_sink.cwiseMax(minc).cwiseMin(maxc);
+
+        return - (closest - active_sink).squaredNorm();
+    }
+
     template<class ArrItem, class Bed, class Ctx, class RemIt>
     bool on_start_packing(ArrItem &itm,
                           const Bed &bed,
@@ -5,10 +5,37 @@
 #ifndef KERNELTRAITS_HPP
 #define KERNELTRAITS_HPP
 
+#include <limits>
+#include <type_traits>
+
 #include "libslic3r/Arrange/Core/ArrangeItemTraits.hpp"
+#include "libslic3r/BoundingBox.hpp"
 
 namespace Slic3r { namespace arr2 {
 
+namespace detail {
+
+template<class Kernel, class ArrItem, class En = void>
+struct HasFitnessBatch_ : public std::false_type {};
+
+template<class Kernel, class ArrItem>
+struct HasFitnessBatch_<Kernel, ArrItem, std::void_t<decltype(
+    std::declval<const Kernel &>().placement_fitness_batch(
+        std::declval<const ArrItem &>(),
+        std::declval<const std::vector<Vec2crd> &>(),
+        std::declval<std::vector<double> &>()))>> : public std::true_type {};
+
+template<class Kernel, class ArrItem, class En = void>
+struct HasFitnessUpperBound_ : public std::false_type {};
+
+template<class Kernel, class ArrItem>
+struct HasFitnessUpperBound_<Kernel, ArrItem, std::void_t<decltype(
+    std::declval<const Kernel &>().fitness_upper_bound(
+        std::declval<const ArrItem &>(),
+        std::declval<const BoundingBox &>()))>> : public std::true_type {};
+
+} // namespace detail
+
 // An arrangement kernel that specifies the object function to the arrangement
 // optimizer and additional callback functions to be able to track the state
 // of the arranged pile during arrangement.
@@ -27,6 +54,41 @@ template<class Kernel, class En = void> struct KernelTraits_
         return k.placement_fitness(itm, transl);
     }
 
+    // The same as placement_fitness() for every translation in transl, the
+    // scores are written into fitness in the same order. A kernel can define
+    // placement_fitness_batch() to compute the parts of the score that do not
+    // depend on the translation only once per batch.
+    template<class ArrItem>
+    static void placement_fitness_batch(const Kernel               &k,
+                                        const ArrItem              &itm,
+                                        const std::vector<Vec2crd> &transl,
+                                        std::vector<double>        &fitness)
+    {
+        if constexpr (detail::HasFitnessBatch_<Kernel, ArrItem>::value) {
+            k.placement_fitness_batch(itm, transl, fitness);
+        } else {
+            fitness.resize(transl.size());
+            for (size_t i = 0; i < transl.size(); ++i)
+                fitness[i] = k.placement_fitness(itm, transl[i]);
+        }
+    }
+
+    // Has to return a value that is not smaller than placement_fitness() for
+    // any translation within transl_bounds. The optimizer does not search
+    // around candidate positions whose bound is below an already found
+    // score. Kernels which do not define fitness_upper_bound() are never
+    // pruned this way.
+    template<class ArrItem>
+    static double fitness_upper_bound(const Kernel      &k,
+                                      const ArrItem     &itm,
+                                      const BoundingBox &transl_bounds)
+    {
+        if constexpr (detail::HasFitnessUpperBound_<Kernel, ArrItem>::value)
+            return k.fitness_upper_bound(itm, transl_bounds);
+        else
+            return std::numeric_limits<double>::infinity();
+    }
+
     // Called whenever a new item is about to be processed by the optimizer.
     // The current state of the arrangement can be saved by the kernel: the
     // already placed items and the remaining items that need to fit into a
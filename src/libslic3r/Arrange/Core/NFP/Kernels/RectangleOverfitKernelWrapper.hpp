@@ -63,6 +63,29 @@ struct RectangleOverfitKernelWrapper {
         return score;
     }
 
+    template<class ArrItem>
+    void placement_fitness_batch(const ArrItem              &item,
+                                 const std::vector<Vec2crd> &transl,
+                                 std::vector<double>        &fitness) const
+    {
+        KernelTraits<Kernel>::placement_fitness_batch(k, item, transl, fitness);
+
+        auto itmbb = envelope_bounding_box(item);
+        for (size_t i = 0; i < transl.size(); ++i) {
+            auto bb = itmbb;
+            bb.translate(transl[i]);
+            double miss = overfit(bb);
+            fitness[i] -= miss * miss;
+        }
+    }
+
+    // The penalty is never negative
+    template<class ArrItem>
+    double fitness_upper_bound(const ArrItem &item, const BoundingBox &transl_bounds) const
+    {
+        return KernelTraits<Kernel>::fitness_upper_bound(k, item, transl_bounds);
+    }
+
     template<class ArrItem, class Bed, class Ctx, class RemIt>
     bool on_start_packing(ArrItem &itm,
                           const Bed &bed,
@@ -74,6 +74,20 @@ struct SVGDebugOutputKernelWrapper {
         return KernelTraits<Kernel>::placement_fitness(k, item, transl);
     }
 
+    template<class ArrItem>
+    void placement_fitness_batch(const ArrItem              &item,
+                                 const std::vector<Vec2crd> &transl,
+                                 std::vector<double>        &fitness) const
+    {
+        KernelTraits<Kernel>::placement_fitness_batch(k, item, transl, fitness);
+    }
+
+    template<class ArrItem>
+    double fitness_upper_bound(const ArrItem &item, const BoundingBox &transl_bounds) const
+    {
+        return KernelTraits<Kernel>::fitness_upper_bound(k, item, transl_bounds);
+    }
+
     template<class ArrItem>
     bool on_item_packed(ArrItem &itm)
     {
@@ -10,6 +10,8 @@
 
 #include "KernelUtils.hpp"
 
+#include <limits>
+
 #include <boost/geometry/index/rtree.hpp>
 #include <libslic3r/BoostAdapter.hpp>
 
@@ -44,32 +46,56 @@ class TMArrangeKernel {
     // Treat big items (compared to the print bed) differently
     bool is_big(double a) const { return a / m_bin_area > BigItemTreshold; }
 
-protected:
-    std::optional<Point> sink;
-    std::optional<Point> item_sink;
-    Point                active_sink;
+    // Properties of the candidate item that do not depend on its translation
+    struct Candidate {
+        BoundingBox bb;
+        Point       centroid;
+        double      area;
+        bool        is_big;
 
-    const BoundingBox & pilebb() const { return m_pilebb; }
+        // Distinction of cases for the arrangement scene
+        enum e_cases {
+            // This branch is for big items in a mixed (big and small) scene
+            // OR for all items in a small-only scene.
+            BIG_ITEM,
 
-public:
-    TMArrangeKernel() = default;
-    TMArrangeKernel(Vec2crd gravity_center, size_t itm_cnt, double bedarea = NaNd)
-        : sink{gravity_center}
-        , m_bin_area(bedarea)
-        , m_item_cnt{itm_cnt}
-    {}
+            // This branch is for the last big item in a mixed scene
+            LAST_BIG_ITEM,
 
-    TMArrangeKernel(size_t itm_cnt, double bedarea = NaNd)
-        : m_bin_area(bedarea), m_item_cnt{itm_cnt}
-    {}
+            // For small items in a mixed scene.
+            SMALL_ITEM,
 
-    template<class ArrItem>
-    double placement_fitness(const ArrItem &item, const Vec2crd &transl) const
+            WIPE_TOWER,
+        } compute_case;
+    };
+
+    template<class ArrItem> Candidate candidate(const ArrItem &item) const
+    {
+        Candidate ret;
+        ret.bb       = envelope_bounding_box(item);
+        ret.centroid = envelope_centroid(item);
+        ret.area     = fixed_area(item);
+        ret.is_big   = is_big(envelope_area(item));
+
+        bool bigitems = ret.is_big || m_rtree.empty();
+        if (is_wipe_tower(item))
+            ret.compute_case = Candidate::WIPE_TOWER;
+        else if (bigitems && m_rem_cnt > 0)
+            ret.compute_case = Candidate::BIG_ITEM;
+        else if (bigitems && m_rem_cnt == 0)
+            ret.compute_case = Candidate::LAST_BIG_ITEM;
+        else
+            ret.compute_case = Candidate::SMALL_ITEM;
+
+        return ret;
+    }
+
+    double placement_fitness(const Candidate &itm, const Vec2crd &transl) const
     {
         // Candidate item bounding box
-        auto ibb = envelope_bounding_box(item);
+        auto ibb = itm.bb;
         ibb.translate(transl);
-        auto itmcntr = envelope_centroid(item);
+        auto itmcntr = itm.centroid;
         itmcntr += transl;
 
         // Calculate the full bounding box of the pile with the candidate item
@@ -93,38 +119,12 @@ public:
         // Density is the pack density: how big is the arranged pile
         double density = 0;
 
-        // Distinction of cases for the arrangement scene
-        enum e_cases {
-            // This branch is for big items in a mixed (big and small) scene
-            // OR for all items in a small-only scene.
-            BIG_ITEM,
-
-            // This branch is for the last big item in a mixed scene
-            LAST_BIG_ITEM,
-
-            // For small items in a mixed scene.
-            SMALL_ITEM,
-
-            WIPE_TOWER,
-        } compute_case;
-
-        bool is_wt = is_wipe_tower(item);
-        bool bigitems = is_big(envelope_area(item)) || m_rtree.empty();
-        if (is_wt)
-            compute_case = WIPE_TOWER;
-        else if (bigitems && m_rem_cnt > 0)
-            compute_case = BIG_ITEM;
-        else if (bigitems && m_rem_cnt == 0)
-            compute_case = LAST_BIG_ITEM;
-        else
-            compute_case = SMALL_ITEM;
-
-        switch (compute_case) {
-        case WIPE_TOWER: {
+        switch (itm.compute_case) {
+        case Candidate::WIPE_TOWER: {
             score = (unscaled(itmcntr) - unscaled(active_sink)).squaredNorm();
             break;
         }
-        case BIG_ITEM: {
+        case Candidate::BIG_ITEM: {
             const Point& minc = ibb.min; // bottom left corner
             const Point& maxc = ibb.max; // top right corner
 
@@ -138,13 +138,13 @@ public:
             auto cc = fullbb.center(); // The gravity center
             dists[0] = (minc - cc).cast<double>().norm();
             dists[1] = (maxc - cc).cast<double>().norm();
-            dists[2] = (itmcntr - cc).template cast<double>().norm();
+            dists[2] = (itmcntr - cc).cast<double>().norm();
             dists[3] = (top_left - cc).cast<double>().norm();
             dists[4] = (bottom_right - cc).cast<double>().norm();
 
             // The smalles distance from the arranged pile center:
             double dist = norm(*(std::min_element(dists.begin(), dists.end())));
-            double bindist = norm((ibb.center() - active_sink).template cast<double>().norm());
+            double bindist = norm((ibb.center() - active_sink).cast<double>().norm());
             dist = 0.8 * dist + 0.2 * bindist;
 
             // Prepare a variable for the alignment score.
@@ -156,7 +156,7 @@ public:
             auto alignment_score = 1.0;
 
             auto query = bgi::intersects(ibb);
-            auto& index = is_big(envelope_area(item)) ? m_rtree : m_smallsrtree;
+            auto& index = itm.is_big ? m_rtree : m_smallsrtree;
 
             // Query the spatial index for the neighbors
             std::vector<SpatElement> result;
@@ -169,11 +169,11 @@ public:
                 auto idx = e.second;
                 const ItemStats& p = m_itemstats[idx];
                 auto parea = p.area;
-                if(std::abs(1.0 - parea / fixed_area(item)) < 1e-6) {
+                if(std::abs(1.0 - parea / itm.area) < 1e-6) {
                     auto bb = p.bb;
                     bb.merge(ibb);
                     auto bbarea = area(bb);
-                    auto ascore = 1.0 - (fixed_area(item) + parea) / bbarea;
+                    auto ascore = 1.0 - (itm.area + parea) / bbarea;
 
                     if(ascore < alignment_score)
                         alignment_score = ascore;
@@ -196,16 +196,16 @@ public:
 
             break;
         }
-        case LAST_BIG_ITEM: {
-            score = norm((itmcntr - m_pilebb.center()).template cast<double>().norm());
+        case Candidate::LAST_BIG_ITEM: {
+            score = norm((itmcntr - m_pilebb.center()).cast<double>().norm());
             break;
         }
-        case SMALL_ITEM: {
+        case Candidate::SMALL_ITEM: {
             // Here there are the small items that should be placed around the
             // already processed bigger items.
             // No need to play around with the anchor points, the center will be
             // just fine for small items
-            score = norm((itmcntr - bigbb.center()).template cast<double>().norm());
+            score = norm((itmcntr - bigbb.center()).cast<double>().norm());
             break;
         }
         }
@@ -213,6 +213,87 @@ public:
         return -score;
     }
 
+
+protected:
+    std::optional<Point> sink;
+    std::optional<Point> item_sink;
+    Point                active_sink;
+
+    const BoundingBox & pilebb() const { return m_pilebb; }
+
+public:
+    TMArrangeKernel() = default;
+    TMArrangeKernel(Vec2crd gravity_center, size_t itm_cnt, double bedarea = NaNd)
+        : sink{gravity_center}
+        , m_bin_area(bedarea)
+        , m_item_cnt{itm_cnt}
+    {}
+
+    TMArrangeKernel(size_t itm_cnt, double bedarea = NaNd)
+        : m_bin_area(bedarea), m_item_cnt{itm_cnt}
+    {}
+
+    template<class ArrItem>
+    double placement_fitness(const ArrItem &item, const Vec2crd &transl) const
+    {
+        return placement_fitness(candidate(item), transl);
+    }
+
+    template<class ArrItem>
+    void placement_fitness_batch(const ArrItem              &item,
+                                 const std::vector<Vec2crd> &transl,
+                                 std::vector<double>        &fitness) const
+    {
+        Candidate itm = candidate(item);
+
+        fitness.resize(transl.size());
+        for (size_t i = 0; i < transl.size(); ++i)
+            fitness[i] = placement_fitness(itm, transl[i]);
+    }
+
+    // Only the cases scored by the distance of the item center from a fixed
+    // point are bounded. The score of a big item has its alignment with the
+    // neighbors in it, which can make up for the distance.
+    template<class ArrItem>
+    double fitness_upper_bound(const ArrItem &item, const BoundingBox &transl_bounds) const
+    {
+        Candidate itm = candidate(item);
+
+        BoundingBox centers{Point{itm.centroid + transl_bounds.min},
+                            Point{itm.centroid + transl_bounds.max}};
+
+        auto dist = [&centers](const Point &p) {
+            Vec2d closest = p.cast<double>()
+                                .cwiseMax(centers.min.cast<double>())
+                                .cwiseMin(centers.max.cast<double>());
+
+            return (closest - p.cast<double>()).norm();
+        };
+
+        double ret = std::numeric_limits<double>::infinity();
+        switch (itm.compute_case) {
+        case Candidate::WIPE_TOWER: {
+            double d = unscaled(dist(active_sink));
+            ret = -d * d;
+            break;
+        }
+        case Candidate::LAST_BIG_ITEM:
+            ret = -norm(dist(m_pilebb.center()));
+            break;
+        case Candidate::SMALL_ITEM: {
+            // The small item case implies a non-empty m_rtree
+            BoundingBox bigbb;
+            boost::geometry::convert(m_rtree.bounds(), bigbb);
+            ret = -norm(dist(bigbb.center()));
+            break;
+        }
+        case Candidate::BIG_ITEM:
+            break;
+        }
+
+        return ret;
+    }
+
     template<class ArrItem, class Bed, class Context, class RemIt>
     bool on_start_packing(ArrItem &itm,
                           const Bed &bed,
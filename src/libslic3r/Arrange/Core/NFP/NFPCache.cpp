@@ -0,0 +1,96 @@
+#include "NFPCache.hpp"
+
+#include <boost/functional/hash.hpp>
+
+#include "NFP.hpp"
+
+namespace Slic3r {
+
+NFPCache::Key::Key(const Polygon &fixed, const Polygon &movable)
+    : fixed_size{fixed.size()}
+{
+    points.reserve(fixed.size() + movable.size());
+    for (const Polygon *poly : {&fixed, &movable})
+        if (! poly->empty()) {
+            const Point &origin = poly->points.front();
+            for (const Point &p : poly->points)
+                points.emplace_back(p - origin);
+        }
+
+    hash = fixed_size;
+    for (const Point &p : points) {
+        boost::hash_combine(hash, p.x());
+        boost::hash_combine(hash, p.y());
+    }
+}
+
+Polygon NFPCache::nfp_convex_convex(const Polygon &fixed, const Polygon &movable)
+{
+    if (! m_enabled)
+        return nfp_convex_convex_legacy(fixed, movable);
+
+    Key key{fixed, movable};
+
+    // The cached NFP is moved to where nfp_convex_convex_legacy() places
+    // its reference vertex.
+    Vec2crd ref = reference_vertex(fixed) + reference_vertex(movable) - min_vertex(movable);
+
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        if (auto it = m_nfps.find(key); it != m_nfps.end()) {
+            ++m_hits;
+            Polygon ret = it->second;
+            ret.translate(ref);
+            return ret;
+        }
+    }
+
+    ++m_misses;
+    Polygon ret = nfp_convex_convex_legacy(fixed, movable);
+
+    Polygon cached = ret;
+    cached.translate(-reference_vertex(ret));
+    size_t npoints = key.points.size() + cached.size();
+
+    std::lock_guard<std::mutex> lk(m_mutex);
+    if (m_num_points + npoints > m_max_points) {
+        m_nfps.clear();
+        m_num_points = 0;
+    }
+
+    if (m_nfps.emplace(std::move(key), std::move(cached)).second)
+        m_num_points += npoints;
+
+    return ret;
+}
+
+void NFPCache::set_max_points(size_t max_points)
+{
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_max_points = max_points;
+    if (m_num_points > m_max_points) {
+        m_nfps.clear();
+        m_num_points = 0;
+    }
+}
+
+void NFPCache::clear()
+{
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_nfps.clear();
+    m_num_points = 0;
+}
+
+void NFPCache::reset_stats()
+{
+    m_hits   = 0;
+    m_misses = 0;
+}
+
+NFPCache &NFPCache::instance()
+{
+    static NFPCache cache;
+    return cache;
+}
+
+} // namespace Slic3r
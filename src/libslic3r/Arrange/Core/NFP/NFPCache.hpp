@@ -0,0 +1,95 @@
+#ifndef NFPCACHE_HPP
+#define NFPCACHE_HPP
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+#include <libslic3r/Polygon.hpp>
+
+namespace Slic3r {
+
+// Cache of the no-fit polygons of convex polygon pairs.
+//
+// The NFP of two convex polygons depends only on their edges, not on their
+// position. Any pair of polygons that are translated copies of an earlier pair
+// can reuse that pair's NFP. The key is the shape of both polygons after
+// rotation and inflation, so it already holds the item shape, the rotation
+// and the inflation. Arranging or filling the bed with copies of the same
+// object produces the same pairs again and again. That is why a single cache
+// is shared by all arrangement runs of the application.
+class NFPCache
+{
+public:
+    struct Stats
+    {
+        size_t hits   = 0;
+        size_t misses = 0;
+
+        double hit_rate() const
+        {
+            return hits + misses > 0 ? double(hits) / double(hits + misses) : 0.;
+        }
+    };
+
+    // The same polygon as nfp_convex_convex_legacy(fixed, movable) returns.
+    Polygon nfp_convex_convex(const Polygon &fixed, const Polygon &movable);
+
+    // The whole cache is dropped once it holds more points than this.
+    void   set_max_points(size_t max_points);
+    size_t max_points() const { return m_max_points; }
+
+    // A disabled cache computes every NFP and neither reads nor stores any.
+    void set_enabled(bool enabled) { m_enabled = enabled; }
+    bool is_enabled() const { return m_enabled; }
+
+    void  clear();
+    Stats stats() const { return {m_hits, m_misses}; }
+    void  reset_stats();
+
+    // The cache shared by the arrangement runs.
+    static NFPCache &instance();
+
+private:
+    // Both polygons relative to their first vertex, fixed first.
+    struct Key
+    {
+        Points points;
+        size_t fixed_size = 0;
+        size_t hash       = 0;
+
+        Key(const Polygon &fixed, const Polygon &movable);
+
+        bool operator==(const Key &other) const
+        {
+            return hash == other.hash && fixed_size == other.fixed_size &&
+                   points == other.points;
+        }
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key &key) const { return key.hash; }
+    };
+
+    mutable std::mutex m_mutex;
+
+    // NFPs are stored with their reference vertex in the origin.
+    std::unordered_map<Key, Polygon, KeyHash> m_nfps;
+    size_t m_num_points = 0;
+    size_t m_max_points = 4000000;
+
+    std::atomic<size_t> m_hits{0};
+    std::atomic<size_t> m_misses{0};
+    std::atomic<bool>   m_enabled{true};
+};
+
+// NFPCache::instance().nfp_convex_convex(fixed, movable)
+inline Polygon nfp_convex_convex_cached(const Polygon &fixed, const Polygon &movable)
+{
+    return NFPCache::instance().nfp_convex_convex(fixed, movable);
+}
+
+} // namespace Slic3r
+
+#endif // NFPCACHE_HPP
@@ -102,26 +102,27 @@ double pick_best_spot_on_nfp_verts_only(ArrItem            &item,
     Vec2crd orig_tr = get_translation(item);
     Vec2crd translation{0, 0};
 
-    auto eval_fitness = [&score, &strategy, &item, &translation,
-                         &orig_tr](const Vec2crd &p) {
-        set_translation(item, orig_tr);
-        Vec2crd ref_v = reference_vertex(item);
-        Vec2crd tr    = p - ref_v;
-        double fitness = KernelT::placement_fitness(strategy.kernel, item, tr);
-        if (fitness > score) {
-            score       = fitness;
-            translation = tr;
-        }
-    };
+    set_translation(item, orig_tr);
+    Vec2crd ref_v = reference_vertex(item);
 
+    std::vector<Vec2crd> candidates;
     for (const ExPolygon &expoly : nfp) {
-        for (const Point &p : expoly.contour) {
-            eval_fitness(p);
-        }
+        for (const Point &p : expoly.contour)
+            candidates.emplace_back(p - ref_v);
 
         for (const Polygon &h : expoly.holes)
             for (const Point &p : h.points)
-                eval_fitness(p);
+                candidates.emplace_back(p - ref_v);
+    }
+
+    std::vector<double> fitness;
+    KernelT::placement_fitness_batch(strategy.kernel, item, candidates, fitness);
+
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        if (fitness[i] > score) {
+            score       = fitness[i];
+            translation = candidates[i];
+        }
     }
 
     set_translation(item, orig_tr + translation);
@@ -131,6 +132,7 @@ double pick_best_spot_on_nfp_verts_only(ArrItem            &item,
 
 struct CornerResult
 {
+    size_t         path_id;
     size_t         contour_id;
     opt::Result<1> oresult;
 };
@@ -159,55 +161,114 @@ double pick_best_spot_on_nfp(ArrItem                        &item,
                                           sample_sets.emplace_back());
     }
 
-    auto nthreads = execution::max_concurrency(ex_policy);
+    // All the corners of all the paths are searched by a single parallel
+    // loop, so that there is no nesting of parallel loops.
+    struct Corner
+    {
+        size_t          path_id;
+        ContourLocation loc;
+        size_t          contour_idx; // index into contours
+    };
 
-    std::vector<CornerResult> gresults(edge_caches.size());
+    struct Contour
+    {
+        size_t path_id;
+        size_t contour_id;
+    };
+
+    std::vector<Corner>  corners;
+    std::vector<Contour> contours;
+    for (size_t path_id = 0; path_id < sample_sets.size(); ++path_id) {
+        const auto &samples = sample_sets[path_id];
+        for (size_t from = 0, to = 0; from < samples.size(); from = to) {
+            while (to < samples.size() &&
+                   samples[to].contour_id == samples[from].contour_id)
+                ++to;
+
+            contours.emplace_back(Contour{path_id, samples[from].contour_id});
+            for (size_t i = from; i < to; ++i)
+                corners.emplace_back(Corner{path_id, samples[i], contours.size() - 1});
+        }
+    }
+
+    // Score of the corners themselves, in batches
+    constexpr size_t BatchSize = 256;
+    std::vector<double> corner_fitness(corners.size());
+    execution::for_each(
+        ex_policy, size_t(0), (corners.size() + BatchSize - 1) / BatchSize,
+        [&](size_t batch_idx) {
+            size_t from = batch_idx * BatchSize;
+            size_t to   = std::min(from + BatchSize, corners.size());
+
+            auto transl = reserve_vector<Vec2crd>(to - from);
+            for (size_t i = from; i < to; ++i)
+                transl.emplace_back(
+                    edge_caches[corners[i].path_id].coords(corners[i].loc) - ref_v);
+
+            std::vector<double> fitness;
+            KernelT::placement_fitness_batch(strategy.kernel, item, transl, fitness);
+            std::copy(fitness.begin(), fitness.end(), corner_fitness.begin() + from);
+        });
+
+    double best_corner = -std::numeric_limits<double>::infinity();
+    for (double f : corner_fitness)
+        if (f > best_corner)
+            best_corner = f;
+
+    // The optimizer started at a corner searches the whole contour of the
+    // corner. It cannot beat the best corner if the kernel bounds the
+    // fitness over the bounding box of that contour below the best corner.
+    std::vector<char> contour_pruned(contours.size(), false);
+    execution::for_each(ex_policy, size_t(0), contours.size(), [&](size_t i) {
+        BoundingBox reach = edge_caches[contours[i].path_id].bounding_box(
+            ContourLocation{contours[i].contour_id, 0.}, 1.);
+        reach.translate(-ref_v);
+        reach.offset(SCALED_EPSILON);
+
+        contour_pruned[i] = KernelT::fitness_upper_bound(strategy.kernel, item, reach) < best_corner;
+    });
+
+    std::vector<CornerResult> results(corners.size());
+
+    auto cornerfn = [&](size_t i) {
+        const Corner &corner = corners[i];
+        const EdgeCache &ec_contour = edge_caches[corner.path_id];
+        ContourLocation cr = corner.loc;
+
+        results[i] = CornerResult{corner.path_id, cr.contour_id, {}};
+        results[i].oresult.score      = corner_fitness[i];
+        results[i].oresult.optimum[0] = cr.dist;
+
+        // A pruned optimizer would not change the best result, the corner
+        // with the best score is never pruned.
+        if (contour_pruned[corner.contour_idx] && corner_fitness[i] < best_corner)
+            return;
+
+        auto objfn = [&](opt::Input<1> &in) {
+            Vec2crd p = ec_contour.coords(ContourLocation{cr.contour_id, in[0]});
+            Vec2crd tr = p - ref_v;
+
+            return KernelT::placement_fitness(strategy.kernel, item, tr);
+        };
+
+        // Assuming that solver is a lightweight object
+        auto solver = strategy.solver;
+        solver.to_max();
+        results[i].oresult = solver.optimize(objfn,
+                                             opt::initvals({cr.dist}),
+                                             opt::bounds({{0., 1.}}));
+    };
+
+    execution::for_each(ex_policy, size_t(0), corners.size(), cornerfn);
 
     auto resultcmp = [](auto &a, auto &b) {
         return a.oresult.score < b.oresult.score;
     };
 
-    execution::for_each(
-        ex_policy, size_t(0), edge_caches.size(),
-        [&](size_t edge_cache_idx) {
-            auto &ec_contour = edge_caches[edge_cache_idx];
-            auto &corners = sample_sets[edge_cache_idx];
-            std::vector<CornerResult> results(corners.size());
-
-            auto cornerfn = [&](size_t i) {
-                ContourLocation cr = corners[i];
-                auto objfn = [&](opt::Input<1> &in) {
-                    Vec2crd p = ec_contour.coords(ContourLocation{cr.contour_id, in[0]});
-                    Vec2crd tr = p - ref_v;
-
-                    return KernelT::placement_fitness(strategy.kernel, item, tr);
-                };
-
-                // Assuming that solver is a lightweight object
-                auto solver = strategy.solver;
-                solver.to_max();
-                auto oresult = solver.optimize(objfn,
-                                               opt::initvals({cr.dist}),
-                                               opt::bounds({{0., 1.}}));
-
-                results[i] = CornerResult{cr.contour_id, oresult};
-            };
-
-            execution::for_each(ex_policy, size_t(0), results.size(),
-                                cornerfn, nthreads);
-
-            auto it = std::max_element(results.begin(), results.end(),
-                                       resultcmp);
-
-            if (it != results.end())
-                gresults[edge_cache_idx] = *it;
-        },
-        nthreads);
-
-    auto it = std::max_element(gresults.begin(), gresults.end(), resultcmp);
-    if (it != gresults.end()) {
+    auto it = std::max_element(results.begin(), results.end(), resultcmp);
+    if (it != results.end()) {
         score = it->oresult.score;
-        size_t path_id = std::distance(gresults.begin(), it);
+        size_t path_id = it->path_id;
         size_t contour_id = it->contour_id;
         double dist = it->oresult.optimum[0];
 
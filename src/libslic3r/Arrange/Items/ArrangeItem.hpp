@@ -15,6 +15,7 @@
 #include "libslic3r/Arrange/Core/PackingContext.hpp"
 #include "libslic3r/Arrange/Core/NFP/NFPArrangeItemTraits.hpp"
 #include "libslic3r/Arrange/Core/NFP/NFP.hpp"
+#include "libslic3r/Arrange/Core/NFP/NFPCache.hpp"
 
 #include "libslic3r/Arrange/Items/MutableItemTraits.hpp"
 
@@ -310,7 +311,7 @@ static Polygons calculate_nfp_unnormalized(const ArrangeItem    &item,
             for (size_t mi = 0; mi < item_outlines.size(); ++mi) {
                 const Polygon &movable = item_outlines[mi];
                 const Vec2crd &mref = item.envelope().reference_vertex(mi);
-                subnfp = nfp_convex_convex_legacy(fixed_poly, movable);
+                subnfp = nfp_convex_convex_cached(fixed_poly, movable);
 
                 Vec2crd min_movable = item.envelope().min_vertex(mi);
 
@@ -9,6 +9,7 @@
 
 #include "libslic3r/Arrange/Core/NFP/NFPArrangeItemTraits.hpp"
 #include "libslic3r/Arrange/Core/NFP/NFP.hpp"
+#include "libslic3r/Arrange/Core/NFP/NFPCache.hpp"
 
 #include "libslic3r/Arrange/Arrange.hpp"
 #include "libslic3r/Arrange/Tasks/ArrangeTask.hpp"
@@ -76,7 +77,7 @@ template<> struct NFPArrangeItemTraits_<SimpleArrangeItem>
         auto fixed_items = all_items_range(packing_context);
         auto nfps = reserve_polygons(fixed_items.size());
         for (const SimpleArrangeItem &fixed_part : fixed_items) {
-            Polygon subnfp = nfp_convex_convex_legacy(fixed_part.outline(),
+            Polygon subnfp = nfp_convex_convex_cached(fixed_part.outline(),
                                                       item.outline());
             nfps.emplace_back(subnfp);
 
@@ -14,6 +14,11 @@
 #include "ShortestPath.hpp"
 #include "Utils.hpp"
 
+#include <numeric>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 // #define CLIPPER_UTILS_TIMING
 
 #ifdef CLIPPER_UTILS_TIMING
@@ -804,6 +809,195 @@ Slic3r::ExPolygons union_ex(const Slic3r::ExPolygons &subject, const Slic3r::Pol
 Slic3r::ExPolygons union_ex(const Slic3r::Surfaces &subject)
     { return PolyTreeToExPolygons(clipper_do_polytree(ClipperLib::ctUnion, ClipperUtils::SurfacesProvider(subject), ClipperUtils::EmptyPathsProvider(), ClipperLib::pftNonZero)); }
 
+namespace ClipperUtils {
+    // Paths provider over paths stored elsewhere, referenced by pointers. Used to pass a single cluster of polygons to Clipper.
+    class PointsPtrsProvider {
+    public:
+        PointsPtrsProvider(const std::vector<const Points*> &paths) : m_paths(paths) {}
+
+        struct iterator : public PathsProviderIteratorBase {
+        public:
+            explicit iterator(std::vector<const Points*>::const_iterator it) : m_it(it) {}
+            const Points& operator*() const { return **m_it; }
+            bool operator==(const iterator &rhs) const { return m_it == rhs.m_it; }
+            bool operator!=(const iterator &rhs) const { return !(*this == rhs); }
+            const Points& operator++(int) { return **(m_it ++); }
+            iterator& operator++() { ++ m_it; return *this; }
+        private:
+            std::vector<const Points*>::const_iterator m_it;
+        };
+
+        iterator cbegin() const { return iterator(m_paths.begin()); }
+        iterator begin()  const { return this->cbegin(); }
+        iterator cend()   const { return iterator(m_paths.end()); }
+        iterator end()    const { return this->cend(); }
+        size_t   size()   const { return m_paths.size(); }
+
+    private:
+        const std::vector<const Points*> &m_paths;
+    };
+}
+
+namespace {
+
+// Input of the clustered boolean operations: Paths grouped by the Polygon / ExPolygon they belong to,
+// together with the bounding box of each such item.
+struct ClusteringInput {
+    std::vector<const Points*>  paths;
+    // Range of this->paths belonging to a single input item.
+    std::vector<std::pair<size_t, size_t>> items;
+    std::vector<BoundingBox>    bboxes;
+
+    void add(const Polygons &polygons) {
+        for (const Polygon &polygon : polygons)
+            if (! polygon.empty()) {
+                this->items.push_back({ this->paths.size(), this->paths.size() + 1 });
+                this->paths.push_back(&polygon.points);
+                this->bboxes.emplace_back(polygon.points);
+            }
+    }
+    void add(const ExPolygons &expolygons) {
+        for (const ExPolygon &expolygon : expolygons)
+            if (! expolygon.contour.empty()) {
+                size_t first = this->paths.size();
+                this->paths.push_back(&expolygon.contour.points);
+                for (const Polygon &hole : expolygon.holes)
+                    this->paths.push_back(&hole.points);
+                this->items.push_back({ first, this->paths.size() });
+                this->bboxes.emplace_back(expolygon.contour.points);
+            }
+    }
+};
+
+} // namespace
+
+// Assign a cluster index to each bounding box, where clusters are formed by transitively overlapping bounding boxes.
+// Bounding boxes touching at their boundaries are considered overlapping. Sweep along the X axis with union-find.
+// Returns number of clusters, clusters are numbered in the order of their first bounding box.
+static size_t cluster_overlapping_bboxes(const std::vector<BoundingBox> &bboxes, std::vector<size_t> &cluster_ids)
+{
+    std::vector<size_t> parent(bboxes.size());
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&parent](size_t i) {
+        while (parent[i] != i)
+            i = parent[i] = parent[parent[i]];
+        return i;
+    };
+
+    std::vector<size_t> order(bboxes.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&bboxes](size_t l, size_t r) { return bboxes[l].min.x() < bboxes[r].min.x(); });
+    // Bounding boxes, which may still overlap the X coordinate of the sweep line.
+    std::vector<size_t> active;
+    for (size_t i : order) {
+        const BoundingBox &bbox = bboxes[i];
+        active.erase(std::remove_if(active.begin(), active.end(), [&bboxes, &bbox](size_t j) { return bboxes[j].max.x() < bbox.min.x(); }), active.end());
+        for (size_t j : active)
+            if (bboxes[j].min.y() <= bbox.max.y() && bbox.min.y() <= bboxes[j].max.y()) {
+                size_t ri = find(i);
+                size_t rj = find(j);
+                if (ri != rj)
+                    parent[std::max(ri, rj)] = std::min(ri, rj);
+            }
+        active.emplace_back(i);
+    }
+
+    cluster_ids.assign(bboxes.size(), std::numeric_limits<size_t>::max());
+    size_t num_clusters = 0;
+    for (size_t i = 0; i < bboxes.size(); ++ i) {
+        size_t root = find(i);
+        if (cluster_ids[root] == std::numeric_limits<size_t>::max())
+            cluster_ids[root] = num_clusters ++;
+        cluster_ids[i] = cluster_ids[root];
+    }
+    return num_clusters;
+}
+
+static ExPolygons _clipper_ex_clustered(ClipperLib::ClipType clipType, ClusteringInput &&subject, ClusteringInput &&clip, ApplySafetyOffset do_safety_offset)
+{
+    const size_t num_subject_items = subject.items.size();
+    std::vector<BoundingBox> bboxes = std::move(subject.bboxes);
+    bboxes.reserve(num_subject_items + clip.items.size());
+    for (BoundingBox &bbox : clip.bboxes) {
+        if (do_safety_offset == ApplySafetyOffset::Yes)
+            // The clip polygons will be inflated by the safety offset, inflate their bounding boxes accordingly.
+            bbox.offset(coord_t(std::ceil(ClipperSafetyOffset)) + 1);
+        bboxes.emplace_back(bbox);
+    }
+
+    std::vector<size_t> cluster_ids;
+    const size_t num_clusters = cluster_overlapping_bboxes(bboxes, cluster_ids);
+
+    struct Cluster {
+        std::vector<const Points*> subject;
+        std::vector<const Points*> clip;
+    };
+    std::vector<Cluster> clusters(num_clusters);
+    auto append_item = [](std::vector<const Points*> &dst, const ClusteringInput &src, size_t idx) {
+        const std::pair<size_t, size_t> &range = src.items[idx];
+        dst.insert(dst.end(), src.paths.begin() + range.first, src.paths.begin() + range.second);
+    };
+    for (size_t i = 0; i < num_subject_items; ++ i)
+        append_item(clusters[cluster_ids[i]].subject, subject, i);
+    for (size_t i = 0; i < clip.items.size(); ++ i)
+        append_item(clusters[cluster_ids[num_subject_items + i]].clip, clip, i);
+    // Drop clusters not producing any output: Neither difference nor union produce anything without a subject,
+    // intersection requires both subject and clip. Clip polygons not touching any subject are dropped as well.
+    clusters.erase(std::remove_if(clusters.begin(), clusters.end(), [clipType](const Cluster &cluster) {
+        return cluster.subject.empty() || (clipType == ClipperLib::ctIntersection && cluster.clip.empty());
+    }), clusters.end());
+
+    auto clip_cluster = [clipType, do_safety_offset](const Cluster &cluster) {
+        return _clipper_ex(clipType, ClipperUtils::PointsPtrsProvider(cluster.subject), ClipperUtils::PointsPtrsProvider(cluster.clip),
+            cluster.clip.empty() ? ApplySafetyOffset::No : do_safety_offset);
+    };
+
+    if (clusters.size() < 2)
+        return clusters.empty() ? ExPolygons() : clip_cluster(clusters.front());
+
+    std::vector<ExPolygons> results(clusters.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, clusters.size()), [&clusters, &results, &clip_cluster](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i)
+            results[i] = clip_cluster(clusters[i]);
+    });
+
+    size_t cnt = 0;
+    for (const ExPolygons &result : results)
+        cnt += result.size();
+    ExPolygons out;
+    out.reserve(cnt);
+    for (ExPolygons &result : results)
+        append(out, std::move(result));
+    return out;
+}
+
+template<typename TSubject, typename TClip>
+static ExPolygons _clipper_ex_clustered(ClipperLib::ClipType clipType, const TSubject &subject, const TClip &clip, ApplySafetyOffset do_safety_offset)
+{
+    ClusteringInput subject_input;
+    subject_input.add(subject);
+    ClusteringInput clip_input;
+    clip_input.add(clip);
+    return _clipper_ex_clustered(clipType, std::move(subject_input), std::move(clip_input), do_safety_offset);
+}
+
+Slic3r::ExPolygons diff_ex_clustered(const Slic3r::Polygons &subject, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset)
+    { return _clipper_ex_clustered(ClipperLib::ctDifference, subject, clip, do_safety_offset); }
+Slic3r::ExPolygons diff_ex_clustered(const Slic3r::ExPolygons &subject, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset)
+    { return _clipper_ex_clustered(ClipperLib::ctDifference, subject, clip, do_safety_offset); }
+Slic3r::ExPolygons diff_ex_clustered(const Slic3r::ExPolygons &subject, const Slic3r::ExPolygons &clip, ApplySafetyOffset do_safety_offset)
+    { return _clipper_ex_clustered(ClipperLib::ctDifference, subject, clip, do_safety_offset); }
+Slic3r::ExPolygons intersection_ex_clustered(const Slic3r::Polygons &subject, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset)
+    { return _clipper_ex_clustered(ClipperLib::ctIntersection, subject, clip, do_safety_offset); }
+Slic3r::ExPolygons intersection_ex_clustered(const Slic3r::ExPolygons &subject, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset)
+    { return _clipper_ex_clustered(ClipperLib::ctIntersection, subject, clip, do_safety_offset); }
+Slic3r::ExPolygons intersection_ex_clustered(const Slic3r::ExPolygons &subject, const Slic3r::ExPolygons &clip, ApplySafetyOffset do_safety_offset)
+    { return _clipper_ex_clustered(ClipperLib::ctIntersection, subject, clip, do_safety_offset); }
+Slic3r::ExPolygons union_ex_clustered(const Slic3r::Polygons &subject)
+    { return _clipper_ex_clustered(ClipperLib::ctUnion, subject, Polygons(), ApplySafetyOffset::No); }
+Slic3r::ExPolygons union_ex_clustered(const Slic3r::ExPolygons &subject)
+    { return _clipper_ex_clustered(ClipperLib::ctUnion, subject, Polygons(), ApplySafetyOffset::No); }
+
 template<typename PathsProvider1, typename PathsProvider2>
 Polylines _clipper_pl_open(ClipperLib::ClipType clipType, PathsProvider1 &&subject, PathsProvider2 &&clip)
 {
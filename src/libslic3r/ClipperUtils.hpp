@@ -517,6 +517,21 @@ Slic3r::ExPolygons union_ex(const Slic3r::ExPolygons &subject, const Slic3r::Pol
 Slic3r::ExPolygons union_ex(const Slic3r::Polygons &subject, const Slic3r::ExPolygons &subject2);
 Slic3r::ExPolygons union_ex(const Slic3r::Surfaces &subject);
 
+// Variants of diff_ex(), intersection_ex() and union_ex() for layers with many small islands.
+// The input polygons are grouped into clusters of transitively overlapping bounding boxes, thus polygons with disjoint
+// bounding boxes are never passed to the same Clipper call. Clusters, which cannot produce any output (clip polygons
+// not touching any subject for diff and union, clusters missing either subject or clip for intersection) are skipped
+// and the remaining clusters are clipped in parallel.
+// The output covers the same area as the output of the non-clustered variants, only the order of the ExPolygons may differ.
+Slic3r::ExPolygons diff_ex_clustered(const Slic3r::Polygons &subject, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+Slic3r::ExPolygons diff_ex_clustered(const Slic3r::ExPolygons &subject, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+Slic3r::ExPolygons diff_ex_clustered(const Slic3r::ExPolygons &subject, const Slic3r::ExPolygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+Slic3r::ExPolygons intersection_ex_clustered(const Slic3r::Polygons &subject, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+Slic3r::ExPolygons intersection_ex_clustered(const Slic3r::ExPolygons &subject, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+Slic3r::ExPolygons intersection_ex_clustered(const Slic3r::ExPolygons &subject, const Slic3r::ExPolygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+Slic3r::ExPolygons union_ex_clustered(const Slic3r::Polygons &subject);
+Slic3r::ExPolygons union_ex_clustered(const Slic3r::ExPolygons &subject);
+
 // Convert polygons / expolygons into ClipperLib::PolyTree using ClipperLib::pftEvenOdd, thus union will NOT be performed.
 // If the contours are not intersecting, their orientation shall not be modified by union_pt().
 ClipperLib::PolyTree union_pt(const Slic3r::Polygons &subject);
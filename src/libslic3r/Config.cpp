@@ -1152,7 +1152,7 @@ void ConfigBase::null_nullables()
 DynamicConfig::DynamicConfig(const ConfigBase& rhs, const t_config_option_keys& keys)
 {
 	for (const t_config_option_key& opt_key : keys)
-		this->options[opt_key] = std::unique_ptr<ConfigOption>(rhs.option(opt_key)->clone());
+		this->options[opt_key] = OptionValue(rhs.option(opt_key)->clone());
 }
 
 bool DynamicConfig::operator==(const DynamicConfig &rhs) const
@@ -1162,7 +1162,7 @@ bool DynamicConfig::operator==(const DynamicConfig &rhs) const
     auto it2     = rhs.options.begin();
     auto it2_end = rhs.options.end();
     for (; it1 != it1_end && it2 != it2_end; ++ it1, ++ it2)
-		if (it1->first != it2->first || *it1->second != *it2->second)
+		if (it1->first != it2->first || it1->second != it2->second)
 			// key or value differ
 			return false;
     return it1 == it1_end && it2 == it2_end;
@@ -1185,8 +1185,8 @@ ConfigOption* DynamicConfig::optptr(const t_config_option_key &opt_key, bool cre
 {
     auto it = options.find(opt_key);
     if (it != options.end())
-        // Option was found.
-        return it->second.get();
+        // Option was found. Clone it if it is shared with another DynamicConfig, as the caller may modify it.
+        return it->second.get_mutable();
     if (! create)
         // Option was not found and a new option shall not be created.
         return nullptr;
@@ -1200,7 +1200,7 @@ ConfigOption* DynamicConfig::optptr(const t_config_option_key &opt_key, bool cre
         // Let the parent decide what to do if the opt_key is not defined by this->def().
         return nullptr;
     ConfigOption *opt = optdef->create_default_option();
-    this->options.emplace_hint(it, opt_key, std::unique_ptr<ConfigOption>(opt));
+    this->options.emplace_hint(it, opt_key, OptionValue(opt, true));
     return opt;
 }
 
@@ -1369,8 +1369,8 @@ t_config_option_keys StaticConfig::keys() const
 template<typename Fn>
 static inline bool dynamic_config_iterate(const DynamicConfig &lhs, const DynamicConfig &rhs, Fn fn)
 {
-    std::map<t_config_option_key, std::unique_ptr<ConfigOption>>::const_iterator i = lhs.cbegin();
-    std::map<t_config_option_key, std::unique_ptr<ConfigOption>>::const_iterator j = rhs.cbegin();
+    DynamicConfig::OptionValues::const_iterator i = lhs.cbegin();
+    DynamicConfig::OptionValues::const_iterator j = rhs.cbegin();
     while (i != lhs.cend() && j != rhs.cend())
         if (i->first < j->first)
             ++ i;
@@ -1392,7 +1392,7 @@ static inline bool dynamic_config_iterate(const DynamicConfig &lhs, const Dynami
 bool DynamicConfig::equals(const DynamicConfig &other) const
 { 
     return ! dynamic_config_iterate(*this, other, 
-        [](const t_config_option_key & /* key */, const ConfigOption *l, const ConfigOption *r) { return *l != *r; });
+        [](const t_config_option_key & /* key */, const ConfigOption *l, const ConfigOption *r) { return l != r && *l != *r; });
 }
 
 // Returns options differing in the two configs, ignoring options not present in both configs.
@@ -1401,7 +1401,8 @@ t_config_option_keys DynamicConfig::diff(const DynamicConfig &other) const
     t_config_option_keys diff;
     dynamic_config_iterate(*this, other, 
         [&diff](const t_config_option_key &key, const ConfigOption *l, const ConfigOption *r) {
-            if (*l != *r)
+            // Values shared by the two configs are equal.
+            if (l != r && *l != *r)
                 diff.emplace_back(key);
             // Continue iterating.
             return false; 
@@ -1415,7 +1416,7 @@ t_config_option_keys DynamicConfig::equal(const DynamicConfig &other) const
     t_config_option_keys equal;
     dynamic_config_iterate(*this, other, 
         [&equal](const t_config_option_key &key, const ConfigOption *l, const ConfigOption *r) {
-            if (*l == *r)
+            if (l == r || *l == *r)
                 equal.emplace_back(key);
             // Continue iterating.
             return false;
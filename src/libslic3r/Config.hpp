@@ -29,6 +29,7 @@
 #include <cstdlib>
 #include <functional>
 #include <iostream>
+#include <memory>
 #include <stdexcept>
 #include <string>
 #include <string_view>
@@ -2351,9 +2352,47 @@ private:
 
 // Configuration store with dynamic number of configuration values.
 // In Slic3r, the dynamic config is mostly used at the user interface layer.
+// The option values are shared by the copies of a DynamicConfig and cloned once a mutable reference
+// to a shared value is requested (copy-on-write), thus copying a DynamicConfig does not clone the values
+// and comparing a config with its copy does not compare the values.
 class DynamicConfig : public virtual ConfigBase
 {
 public:
+    // Option value stored by DynamicConfig, possibly shared with copies of the DynamicConfig.
+    class OptionValue {
+    public:
+        OptionValue() = default;
+        explicit OptionValue(ConfigOption *opt, bool exposed = false) : m_option(opt), m_exposed(exposed) {}
+
+        const ConfigOption*     get() const         { return m_option.get(); }
+        const ConfigOption*     operator->() const  { return m_option.get(); }
+        const ConfigOption&     operator*() const   { return *m_option; }
+        // Values shared by two configs are equal without comparing them.
+        bool                    operator==(const OptionValue &rhs) const { return m_option == rhs.m_option || *m_option == *rhs.m_option; }
+        bool                    operator!=(const OptionValue &rhs) const { return ! (*this == rhs); }
+
+    private:
+        // Value to be stored into a copy of the DynamicConfig holding this value.
+        // An exposed value is cloned, as it may be modified through the mutable pointer handed out before.
+        OptionValue             copy() const        { return m_exposed ? OptionValue(m_option->clone()) : *this; }
+        // Mutable value, cloned first if it is shared with another config.
+        ConfigOption*           get_mutable() {
+            if (m_option.use_count() > 1)
+                m_option.reset(m_option->clone());
+            m_exposed = true;
+            return m_option.get();
+        }
+
+        std::shared_ptr<ConfigOption>   m_option;
+        // A mutable pointer to m_option was handed out, which may still be in use.
+        bool                            m_exposed { false };
+
+        friend class DynamicConfig;
+        friend class cereal::access;
+        template<class Archive> void serialize(Archive &ar) { ar(m_option); }
+    };
+    using OptionValues = std::map<t_config_option_key, OptionValue>;
+
     DynamicConfig() = default;
     DynamicConfig(const DynamicConfig &rhs) { *this = rhs; }
     DynamicConfig(DynamicConfig &&rhs) noexcept : options(std::move(rhs.options)) { rhs.options.clear(); }
@@ -2366,9 +2405,12 @@ public:
     DynamicConfig& operator=(const DynamicConfig &rhs) 
     {
         assert(this->def() == nullptr || this->def() == rhs.def());
+        if (this == &rhs)
+            return *this;
         this->clear();
+        // rhs.options are sorted, insert them at the end.
         for (const auto &kvp : rhs.options)
-            this->options[kvp.first].reset(kvp.second->clone());
+            this->options.emplace_hint(this->options.end(), kvp.first, kvp.second.copy());
         return *this;
     }
 
@@ -2391,13 +2433,14 @@ public:
         for (const auto &kvp : rhs.options) {
             auto it = this->options.find(kvp.first);
             if (it == this->options.end())
-                this->options[kvp.first].reset(kvp.second->clone());
+                this->options.emplace_hint(it, kvp.first, kvp.second.copy());
             else {
                 assert(it->second->type() == kvp.second->type());
-                if (it->second->type() == kvp.second->type())
-                    *it->second = *kvp.second;
+                if (it->second.m_exposed && it->second->type() == kvp.second->type())
+                    // The value may be referenced through a mutable pointer, modify it in place.
+                    *it->second.get_mutable() = *kvp.second;
                 else
-                    it->second.reset(kvp.second->clone());
+                    it->second = kvp.second.copy();
             }
         }
         return *this;
@@ -2452,6 +2495,7 @@ public:
     // Overrides ConfigResolver::optptr().
     const ConfigOption*     optptr(const t_config_option_key &opt_key) const override;
     // Overrides ConfigBase::optptr(). Find ando/or create a ConfigOption instance for a given name.
+    // A value shared with another DynamicConfig is cloned first.
     ConfigOption*           optptr(const t_config_option_key &opt_key, bool create = false) override;
     // Overrides ConfigBase::keys(). Collect names of all configuration values maintained by this configuration store.
     t_config_option_keys    keys() const override;
@@ -2462,12 +2506,13 @@ public:
     // Be careful, as this method does not test the existence of opt_key in this->def().
     bool                    set_key_value(const std::string &opt_key, ConfigOption *opt)
     {
+        // The caller may keep the pointer to modify the value, thus the value is exposed.
         auto it = this->options.find(opt_key);
         if (it == this->options.end()) {
-            this->options[opt_key].reset(opt);
+            this->options.emplace_hint(it, opt_key, OptionValue(opt, true));
             return true;
         } else {
-            it->second.reset(opt);
+            it->second = OptionValue(opt, true);
             return false;
         }
     }
@@ -2482,12 +2527,12 @@ public:
     // Command line processing
     bool                read_cli(int argc, const char* const argv[], t_config_option_keys* extra, t_config_option_keys* keys = nullptr);
 
-    std::map<t_config_option_key, std::unique_ptr<ConfigOption>>::const_iterator cbegin() const { return options.cbegin(); }
-    std::map<t_config_option_key, std::unique_ptr<ConfigOption>>::const_iterator cend()   const { return options.cend(); }
-    size_t                        												 size()   const { return options.size(); }
+    OptionValues::const_iterator cbegin() const { return options.cbegin(); }
+    OptionValues::const_iterator cend()   const { return options.cend(); }
+    size_t                       size()   const { return options.size(); }
 
 private:
-    std::map<t_config_option_key, std::unique_ptr<ConfigOption>> options;
+    OptionValues options;
 
 	friend class cereal::access;
 	template<class Archive> void serialize(Archive &ar) { ar(options); }
@@ -233,7 +233,8 @@ std::vector<SurfaceFill> group_fills(const Layer &layer)
 					Polygons polys = to_polygons(std::move(fill.expolygons));
 		            // Make a union of polygons, use a safety offset, subtract the preceding polygons.
 				    // Bridges are processed first (see SurfaceFill::operator<())
-		            fill.expolygons = all_polygons.empty() ? union_safety_offset_ex(polys) : diff_ex(polys, all_polygons, ApplySafetyOffset::Yes);
+				    // The preceding polygons cover all islands of the layer, clip each island separately by the polygons touching it.
+		            fill.expolygons = all_polygons.empty() ? union_safety_offset_ex(polys) : diff_ex_clustered(polys, all_polygons, ApplySafetyOffset::Yes);
 					append(all_polygons, std::move(polys));
 				} else if (&fill != &surface_fills.back())
 					append(all_polygons, to_polygons(fill.expolygons));
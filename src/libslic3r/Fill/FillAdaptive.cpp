@@ -20,9 +20,8 @@
 #include <algorithm>
 #include <numeric>
 
-// Boost pool: Don't use mutexes to synchronize memory allocation.
-#define BOOST_POOL_NO_MT
-#include <boost/pool/object_pool.hpp>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
 
 #include <boost/geometry.hpp>
 #include <boost/geometry/geometries/point.hpp>
@@ -239,14 +238,25 @@ static constexpr std::array<std::array<int, 8>, 3> child_traversal_order {
     std::array<int, 8>{ 1, 5, 0, 4, 3, 7, 2, 6 },
 };
 
-struct Cube
+static inline int popcount8(uint8_t v)
 {
-    Vec3d center;
-#ifndef NDEBUG
-    Vec3d center_octree;
-#endif // NDEBUG
-    std::array<Cube*, 8> children {}; // initialized to nullptrs
-    Cube(const Vec3d &center) : center(center) {}
+    v = v - ((v >> 1) & 0x55);
+    v = (v & 0x33) + ((v >> 2) & 0x33);
+    return (v + (v >> 4)) & 0x0F;
+}
+
+// Node of a linearized octree. Children of a node are stored next to each other in the order of their child index,
+// which is the Morton order of the child cubes. The complete subtree of a node occupies a contiguous block of Octree::nodes.
+// Centers of the cubes are not stored, they are accumulated from the center of the root cube when traversing the tree.
+struct OctreeNode
+{
+    // Index of the first child in Octree::nodes.
+    uint32_t first_child   { 0 };
+    // Bit i is set if the i-th child exists.
+    uint8_t  children_mask { 0 };
+
+    bool     has_child(int i) const { return (children_mask >> i) & 1; }
+    uint32_t child(int i) const { return first_child + uint32_t(popcount8(uint8_t(children_mask & ((1u << i) - 1)))); }
 };
 
 struct CubeProperties
@@ -260,23 +270,25 @@ struct CubeProperties
 
 struct Octree
 {
-    // Octree will allocate its Cubes from the pool. The pool only supports deletion of the complete pool,
-    // perfect for building up our octree.
-    boost::object_pool<Cube>    pool;
-    Cube*                       root_cube { nullptr };
-    Vec3d                       origin;
-    std::vector<CubeProperties> cubes_properties;
-
-    Octree(const Vec3d &origin, const std::vector<CubeProperties> &cubes_properties)
-        : root_cube(pool.construct(origin)), origin(origin), cubes_properties(cubes_properties) {}
-
-    void insert_triangle(const Vec3d &a, const Vec3d &b, const Vec3d &c, Cube *current_cube, const BoundingBoxf3 &current_bbox, int depth);
+    // Linearized tree, the root cube is stored at index 0.
+    std::vector<OctreeNode>             nodes;
+    // Center of the root cube.
+    Vec3d                               origin;
+    std::vector<CubeProperties>         cubes_properties;
+    // Offsets of the centers of the child cubes from the center of their parent cube, indexed by the depth of the child.
+    std::vector<std::array<Vec3d, 8>>   child_offsets;
 };
 
 void OctreeDeleter::operator()(Octree *p) {
     delete p;
 }
 
+OctreeStats octree_stats(const Octree &octree)
+{
+    return { octree.nodes.size(), sizeof(Octree) + octree.nodes.capacity() * sizeof(OctreeNode) +
+        octree.cubes_properties.capacity() * sizeof(CubeProperties) + octree.child_offsets.capacity() * sizeof(std::array<Vec3d, 8>) };
+}
+
 std::pair<double, double> adaptive_fill_line_spacing(const PrintObject &print_object)
 {
     // Output, spacing for icAdaptiveCubic and icSupportCubic
@@ -372,6 +384,8 @@ struct FillContext
     };
 
     FillContext(const Octree &octree, double z_position, int direction_idx) :
+        nodes(octree.nodes),
+        child_offsets(octree.child_offsets),
         cubes_properties(octree.cubes_properties),
         z_position(z_position),
         traversal_order(child_traversal_order[direction_idx]),
@@ -385,7 +399,9 @@ struct FillContext
     // Rotate the point, uses the same convention as Point::rotate().
     Vec2d rotate(const Vec2d& v) { return Vec2d(this->cos_a * v.x() - this->sin_a * v.y(), this->sin_a * v.x() + this->cos_a * v.y()); }
 
-    const std::vector<CubeProperties>  &cubes_properties;
+    const std::vector<OctreeNode>           &nodes;
+    const std::vector<std::array<Vec3d, 8>> &child_offsets;
+    const std::vector<CubeProperties>       &cubes_properties;
     // Top of the current layer.
     const double                        z_position;
     // Order of traversal for this line direction.
@@ -418,17 +434,18 @@ Eigen::Quaterniond transform_to_octree()
 // therefore the infill line may get extended with O(1) time & space complexity.
 static bool verify_traversal_order(
     FillContext  &context,
-    const Cube   *cube,
+    const Vec3d  &center,
     int           depth,
     const Vec2d  &line_from,
     const Vec2d  &line_to)
 {
     std::array<Vec3d, 8> c;
     Eigen::Quaterniond to_world = transform_to_world();
+    Vec3d center_octree = transform_to_octree() * center;
     for (int i = 0; i < 8; ++i) {
         int j = context.traversal_order[i];
-        Vec3d cntr = to_world * (cube->center_octree + (child_centers[j] * (context.cubes_properties[depth].edge_length / 4.)));
-        assert(!cube->children[j] || cube->children[j]->center.isApprox(cntr));
+        Vec3d cntr = to_world * (center_octree + (child_centers[j] * (context.cubes_properties[depth].edge_length / 4.)));
+        assert(depth == 0 || (center + context.child_offsets[depth - 1][j]).isApprox(cntr));
         c[i] = cntr;
     }
     std::array<Vec3d, 10> dirs = {
@@ -452,15 +469,17 @@ static bool verify_traversal_order(
 
 static void generate_infill_lines_recursive(
     FillContext     &context,
-    const Cube      *cube,
+    uint32_t         node_idx,
+    // Center of the cube in world coordinates.
+    const Vec3d     &center,
     // Address of this wall in the octree,  used to address context.temp_lines.
     int              address,
     int              depth)
 {
-    assert(cube != nullptr);
+    assert(node_idx < context.nodes.size());
 
     const std::vector<CubeProperties> &cubes_properties = context.cubes_properties;
-    const double z_diff     = context.z_position - cube->center.z();
+    const double z_diff     = context.z_position - center.z();
     const double z_diff_abs = std::abs(z_diff);
 
     if (z_diff_abs > cubes_properties[depth].height / 2.)
@@ -476,12 +495,12 @@ static void generate_infill_lines_recursive(
         from = context.rotate(from);
         to   = context.rotate(to);
         // Relative to cube center
-        const Vec2d offset(cube->center.x(), cube->center.y());
+        const Vec2d offset(center.x(), center.y());
         from += offset;
         to   += offset;
         // Verify that the traversal order of the octree children matches the line direction,
         // therefore the infill line may get extended with O(1) time & space complexity.
-        assert(verify_traversal_order(context, cube, depth, from, to));
+        assert(verify_traversal_order(context, center, depth, from, to));
         // Either extend an existing line or start a new one.
         Line &last_line = context.temp_lines[address];
         Line  new_line(Point::new_scale(from), Point::new_scale(to));
@@ -494,14 +513,18 @@ static void generate_infill_lines_recursive(
         last_line.b = new_line.b;
     }
 
+    const OctreeNode &node = context.nodes[node_idx];
+    if (node.children_mask == 0)
+        return;
+
     // left child index
     address = address * 2 + 1;
     -- depth;
+    const std::array<Vec3d, 8> &child_offsets = context.child_offsets[depth];
     size_t i = 0;
     for (const int child_idx : context.traversal_order) {
-        const Cube *child = cube->children[child_idx];
-        if (child != nullptr)
-            generate_infill_lines_recursive(context, child, address, depth);
+        if (node.has_child(child_idx))
+            generate_infill_lines_recursive(context, node.child(child_idx), center + child_offsets[child_idx], address, depth);
         if (++ i == 4)
             // right child index
             ++ address;
@@ -1341,7 +1364,7 @@ void Filler::_fill_surface_single(
         // Generate the infill lines along the octree cells, merge touching lines of the same direction.
         size_t num_lines = 0;
         for (auto &context : contexts) {
-            generate_infill_lines_recursive(context, adapt_fill_octree->root_cube, 0, int(adapt_fill_octree->cubes_properties.size()) - 1);
+            generate_infill_lines_recursive(context, 0, adapt_fill_octree->origin, 0, int(adapt_fill_octree->cubes_properties.size()) - 1);
             num_lines += context.output_lines.size() + context.temp_lines.size();
         }
 
@@ -1455,15 +1478,129 @@ static inline bool is_overhang_triangle(const Vec3d &a, const Vec3d &b, const Ve
     return n.dot(up) > 0.707 * n.norm();
 }
 
-static void transform_center(Cube *current_cube, const Eigen::Matrix3d &rot)
+// Octree node used during construction of the octree, children are addressed by their index into a vector of nodes.
+// Index zero is reserved for the root, thus it marks a missing child.
+struct OctreeBuildNode
 {
-#ifndef NDEBUG
-    current_cube->center_octree = current_cube->center;
-#endif // NDEBUG
-    current_cube->center = rot * current_cube->center;
-    for (auto *child : current_cube->children)
-        if (child)
-            transform_center(child, rot);
+    std::array<uint32_t, 8> children {};
+};
+
+// Builds a subtree of the octree by inserting triangles one by one.
+struct OctreeBuilder
+{
+    const std::vector<CubeProperties>  &cubes_properties;
+    std::vector<OctreeBuildNode>        nodes { OctreeBuildNode{} };
+
+    void insert_triangle(const Vec3d &a, const Vec3d &b, const Vec3d &c, uint32_t node_idx, const Vec3d &center, const BoundingBoxf3 &current_bbox, int depth);
+};
+
+// Calculate a slightly expanded bounding box of a child cube to cope with triangles touching a cube wall and other numeric errors.
+// We will rather densify the octree a bit more than necessary instead of missing a triangle.
+static inline BoundingBoxf3 child_bbox(const BoundingBoxf3 &current_bbox, const Vec3d &center, int child_idx)
+{
+    const Vec3d &child_center_dir = child_centers[child_idx];
+    BoundingBoxf3 bbox;
+    for (int k = 0; k < 3; ++ k) {
+        if (child_center_dir[k] == -1.) {
+            bbox.min[k] = current_bbox.min[k];
+            bbox.max[k] = center[k] + EPSILON;
+        } else {
+            bbox.min[k] = center[k] - EPSILON;
+            bbox.max[k] = current_bbox.max[k];
+        }
+    }
+    return bbox;
+}
+
+void OctreeBuilder::insert_triangle(const Vec3d &a, const Vec3d &b, const Vec3d &c, uint32_t node_idx, const Vec3d &center, const BoundingBoxf3 &current_bbox, int depth)
+{
+    assert(depth > 0);
+
+    --depth;
+
+    for (int i = 0; i < 8; ++ i) {
+        BoundingBoxf3 bbox = child_bbox(current_bbox, center, i);
+        if (triangle_AABB_intersects(a, b, c, bbox)) {
+            uint32_t child_idx = this->nodes[node_idx].children[i];
+            if (child_idx == 0) {
+                child_idx = uint32_t(this->nodes.size());
+                this->nodes[node_idx].children[i] = child_idx;
+                this->nodes.emplace_back();
+            }
+            if (depth > 0)
+                this->insert_triangle(a, b, c, child_idx, center + (child_centers[i] * (this->cubes_properties[depth].edge_length / 2.)), bbox, depth);
+        }
+    }
+}
+
+// Copy a linearized subtree into out, its root is stored into out[out_idx], the other nodes are appended to the end of out.
+static void splice_octree(const std::vector<OctreeNode> &subtree, std::vector<OctreeNode> &out, size_t out_idx)
+{
+    assert(! subtree.empty());
+    // Nodes of the subtree except for its root are shifted from index 1 to index out.size().
+    const uint32_t shift = uint32_t(out.size()) - 1;
+    out[out_idx] = subtree.front();
+    if (out[out_idx].children_mask != 0)
+        out[out_idx].first_child += shift;
+    for (auto it = subtree.begin() + 1; it != subtree.end(); ++ it) {
+        out.emplace_back(*it);
+        if (it->children_mask != 0)
+            out.back().first_child += shift;
+    }
+}
+
+// Store a node of the build tree with its subtree into out[out_idx], children are appended to the end of out.
+// If subtree_of_node() returns a subtree for a build node, the already linearized subtree is spliced in place of the build node.
+template<typename SubtreeOfNode>
+static void linearize_octree(const std::vector<OctreeBuildNode> &build_nodes, uint32_t build_node_idx, std::vector<OctreeNode> &out, size_t out_idx, const SubtreeOfNode &subtree_of_node)
+{
+    if (const std::vector<OctreeNode> *subtree = subtree_of_node(build_node_idx); subtree != nullptr) {
+        splice_octree(*subtree, out, out_idx);
+        return;
+    }
+    const OctreeBuildNode &build_node = build_nodes[build_node_idx];
+    uint8_t mask = 0;
+    for (int i = 0; i < 8; ++ i)
+        if (build_node.children[i] != 0)
+            mask |= uint8_t(1 << i);
+    out[out_idx].children_mask = mask;
+    if (mask != 0) {
+        size_t first_child = out.size();
+        out[out_idx].first_child = uint32_t(first_child);
+        out.resize(first_child + popcount8(mask));
+        for (int i = 0; i < 8; ++ i)
+            if (build_node.children[i] != 0)
+                linearize_octree(build_nodes, build_node.children[i], out, first_child ++, subtree_of_node);
+    }
+}
+
+static void linearize_octree(const std::vector<OctreeBuildNode> &build_nodes, std::vector<OctreeNode> &out)
+{
+    out.assign(1, OctreeNode{});
+    out.reserve(build_nodes.size());
+    linearize_octree(build_nodes, 0, out, 0, [](uint32_t) -> const std::vector<OctreeNode>* { return nullptr; });
+}
+
+// Cubes at this depth below the root cube are built in parallel as independent subtrees.
+static constexpr const int octree_split_level = 3;
+
+// Collect cubes at split_level below the root cube intersected by a triangle. The cube is identified by the child indices
+// along the path from the root cube, three bits per level.
+static void collect_split_cubes(
+    const Vec3d &a, const Vec3d &b, const Vec3d &c, const std::vector<CubeProperties> &cubes_properties,
+    const Vec3d &center, const BoundingBoxf3 &current_bbox, int depth, int level, int split_level, uint32_t path, std::vector<uint32_t> &out)
+{
+    if (level == split_level) {
+        out.emplace_back(path);
+        return;
+    }
+    --depth;
+    for (int i = 0; i < 8; ++ i) {
+        BoundingBoxf3 bbox = child_bbox(current_bbox, center, i);
+        if (triangle_AABB_intersects(a, b, c, bbox))
+            collect_split_cubes(a, b, c, cubes_properties, center + (child_centers[i] * (cubes_properties[depth].edge_length / 2.)), bbox,
+                depth, level + 1, split_level, (path << 3) | uint32_t(i), out);
+    }
 }
 
 OctreePtr build_octree(
@@ -1480,77 +1617,131 @@ OctreePtr build_octree(
 
     BoundingBox3Base<Vec3f>     bbox(triangle_mesh.vertices);
     Vec3d                       cube_center      = bbox.center().cast<double>();
-    std::vector<CubeProperties> cubes_properties = make_cubes_properties(double(bbox.size().maxCoeff()), line_spacing);
-    auto                        octree           = OctreePtr(new Octree(cube_center, cubes_properties));
+    auto                        octree           = OctreePtr(new Octree());
+    octree->origin           = cube_center;
+    octree->cubes_properties = make_cubes_properties(double(bbox.size().maxCoeff()), line_spacing);
+    octree->nodes.emplace_back();
 
+    const std::vector<CubeProperties> &cubes_properties = octree->cubes_properties;
     if (cubes_properties.size() > 1) {
-        Octree *octree_ptr = octree.get();
-        double edge_length_half = 0.5 * cubes_properties.back().edge_length;
-        Vec3d  diag_half(edge_length_half, edge_length_half, edge_length_half);
-        int    max_depth = int(cubes_properties.size()) - 1;
-        auto process_triangle = [octree_ptr, max_depth, diag_half](const Vec3d &a, const Vec3d &b, const Vec3d &c) {
-            octree_ptr->insert_triangle(
-                a, b, c,
-                octree_ptr->root_cube,
-                BoundingBoxf3(octree_ptr->root_cube->center - diag_half, octree_ptr->root_cube->center + diag_half),
-                max_depth);
+        const double edge_length_half = 0.5 * cubes_properties.back().edge_length;
+        const Vec3d  diag_half(edge_length_half, edge_length_half, edge_length_half);
+        const BoundingBoxf3 root_bbox(cube_center - diag_half, cube_center + diag_half);
+        const int    max_depth   = int(cubes_properties.size()) - 1;
+        const int    split_level = std::min(max_depth, octree_split_level);
+        const auto   up_vector   = support_overhangs_only ? Vec3d(transform_to_octree() * Vec3d(0., 0., 1.)) : Vec3d();
+
+        // Triangles of the mesh are followed by the overhang triangles.
+        const size_t num_mesh_triangles = triangle_mesh.indices.size();
+        const size_t num_triangles      = num_mesh_triangles + overhang_triangles.size() / 3;
+        auto triangle = [&triangle_mesh, &overhang_triangles, num_mesh_triangles](size_t idx) -> std::array<Vec3d, 3> {
+            if (idx < num_mesh_triangles) {
+                const stl_triangle_vertex_indices &tri = triangle_mesh.indices[idx];
+                return { triangle_mesh.vertices[tri[0]].cast<double>(), triangle_mesh.vertices[tri[1]].cast<double>(), triangle_mesh.vertices[tri[2]].cast<double>() };
+            }
+            idx = (idx - num_mesh_triangles) * 3;
+            return { overhang_triangles[idx], overhang_triangles[idx + 1], overhang_triangles[idx + 2] };
         };
-        auto up_vector = support_overhangs_only ? Vec3d(transform_to_octree() * Vec3d(0., 0., 1.)) : Vec3d();
-        for (auto &tri : triangle_mesh.indices) {
-            auto a = triangle_mesh.vertices[tri[0]].cast<double>();
-            auto b = triangle_mesh.vertices[tri[1]].cast<double>();
-            auto c = triangle_mesh.vertices[tri[2]].cast<double>();
-            if (! support_overhangs_only || is_overhang_triangle(a, b, c, up_vector))
-                process_triangle(a, b, c);
+
+        // 1) Bin the triangles into the cubes at split_level, which they intersect.
+        tbb::enumerable_thread_specific<std::vector<std::pair<uint32_t, uint32_t>>> cube_triangles_tls;
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, num_triangles), [&](const tbb::blocked_range<size_t> &range) {
+            std::vector<std::pair<uint32_t, uint32_t>> &cube_triangles = cube_triangles_tls.local();
+            std::vector<uint32_t> cubes;
+            for (size_t idx = range.begin(); idx < range.end(); ++ idx) {
+                auto [a, b, c] = triangle(idx);
+                if (support_overhangs_only && idx < num_mesh_triangles && ! is_overhang_triangle(a, b, c, up_vector))
+                    continue;
+                cubes.clear();
+                collect_split_cubes(a, b, c, cubes_properties, cube_center, root_bbox, max_depth, 0, split_level, 0, cubes);
+                for (uint32_t cube : cubes)
+                    cube_triangles.emplace_back(cube, uint32_t(idx));
+            }
+        });
+        std::vector<std::pair<uint32_t, uint32_t>> cube_triangles;
+        for (std::vector<std::pair<uint32_t, uint32_t>> &v : cube_triangles_tls)
+            append(cube_triangles, std::move(v));
+        std::sort(cube_triangles.begin(), cube_triangles.end());
+
+        // Ranges of cube_triangles belonging to a single cube at split_level.
+        std::vector<std::pair<size_t, size_t>> cube_ranges;
+        for (size_t i = 0; i < cube_triangles.size();) {
+            size_t j = i;
+            for (; j < cube_triangles.size() && cube_triangles[j].first == cube_triangles[i].first; ++ j) ;
+            cube_ranges.emplace_back(i, j);
+            i = j;
         }
-        for (size_t i = 0; i < overhang_triangles.size(); i += 3)
-            process_triangle(overhang_triangles[i], overhang_triangles[i + 1], overhang_triangles[i + 2]);
+
+        // 2) Build the subtrees of the cubes at split_level in parallel, linearize each subtree into a block of nodes.
+        std::vector<std::vector<OctreeNode>> subtrees(cube_ranges.size());
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, cube_ranges.size()), [&](const tbb::blocked_range<size_t> &range) {
+            for (size_t cube_idx = range.begin(); cube_idx < range.end(); ++ cube_idx) {
+                const auto [begin, end] = cube_ranges[cube_idx];
+                // Replay the path to the cube to calculate its center and bounding box exactly the same way as when binning the triangles.
+                const uint32_t path   = cube_triangles[begin].first;
+                Vec3d          center = cube_center;
+                BoundingBoxf3  bbox   = root_bbox;
+                int            depth  = max_depth;
+                for (int level = split_level - 1; level >= 0; -- level) {
+                    const int i = int(path >> (3 * level)) & 7;
+                    bbox    = child_bbox(bbox, center, i);
+                    center += child_centers[i] * (cubes_properties[-- depth].edge_length / 2.);
+                }
+                OctreeBuilder builder{ cubes_properties };
+                if (depth > 0)
+                    for (size_t i = begin; i < end; ++ i) {
+                        auto [a, b, c] = triangle(cube_triangles[i].second);
+                        builder.insert_triangle(a, b, c, 0, center, bbox, depth);
+                    }
+                linearize_octree(builder.nodes, subtrees[cube_idx]);
+            }
+        });
+        std::vector<uint32_t> cube_paths;
+        cube_paths.reserve(cube_ranges.size());
+        for (const std::pair<size_t, size_t> &range : cube_ranges)
+            cube_paths.emplace_back(cube_triangles[range.first].first);
+        cube_triangles = {};
+
+        // 3) Build the top levels of the octree down to split_level, then splice the subtrees into it.
+        OctreeBuilder    top { cubes_properties };
+        // Index of a subtree for the nodes of the top tree at split_level, -1 for the other nodes.
+        std::vector<int> top_node_subtree;
+        size_t           num_nodes = 0;
+        for (size_t cube_idx = 0; cube_idx < cube_paths.size(); ++ cube_idx) {
+            uint32_t node_idx = 0;
+            for (int level = split_level - 1; level >= 0; -- level) {
+                const int i         = int(cube_paths[cube_idx] >> (3 * level)) & 7;
+                uint32_t  child_idx = top.nodes[node_idx].children[i];
+                if (child_idx == 0) {
+                    child_idx = uint32_t(top.nodes.size());
+                    top.nodes[node_idx].children[i] = child_idx;
+                    top.nodes.emplace_back();
+                }
+                node_idx = child_idx;
+            }
+            top_node_subtree.resize(top.nodes.size(), -1);
+            top_node_subtree[node_idx] = int(cube_idx);
+            num_nodes += subtrees[cube_idx].size() - 1;
+        }
+        top_node_subtree.resize(top.nodes.size(), -1);
+        octree->nodes.reserve(num_nodes + top.nodes.size());
+        linearize_octree(top.nodes, 0, octree->nodes, 0, [&top_node_subtree, &subtrees](uint32_t build_node_idx) -> const std::vector<OctreeNode>* {
+            return top_node_subtree[build_node_idx] == -1 ? nullptr : &subtrees[top_node_subtree[build_node_idx]];
+        });
+
         {
             // Transform the octree to world coordinates to reduce computation when extracting infill lines.
             auto rot = transform_to_world().toRotationMatrix();
-            transform_center(octree->root_cube, rot);
             octree->origin = rot * octree->origin;
+            octree->child_offsets.assign(cubes_properties.size(), {});
+            for (size_t depth = 0; depth < cubes_properties.size(); ++ depth)
+                for (int i = 0; i < 8; ++ i)
+                    octree->child_offsets[depth][i] = rot * (child_centers[i] * (cubes_properties[depth].edge_length / 2.));
         }
     }
 
     return octree;
 }
 
-void Octree::insert_triangle(const Vec3d &a, const Vec3d &b, const Vec3d &c, Cube *current_cube, const BoundingBoxf3 &current_bbox, int depth)
-{
-    assert(current_cube);
-    assert(depth > 0);
-
-    --depth;
-
-    // Squared radius of a sphere around the child cube.
-    // const double r2_cube = Slic3r::sqr(0.5 * this->cubes_properties[depth].height + EPSILON);
-
-    for (size_t i = 0; i < 8; ++ i) {
-        const Vec3d &child_center_dir = child_centers[i];
-        // Calculate a slightly expanded bounding box of a child cube to cope with triangles touching a cube wall and other numeric errors.
-        // We will rather densify the octree a bit more than necessary instead of missing a triangle.
-        BoundingBoxf3 bbox;
-        for (int k = 0; k < 3; ++ k) {
-            if (child_center_dir[k] == -1.) {
-                bbox.min[k] = current_bbox.min[k];
-                bbox.max[k] = current_cube->center[k] + EPSILON;
-            } else {
-                bbox.min[k] = current_cube->center[k] - EPSILON;
-                bbox.max[k] = current_bbox.max[k];
-            }
-        }
-        Vec3d child_center = current_cube->center + (child_center_dir * (this->cubes_properties[depth].edge_length / 2.));
-        //if (dist2_to_triangle(a, b, c, child_center) < r2_cube) {
-        // dist2_to_triangle and r2_cube are commented out too.
-        if (triangle_AABB_intersects(a, b, c, bbox)) {
-            if (! current_cube->children[i])
-                current_cube->children[i] = this->pool.construct(child_center);
-            if (depth > 0)
-                this->insert_triangle(a, b, c, current_cube->children[i], bbox, depth);
-        }
-    }
-}
-
 } // namespace FillAdaptive
 } // namespace Slic3r
@@ -52,6 +52,13 @@ FillAdaptive::OctreePtr         build_octree(
     // If true, octree is densified below internal overhangs only.
     bool                         support_overhangs_only);
 
+// Number of octree nodes and memory allocated by the octree, for profiling.
+struct OctreeStats {
+    size_t num_nodes;
+    size_t memory_bytes;
+};
+OctreeStats                     octree_stats(const Octree &octree);
+
 //
 // Some of the algorithms used by class FillAdaptive were inspired by
 // Cura Engine's class SubDivCube
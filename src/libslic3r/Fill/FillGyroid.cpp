@@ -9,6 +9,10 @@
 #include <cmath>
 #include <algorithm>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
 
 #include "FillGyroid.hpp"
 
@@ -107,6 +111,46 @@ static std::vector<Vec2d> make_one_period(double width, double scaleFactor, doub
     return points;
 }
 
+// Single period of the odd and even gyroid waves, see make_one_period().
+struct GyroidPeriod
+{
+    std::vector<Vec2d> odd;
+    std::vector<Vec2d> even;
+};
+
+// The gyroid waves depend on the Z phase, the line spacing and the density only, thus a single period of the waves
+// is shared by all islands of a layer, by all regions with the same infill parameters and by layers of the same phase.
+// The cache is shared by all threads, it is cleared once it grows over a limit.
+class GyroidPeriodCache
+{
+public:
+    using Key = std::tuple<int, double, double>;
+
+    template<typename Generator>
+    std::shared_ptr<const GyroidPeriod> get(const Key &key, Generator &&generate)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (auto it = m_cache.find(key); it != m_cache.end())
+                return it->second;
+        }
+        // Generate outside of the lock, two threads may rarely generate the same period.
+        auto period = std::make_shared<const GyroidPeriod>(generate());
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_cache.size() >= MaxSize)
+            m_cache.clear();
+        return m_cache.emplace(key, std::move(period)).first->second;
+    }
+
+private:
+    static constexpr size_t MaxSize = 4096;
+
+    std::mutex                                          m_mutex;
+    std::map<Key, std::shared_ptr<const GyroidPeriod>>  m_cache;
+};
+
+static GyroidPeriodCache s_gyroid_period_cache;
+
 static Polylines make_gyroid_waves(double gridZ, double density_adjusted, double line_spacing, double width, double height)
 {
     const double scaleFactor = scale_(line_spacing) / density_adjusted;
@@ -117,7 +161,10 @@ static Polylines make_gyroid_waves(double gridZ, double density_adjusted, double
 
     //scale factor for 5% : 8 712 388
     // 1z = 10^-6 mm ?
-    const double z     = gridZ / scaleFactor;
+    // Z phase is quantized to FillGyroid::PhaseBins steps per period, so that the waves may be reused
+    // by layers of nearly the same phase. The maximum phase error is PI / PhaseBins.
+    const int    z_bin = int(std::lround(std::fmod(gridZ / scaleFactor, 2. * M_PI) * FillGyroid::PhaseBins / (2. * M_PI))) % FillGyroid::PhaseBins;
+    const double z     = z_bin * 2. * M_PI / FillGyroid::PhaseBins;
     const double z_sin = sin(z);
     const double z_cos = cos(z);
 
@@ -132,9 +179,21 @@ static Polylines make_gyroid_waves(double gridZ, double density_adjusted, double
         std::swap(width,height);
     }
 
-    std::vector<Vec2d> one_period_odd = make_one_period(width, scaleFactor, z_cos, z_sin, vertical, flip, tolerance); // creates one period of the waves, so it doesn't have to be recalculated all the time
-    flip = !flip;                                                                   // even polylines are a bit shifted
-    std::vector<Vec2d> one_period_even = make_one_period(width, scaleFactor, z_cos, z_sin, vertical, flip, tolerance);
+    // creates one period of the waves, so it doesn't have to be recalculated all the time
+    auto generate_period = [&]() {
+        GyroidPeriod period;
+        period.odd  = make_one_period(width, scaleFactor, z_cos, z_sin, vertical, flip, tolerance);
+        // even polylines are a bit shifted
+        period.even = make_one_period(width, scaleFactor, z_cos, z_sin, vertical, ! flip, tolerance);
+        return period;
+    };
+    // A period truncated to a narrow bounding box is not worth caching.
+    std::shared_ptr<const GyroidPeriod> period = width < 2. * M_PI ?
+        std::make_shared<const GyroidPeriod>(generate_period()) :
+        s_gyroid_period_cache.get({ z_bin, scaleFactor, tolerance }, generate_period);
+    const std::vector<Vec2d> &one_period_odd  = period->odd;
+    const std::vector<Vec2d> &one_period_even = period->even;
+    flip = !flip;
     Polylines result;
 
     for (double y0 = lower_bound; y0 < upper_bound + EPSILON; y0 += M_PI) {
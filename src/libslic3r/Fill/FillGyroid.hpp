@@ -31,6 +31,9 @@ public:
     // Gyroid upper resolution tolerance (mm^-2)
     static constexpr double PatternTolerance = 0.2;
 
+    // Number of Z phase steps per period of the pattern, Z phase is quantized to reuse the generated waves.
+    static constexpr int PhaseBins = 4096;
+
 
 protected:
     void _fill_surface_single(
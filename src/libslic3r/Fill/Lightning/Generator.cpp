@@ -2,12 +2,15 @@
 //CuraEngine is released under the terms of the AGPLv3 or higher.
 
 #include "Generator.hpp"
+#include "DistanceField.hpp"
 #include "TreeNode.hpp"
 
 #include "../../ClipperUtils.hpp"
 #include "../../Layer.hpp"
 #include "../../Print.hpp"
 
+#include <tbb/parallel_for.h>
+
 /* Possible future tasks/optimizations,etc.:
  * - Improve connecting heuristic to favor connecting to shorter trees
  * - Change which node of a tree is the root when that would be better in reconnectRoots.
@@ -48,33 +51,46 @@ Generator::Generator(const PrintObject &print_object, const coordf_t fill_densit
     m_prune_length                                    = coord_t(layer_thickness * std::tan(lightning_infill_prune_angle));
     m_straightening_max_distance                      = coord_t(layer_thickness * std::tan(lightning_infill_straightening_angle));
 
-    generateInitialInternalOverhangs(print_object, throw_on_cancel_callback);
-    generateTrees(print_object, throw_on_cancel_callback);
+    const std::vector<Polygons> infill_outlines = collectInfillOutlines(print_object, throw_on_cancel_callback);
+    generateInitialInternalOverhangs(infill_outlines, throw_on_cancel_callback);
+    generateTrees(infill_outlines, throw_on_cancel_callback);
 }
 
-void Generator::generateInitialInternalOverhangs(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback)
+std::vector<Polygons> Generator::collectInfillOutlines(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback)
 {
-    m_overhang_per_layer.resize(print_object.layers().size());
+    std::vector<Polygons> infill_outlines(print_object.layers().size(), Polygons());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, print_object.layers().size()), [&print_object, &infill_outlines, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+        for (size_t layer_id = range.begin(); layer_id < range.end(); ++ layer_id) {
+            throw_on_cancel_callback();
+            Polygons infill_area_here;
+            for (const LayerRegion *layerm : print_object.get_layer(int(layer_id))->regions())
+                for (const Surface &surface : layerm->fill_surfaces())
+                    if (surface.surface_type == stInternal || surface.surface_type == stInternalVoid)
+                        append(infill_area_here, to_polygons(surface.expolygon));
+            infill_outlines[layer_id] = union_(infill_area_here);
+        }
+    });
+    return infill_outlines;
+}
 
-    Polygons infill_area_above;
-    // Iterate from top to bottom, to subtract the overhang areas above from the overhang areas on the layer below, to get only overhang in the top layer where it is overhanging.
-    for (int layer_nr = int(print_object.layers().size()) - 1; layer_nr >= 0; --layer_nr) {
-        throw_on_cancel_callback();
-        Polygons infill_area_here;
-        for (const LayerRegion* layerm : print_object.get_layer(layer_nr)->regions())
-            for (const Surface& surface : layerm->fill_surfaces())
-                if (surface.surface_type == stInternal || surface.surface_type == stInternalVoid)
-                    append(infill_area_here, to_polygons(surface.expolygon));
-
-        infill_area_here = union_(infill_area_here);
-        // Remove the part of the infill area that is already supported by the walls.
-        Polygons overhang = diff(offset(infill_area_here, -float(m_wall_supporting_radius)), infill_area_above);
-        // Filter out unprintable polygons and near degenerated polygons (three almost collinear points and so).
-        overhang = opening(overhang, float(SCALED_EPSILON), float(SCALED_EPSILON));
-
-        m_overhang_per_layer[layer_nr] = overhang;
-        infill_area_above = std::move(infill_area_here);
-    }
+void Generator::generateInitialInternalOverhangs(const std::vector<Polygons> &infill_outlines, const std::function<void()> &throw_on_cancel_callback)
+{
+    m_overhang_per_layer.resize(infill_outlines.size());
+
+    // Subtract the infill area of the layer above from the overhang areas of the layer below, to get only overhang in the top layer where it is overhanging.
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, infill_outlines.size()), [this, &infill_outlines, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+        for (size_t layer_id = range.begin(); layer_id < range.end(); ++ layer_id) {
+            throw_on_cancel_callback();
+            // Remove the part of the infill area that is already supported by the walls.
+            Polygons overhang = offset(infill_outlines[layer_id], -float(m_wall_supporting_radius));
+            if (layer_id + 1 < infill_outlines.size())
+                overhang = diff(overhang, infill_outlines[layer_id + 1]);
+            else
+                overhang = diff(overhang, Polygons());
+            // Filter out unprintable polygons and near degenerated polygons (three almost collinear points and so).
+            m_overhang_per_layer[layer_id] = opening(overhang, float(SCALED_EPSILON), float(SCALED_EPSILON));
+        }
+    });
 }
 
 const Layer& Generator::getTreesForLayer(const size_t& layer_id) const
@@ -83,31 +99,35 @@ const Layer& Generator::getTreesForLayer(const size_t& layer_id) const
     return m_lightning_layers[layer_id];
 }
 
-void Generator::generateTrees(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback)
+void Generator::generateTrees(const std::vector<Polygons> &infill_outlines, const std::function<void()> &throw_on_cancel_callback)
 {
-    m_lightning_layers.resize(print_object.layers().size());
-
-    std::vector<Polygons> infill_outlines(print_object.layers().size(), Polygons());
-
-    // For-each layer from top to bottom:
-    for (int layer_id = int(print_object.layers().size()) - 1; layer_id >= 0; layer_id--) {
-        throw_on_cancel_callback();
-        for (const LayerRegion *layerm : print_object.get_layer(layer_id)->regions())
-            for (const Surface &surface : layerm->fill_surfaces())
-                if (surface.surface_type == stInternal || surface.surface_type == stInternalVoid)
-                    append(infill_outlines[layer_id], to_polygons(surface.expolygon));
-
-        infill_outlines[layer_id] = union_(infill_outlines[layer_id]);
-    }
+    m_lightning_layers.resize(infill_outlines.size());
+    if (infill_outlines.empty())
+        return;
 
     // For various operations its beneficial to quickly locate nearby features on the polygon:
-    const size_t top_layer_id = print_object.layers().size() - 1;
+    const size_t top_layer_id = infill_outlines.size() - 1;
     EdgeGrid::Grid outlines_locator(get_extents(infill_outlines[top_layer_id]).inflated(SCALED_EPSILON));
     outlines_locator.create(infill_outlines[top_layer_id], locator_cell_size);
 
+    // The distance field of a layer depends on the outlines and the overhangs of that layer only, thus the distance fields
+    // are set up in parallel for a window of layers ahead of the serial propagation. The window limits the memory footprint.
+    static constexpr const int distance_fields_window = 32;
+    std::vector<std::unique_ptr<DistanceField>> distance_fields(distance_fields_window);
+
     // For-each layer from top to bottom:
     for (int layer_id = int(top_layer_id); layer_id >= 0; layer_id--) {
         throw_on_cancel_callback();
+        if (int window_idx = (int(top_layer_id) - layer_id) % distance_fields_window; window_idx == 0) {
+            const int window_bottom = std::max(0, layer_id - distance_fields_window + 1);
+            tbb::parallel_for(tbb::blocked_range<int>(window_bottom, layer_id + 1), [this, &infill_outlines, &distance_fields, layer_id, &throw_on_cancel_callback](const tbb::blocked_range<int> &range) {
+                for (int idx = range.begin(); idx < range.end(); ++ idx) {
+                    throw_on_cancel_callback();
+                    distance_fields[layer_id - idx] = std::make_unique<DistanceField>(m_supporting_radius, infill_outlines[idx], get_extents(infill_outlines[idx]), m_overhang_per_layer[idx]);
+                }
+            });
+        }
+
         Layer             &current_lightning_layer = m_lightning_layers[layer_id];
         const Polygons    &current_outlines        = infill_outlines[layer_id];
         const BoundingBox &current_outlines_bbox   = get_extents(current_outlines);
@@ -115,7 +135,11 @@ void Generator::generateTrees(const PrintObject &print_object, const std::functi
         // register all trees propagated from the previous layer as to-be-reconnected
         std::vector<NodeSPtr> to_be_reconnected_tree_roots = current_lightning_layer.tree_roots;
 
-        current_lightning_layer.generateNewTrees(m_overhang_per_layer[layer_id], current_outlines, current_outlines_bbox, outlines_locator, m_supporting_radius, m_wall_supporting_radius, throw_on_cancel_callback);
+        {
+            // Release the distance field as soon as it is not needed anymore.
+            std::unique_ptr<DistanceField> distance_field = std::move(distance_fields[(int(top_layer_id) - layer_id) % distance_fields_window]);
+            current_lightning_layer.generateNewTrees(*distance_field, current_outlines, current_outlines_bbox, outlines_locator, m_supporting_radius, m_wall_supporting_radius, throw_on_cancel_callback);
+        }
         current_lightning_layer.reconnectRoots(to_be_reconnected_tree_roots, current_outlines, current_outlines_bbox, outlines_locator, m_supporting_radius, m_wall_supporting_radius);
 
         // Initialize trees for next lower layer from the current one.
@@ -133,9 +157,17 @@ void Generator::generateTrees(const PrintObject &print_object, const std::functi
         outlines_locator.set_bbox(below_outlines_bbox);
         outlines_locator.create(below_outlines, locator_cell_size);
 
-        std::vector<NodeSPtr>& lower_trees = m_lightning_layers[layer_id - 1].tree_roots;
-        for (auto& tree : current_lightning_layer.tree_roots)
-            tree->propagateToNextLayer(lower_trees, below_outlines, outlines_locator, m_prune_length, m_straightening_max_distance, locator_cell_size / 2);
+        // Trees are propagated independently of each other. Trees propagated from a single tree root are collected separately
+        // and then concatenated in the order of the tree roots, thus the output does not depend on scheduling.
+        const std::vector<NodeSPtr> &tree_roots = current_lightning_layer.tree_roots;
+        std::vector<std::vector<NodeSPtr>> propagated_trees(tree_roots.size());
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, tree_roots.size()), [this, &tree_roots, &propagated_trees, &below_outlines, &outlines_locator](const tbb::blocked_range<size_t> &range) {
+            for (size_t tree_idx = range.begin(); tree_idx < range.end(); ++ tree_idx)
+                tree_roots[tree_idx]->propagateToNextLayer(propagated_trees[tree_idx], below_outlines, outlines_locator, m_prune_length, m_straightening_max_distance, locator_cell_size / 2);
+        });
+        std::vector<NodeSPtr> &lower_trees = m_lightning_layers[layer_id - 1].tree_roots;
+        for (std::vector<NodeSPtr> &trees : propagated_trees)
+            append(lower_trees, std::move(trees));
     }
 }
 
@@ -60,6 +60,11 @@ public:
     float infilll_extrusion_width() const { return m_infill_extrusion_width; }
 
 protected:
+    /*!
+     * Collect the sparse infill areas of all layers, calculated in parallel.
+     */
+    static std::vector<Polygons> collectInfillOutlines(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback);
+
     /*!
      * Calculate the overhangs above the infill areas that need to be supported
      * by infill.
@@ -67,13 +72,21 @@ protected:
      * Normally, overhangs are only generated for the outside of the model and
      * only when support is generated. For this pattern, we also need to
      * generate overhang areas for the inside of the model.
+     *
+     * The overhangs of a layer only depend on the infill areas of the layer
+     * and of the layer above, thus all layers are processed in parallel.
      */
-    void generateInitialInternalOverhangs(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback);
+    void generateInitialInternalOverhangs(const std::vector<Polygons> &infill_outlines, const std::function<void()> &throw_on_cancel_callback);
 
     /*!
      * Calculate the tree structure of all layers.
+     *
+     * Only the propagation of the trees from a layer to the layer below is
+     * serial. The distance fields are set up in parallel for a window of layers
+     * ahead of the propagation and the trees of a layer are propagated in
+     * parallel.
      */
-    void generateTrees(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback);
+    void generateTrees(const std::vector<Polygons> &infill_outlines, const std::function<void()> &throw_on_cancel_callback);
 
     float m_infill_extrusion_width;
 
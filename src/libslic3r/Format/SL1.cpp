@@ -8,6 +8,7 @@
 #include <boost/filesystem.hpp>
 
 #include <sstream>
+#include <atomic>
 
 #include "libslic3r/Time.hpp"
 #include "libslic3r/Zipper.hpp"
@@ -265,6 +266,12 @@ template<> struct _RasterTraits<Slic3r::png::ImageGreyscale> {
        // Number of rows and cols of the raster
     static size_t rows(const Rst &rst) { return rst.rows; }
     static size_t cols(const Rst &rst) { return rst.cols; }
+
+       // The pixels of a row, stored continuously
+    static const uint8_t *row(const Rst &rst, size_t row)
+    {
+        return rst.buf.data() + row * rst.cols;
+    }
 };
 
 } // namespace marchsq
@@ -355,55 +362,92 @@ ExPolygons rings_to_expolygons(const std::vector<marchsq::Ring> &rings,
     return union_ex(polys);
 }
 
+// Rows and columns of the image with pixels at or above the isovalue, as
+// {from, to} marching squares coordinates, empty if there is no such pixel.
+std::pair<marchsq::Coord, marchsq::Coord> active_region(
+    const png::ImageGreyscale &img, uint8_t isoval)
+{
+    marchsq::Coord from{long(img.rows), long(img.cols)}, to{0, 0};
+    auto is_active = [isoval](uint8_t px) { return px >= isoval; };
+
+    for (size_t r = 0; r < img.rows; ++r) {
+        auto row = img.buf.begin() + r * img.cols;
+        auto first = std::find_if(row, row + img.cols, is_active);
+        if (first == row + img.cols)
+            continue;
+
+        auto last = std::find_if(std::make_reverse_iterator(row + img.cols),
+                                 std::make_reverse_iterator(first), is_active);
+
+        from.r = std::min(from.r, long(r));
+        to.r   = long(r) + 1;
+        from.c = std::min(from.c, long(first - row));
+        to.c   = std::max(to.c, long(last.base() - row));
+    }
+
+    return {from, to};
+}
+
 std::vector<ExPolygons> extract_slices_from_sla_archive(
-    ZipperArchive           &arch,
+    ZipperArchiveReader     &arch,
     const RasterParams      &rstp,
     const marchsq::Coord    &win,
     std::function<bool(int)> progr)
 {
-    std::vector<ExPolygons> slices(arch.entries.size());
-
-    struct Status
-    {
-        double                                 incr, val, prev;
-        bool                                   stop  = false;
-        execution::SpinningMutex<ExecutionTBB> mutex = {};
-    } st{100. / slices.size(), 0., 0.};
-
-    execution::for_each(
-        ex_tbb, size_t(0), arch.entries.size(),
-        [&arch, &slices, &st, &rstp, &win, progr](size_t i) {
-            // Status indication guarded with the spinlock
-            {
-                std::lock_guard lck(st.mutex);
-                if (st.stop) return;
-
-                st.val += st.incr;
-                double curr = std::round(st.val);
-                if (curr > st.prev) {
-                    st.prev = curr;
-                    st.stop = !progr(int(curr));
+    const size_t layer_count = arch.entry_count();
+    std::vector<ExPolygons> slices(layer_count);
+
+    // The layers are inflated from the archive and decoded in windows, only
+    // the PNG files and the images of one window are held in memory.
+    const size_t window = 2 * execution::max_concurrency(ex_tbb);
+
+    std::atomic<size_t> layers_done{0};
+    int  prev = 0;
+    bool stop = false;
+
+    for (size_t from = 0; from < layer_count && !stop; from += window) {
+        size_t to = std::min(layer_count, from + window);
+
+        std::vector<EntryBuffer> entries;
+        entries.reserve(to - from);
+        for (size_t i = from; i < to; ++i)
+            entries.emplace_back(arch.read_entry(i));
+
+        execution::for_each(
+            ex_tbb, from, to,
+            [&entries, &slices, &rstp, &win, &layers_done, from](size_t i) {
+                png::ImageGreyscale img;
+                EntryBuffer &entry = entries[i - from];
+                png::ReadBuf rb{entry.buf.data(), entry.buf.size()};
+                bool decoded = png::decode_png(rb, img);
+                entry.buf = {};
+
+                if (decoded) {
+                    // Only the part of the image with the slice is processed
+                    constexpr uint8_t isoval = 128;
+                    auto [rfrom, rto] = active_region(img, isoval);
+                    auto rings = marchsq::execute_in_region(img, isoval, rfrom, rto, win);
+                    ExPolygons expolys = rings_to_expolygons(rings, rstp.px_w,
+                                                             rstp.px_h);
+
+                    // Invert the raster transformations indicated in the profile metadata
+                    invert_raster_trafo(expolys, rstp.trafo, rstp.width, rstp.height);
+
+                    slices[i] = std::move(expolys);
                 }
-            }
-
-            png::ImageGreyscale img;
-            png::ReadBuf        rb{arch.entries[i].buf.data(),
-                            arch.entries[i].buf.size()};
-            if (!png::decode_png(rb, img)) return;
 
-            constexpr uint8_t isoval = 128;
-            auto              rings = marchsq::execute(img, isoval, win);
-            ExPolygons        expolys = rings_to_expolygons(rings, rstp.px_w,
-                                                            rstp.px_h);
+                layers_done.fetch_add(1, std::memory_order_relaxed);
+            },
+            1 /* granularity */);
 
-            // Invert the raster transformations indicated in the profile metadata
-            invert_raster_trafo(expolys, rstp.trafo, rstp.width, rstp.height);
-
-            slices[i] = std::move(expolys);
-        },
-        execution::max_concurrency(ex_tbb));
+        int curr = int(std::round(100. * layers_done.load() / layer_count));
+        if (curr > prev) {
+            prev = curr;
+            stop = !progr(curr);
+        }
+    }
 
-    if (st.stop) slices = {};
+    if (stop) slices = {};
 
     return slices;
 }
@@ -430,8 +474,8 @@ ConfigSubstitutions SL1Reader::read(std::vector<ExPolygons> &slices,
 
     std::vector<std::string> includes = { "ini", "png"};
     std::vector<std::string> excludes = { "thumbnail" };
-    ZipperArchive arch = read_zipper_archive(m_fname, includes, excludes);
-    auto [profile_use, config_substitutions] = extract_profile(arch, profile_out);
+    ZipperArchiveReader arch(m_fname, includes, excludes);
+    auto [profile_use, config_substitutions] = extract_profile(arch.metadata(), profile_out);
 
     RasterParams   rstp = get_raster_params(profile_use);
     marchsq::Coord win  = {windowsize.y(), windowsize.x()};
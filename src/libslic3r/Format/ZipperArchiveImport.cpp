@@ -48,30 +48,28 @@ EntryBuffer read_entry(const mz_zip_archive_file_stat &entry,
 
 } // namespace
 
-ZipperArchive read_zipper_archive(const std::string &zipfname,
-                                  const std::vector<std::string> &includes,
-                                  const std::vector<std::string> &excludes)
+struct ZipperArchiveReader::Zip : public MZ_Archive
 {
-    ZipperArchive arch;
-
-    // Little RAII
-    struct Arch : public MZ_Archive
+    Zip(const std::string &fname)
     {
-        Arch(const std::string &fname)
-        {
-            if (!open_zip_reader(&arch, fname))
-                throw Slic3r::FileIOError(get_errorstr());
-        }
+        if (!open_zip_reader(&arch, fname))
+            throw Slic3r::FileIOError(get_errorstr());
+    }
 
-        ~Arch() { close_zip_reader(&arch); }
-    } zip(zipfname);
+    ~Zip() { close_zip_reader(&arch); }
+};
 
-    mz_uint num_entries = mz_zip_reader_get_num_files(&zip.arch);
+ZipperArchiveReader::ZipperArchiveReader(const std::string &zipfname,
+                                         const std::vector<std::string> &includes,
+                                         const std::vector<std::string> &excludes)
+    : m_zip{std::make_unique<Zip>(zipfname)}
+{
+    mz_uint num_entries = mz_zip_reader_get_num_files(&m_zip->arch);
 
     for (mz_uint i = 0; i < num_entries; ++i) {
         mz_zip_archive_file_stat entry;
 
-        if (mz_zip_reader_file_stat(&zip.arch, i, &entry)) {
+        if (mz_zip_reader_file_stat(&m_zip->arch, i, &entry)) {
             std::string name = entry.m_filename;
             boost::algorithm::to_lower(name);
 
@@ -88,25 +86,47 @@ ZipperArchive read_zipper_archive(const std::string &zipfname,
                 continue;
 
             if (name == CONFIG_FNAME)  {
-                arch.config = read_ini(entry, zip);
+                m_metadata.config = read_ini(entry, *m_zip);
                 continue;
             }
 
             if (name == PROFILE_FNAME) {
-                arch.profile = read_ini(entry, zip);
+                m_metadata.profile = read_ini(entry, *m_zip);
                 continue;
             }
 
             auto it = std::lower_bound(
-                arch.entries.begin(), arch.entries.end(),
-                EntryBuffer{{}, name},
-                [](const EntryBuffer &r1, const EntryBuffer &r2) {
-                    return std::less<std::string>()(r1.fname, r2.fname);
+                m_entries.begin(), m_entries.end(), name,
+                [](const Entry &e, const std::string &n) {
+                    return std::less<std::string>()(e.fname, n);
                 });
 
-            arch.entries.insert(it, read_entry(entry, zip, name));
+            m_entries.insert(it, Entry{name, unsigned(i)});
         }
     }
+}
+
+ZipperArchiveReader::~ZipperArchiveReader() = default;
+
+EntryBuffer ZipperArchiveReader::read_entry(size_t idx)
+{
+    mz_zip_archive_file_stat entry;
+    if (!mz_zip_reader_file_stat(&m_zip->arch, m_entries[idx].file_index, &entry))
+        throw Slic3r::FileIOError(m_zip->get_errorstr());
+
+    return Slic3r::read_entry(entry, *m_zip, m_entries[idx].fname);
+}
+
+ZipperArchive read_zipper_archive(const std::string &zipfname,
+                                  const std::vector<std::string> &includes,
+                                  const std::vector<std::string> &excludes)
+{
+    ZipperArchiveReader reader(zipfname, includes, excludes);
+
+    ZipperArchive arch = reader.metadata();
+    arch.entries.reserve(reader.entry_count());
+    for (size_t i = 0; i < reader.entry_count(); ++i)
+        arch.entries.emplace_back(reader.read_entry(i));
 
     return arch;
 }
@@ -8,6 +8,7 @@
 #include <vector>
 #include <string>
 #include <cstdint>
+#include <memory>
 
 #include <boost/property_tree/ptree.hpp>
 
@@ -45,6 +46,40 @@ ZipperArchive read_zipper_archive(const std::string &zipfname,
                                   const std::vector<std::string> &includes,
                                   const std::vector<std::string> &excludes);
 
+// Reader of a zipper archive which reads the entries into memory one by one,
+// on request. The files CONFIG_FNAME and PROFILE_FNAME are read on opening,
+// the other files matching the includes and excludes (as with
+// read_zipper_archive()) are only listed. The archive stays open until the
+// reader is destroyed.
+class ZipperArchiveReader
+{
+    struct Zip;
+    struct Entry
+    {
+        std::string fname;
+        unsigned    file_index;
+    };
+
+    std::unique_ptr<Zip> m_zip;
+    std::vector<Entry>   m_entries; // Sorted by name
+    ZipperArchive        m_metadata;
+
+public:
+    ZipperArchiveReader(const std::string &zipfname,
+                        const std::vector<std::string> &includes,
+                        const std::vector<std::string> &excludes);
+    ~ZipperArchiveReader();
+
+    // The metadata read on opening, its entries are empty.
+    const ZipperArchive &metadata() const { return m_metadata; }
+
+    size_t             entry_count() const { return m_entries.size(); }
+    const std::string &entry_name(size_t idx) const { return m_entries[idx].fname; }
+
+    // Read the entry with the given index into memory. Not thread safe.
+    EntryBuffer read_entry(size_t idx);
+};
+
 // Extract the print profile form the archive into 'out'.
 // Returns a profile that has correct parameters to use for model reconstruction
 // even if the needed parameters were not fully found in the archive's metadata.
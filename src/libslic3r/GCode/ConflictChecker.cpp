@@ -6,11 +6,14 @@
 #include "ConflictChecker.hpp"
 
 #include <tbb/parallel_for.h>
-#include <tbb/concurrent_vector.h>
+#include <tbb/parallel_sort.h>
+#include <tbb/enumerable_thread_specific.h>
 
-#include <map>
 #include <functional>
 #include <atomic>
+#include <limits>
+#include <mutex>
+#include <tuple>
 
 namespace Slic3r {
 
@@ -30,9 +33,10 @@ inline IndexPair point_map_grid_index(const Point &pt, int64_t xdist, int64_t yd
 
 inline bool nearly_equal(const Point &p1, const Point &p2) { return std::abs(p1.x() - p2.x()) < SCALED_EPSILON && std::abs(p1.y() - p2.y()) < SCALED_EPSILON; }
 
-inline Grids line_rasterization(const Line &line, int64_t xdist = RasteXDistance, int64_t ydist = RasteYDistance)
+// Append the grid cells crossed by the line to res, in the order from line.a to line.b.
+inline void line_rasterization(const Line &line, Grids &res, int64_t xdist = RasteXDistance, int64_t ydist = RasteYDistance)
 {
-    Grids     res;
+    const size_t res_begin = res.size();
     Point     rayStart     = line.a;
     Point     rayEnd       = line.b;
     IndexPair currentVoxel = point_map_grid_index(rayStart, xdist, ydist);
@@ -84,12 +88,10 @@ inline Grids line_rasterization(const Line &line, int64_t xdist = RasteXDistance
             ty += tDeltaY;
         }
         res.push_back(currentVoxel);
-        if (res.size() >= 100000) { // bug
+        if (res.size() - res_begin >= 100000) { // bug
             assert(0);
         }
     }
-
-    return res;
 }
 } // namespace RasterizationImpl
 
@@ -275,21 +277,104 @@ std::pair<std::vector<ExtrusionPaths>, std::vector<ExtrusionPaths>> getAllLayers
 ConflictComputeOpt ConflictChecker::find_inter_of_lines(const LineWithIDs &lines)
 {
     using namespace RasterizationImpl;
-    std::map<IndexPair, std::vector<int>> indexToLine;
-
-    for (int i = 0; i < (int)lines.size(); ++i) {
-        const LineWithID &l1      = lines[i];
-        auto              indexes = line_rasterization(l1._line);
-        for (auto index : indexes) {
-            const auto &possibleIntersectIdxs = indexToLine[index];
-            for (auto possibleIntersectIdx : possibleIntersectIdxs) {
-                const LineWithID &l2 = lines[possibleIntersectIdx];
-                if (auto interRes = line_intersect(l1, l2); interRes.has_value()) { return interRes; }
-            }
-            indexToLine[index].push_back(i);
+
+    // Grid cell crossed by a line.
+    struct CellLine {
+        IndexPair cell;
+        int       line_idx;
+        // Order of the cell in the rasterization of the line.
+        int       cell_order;
+        bool operator<(const CellLine &rhs) const { return cell < rhs.cell || (cell == rhs.cell && line_idx < rhs.line_idx); }
+    };
+
+    // Rasterize the lines in parallel.
+    tbb::enumerable_thread_specific<std::vector<CellLine>> cell_lines_tls;
+    tbb::parallel_for(tbb::blocked_range<int>(0, int(lines.size())), [&lines, &cell_lines_tls](const tbb::blocked_range<int> &range) {
+        std::vector<CellLine> &cell_lines = cell_lines_tls.local();
+        Grids                  cells;
+        for (int i = range.begin(); i < range.end(); ++ i) {
+            cells.clear();
+            line_rasterization(lines[i]._line, cells);
+            for (int j = 0; j < int(cells.size()); ++ j)
+                cell_lines.push_back({ cells[j], i, j });
+        }
+    });
+    std::vector<CellLine> cell_lines_unsorted;
+    for (std::vector<CellLine> &v : cell_lines_tls)
+        append(cell_lines_unsorted, std::move(v));
+    if (cell_lines_unsorted.empty())
+        return {};
+
+    // Group the rasterized lines by cells into a flat array, sorted by cell, then by line index.
+    std::vector<CellLine> cell_lines;
+    // Ranges of cell_lines of the cells crossed by more than a single line.
+    std::vector<std::pair<size_t, size_t>> cells;
+    IndexPair cell_min = cell_lines_unsorted.front().cell;
+    IndexPair cell_max = cell_min;
+    for (const CellLine &cl : cell_lines_unsorted) {
+        cell_min = { std::min(cell_min.first, cl.cell.first), std::min(cell_min.second, cl.cell.second) };
+        cell_max = { std::max(cell_max.first, cl.cell.first), std::max(cell_max.second, cl.cell.second) };
+    }
+    const size_t grid_cols  = size_t(cell_max.first - cell_min.first + 1);
+    const size_t grid_cells = grid_cols * size_t(cell_max.second - cell_min.second + 1);
+    if (grid_cells <= 4 * cell_lines_unsorted.size() + (size_t(1) << 20)) {
+        // Dense grid over the bounding box of the lines: counting sort by cell.
+        auto grid_idx = [&cell_min, grid_cols](const IndexPair &cell) { return size_t(cell.second - cell_min.second) * grid_cols + size_t(cell.first - cell_min.first); };
+        std::vector<uint32_t> grid(grid_cells + 1, 0);
+        for (const CellLine &cl : cell_lines_unsorted)
+            ++ grid[grid_idx(cl.cell) + 1];
+        for (size_t i = 1; i <= grid_cells; ++ i) {
+            if (grid[i] > 1)
+                cells.emplace_back(grid[i - 1], grid[i - 1] + grid[i]);
+            grid[i] += grid[i - 1];
+        }
+        cell_lines.resize(cell_lines_unsorted.size());
+        for (const CellLine &cl : cell_lines_unsorted)
+            cell_lines[grid[grid_idx(cl.cell)] ++] = cl;
+        // Lines were rasterized in parallel, order them inside each cell.
+        for (const std::pair<size_t, size_t> &cell : cells)
+            std::sort(cell_lines.begin() + cell.first, cell_lines.begin() + cell.second);
+    } else {
+        // Lines spread sparsely: sort by cell.
+        cell_lines = std::move(cell_lines_unsorted);
+        tbb::parallel_sort(cell_lines.begin(), cell_lines.end());
+        for (size_t i = 0; i < cell_lines.size();) {
+            size_t j = i + 1;
+            for (; j < cell_lines.size() && cell_lines[j].cell == cell_lines[i].cell; ++ j) ;
+            if (j - i > 1)
+                cells.emplace_back(i, j);
+            i = j;
         }
     }
-    return {};
+
+    // Test the lines sharing a cell in parallel. Report the same conflict as if the lines were inserted into the grid one by one
+    // and tested against the lines inserted before them: the lexicographically smallest (line index, cell order, index of the earlier line).
+    using ConflictKey = std::tuple<int, int, int>;
+    ConflictKey        best_key { std::numeric_limits<int>::max(), 0, 0 };
+    ConflictComputeOpt best;
+    std::mutex         best_mutex;
+    std::atomic<int>   best_line_idx { std::numeric_limits<int>::max() };
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, cells.size()), [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t cell_idx = range.begin(); cell_idx < range.end(); ++ cell_idx) {
+            const auto [begin, end] = cells[cell_idx];
+            bool found = false;
+            // Lines with higher index than an already found conflict cannot improve it.
+            for (size_t k = begin + 1; ! found && k < end && cell_lines[k].line_idx <= best_line_idx.load(std::memory_order_relaxed); ++ k)
+                for (size_t m = begin; m < k; ++ m)
+                    if (ConflictComputeOpt res = line_intersect(lines[cell_lines[k].line_idx], lines[cell_lines[m].line_idx]); res) {
+                        ConflictKey key { cell_lines[k].line_idx, cell_lines[k].cell_order, cell_lines[m].line_idx };
+                        std::lock_guard<std::mutex> lock(best_mutex);
+                        if (key < best_key) {
+                            best_key = key;
+                            best     = res;
+                            best_line_idx.store(cell_lines[k].line_idx, std::memory_order_relaxed);
+                        }
+                        found = true;
+                        break;
+                    }
+        }
+    });
+    return best;
 }
 
 ConflictResultOpt ConflictChecker::find_inter_of_lines_in_diff_objs(SpanOfConstPtrs<PrintObject> objs,
@@ -329,28 +414,23 @@ ConflictResultOpt ConflictChecker::find_inter_of_lines_in_diff_objs(SpanOfConstP
         layersLines.push_back(std::move(lines));
     }
 
-    bool                                   find = false;
-    tbb::concurrent_vector<std::pair<ConflictComputeResult,double>> conflict;
+    // Index of the lowest layer with a conflict found so far, the layers above it do not need to be checked.
+    std::atomic<size_t>             first_conflict_layer { layersLines.size() };
+    std::vector<ConflictComputeOpt> conflicts(layersLines.size());
 
     tbb::parallel_for(tbb::blocked_range<size_t>(0, layersLines.size()), [&](tbb::blocked_range<size_t> range) {
-        for (size_t i = range.begin(); i < range.end(); i++) {
-            auto interRes = find_inter_of_lines(layersLines[i]);
-            if (interRes.has_value()) {
-                find = true;
-                conflict.emplace_back(*interRes, heights[i]);
+        for (size_t i = range.begin(); i < range.end() && i < first_conflict_layer.load(std::memory_order_relaxed); i++) {
+            if (conflicts[i] = find_inter_of_lines(layersLines[i]); conflicts[i].has_value()) {
+                for (size_t first = first_conflict_layer.load(); i < first && ! first_conflict_layer.compare_exchange_weak(first, i);) ;
                 break;
             }
         }
     });
 
-    if (find) {
-        std::sort(conflict.begin(), conflict.end(), [](const std::pair<ConflictComputeResult, double>& i1, const std::pair<ConflictComputeResult, double>& i2) {
-            return i1.second < i2.second;
-        });
-
-        const void *ptr1           = conflictQueue.idToObjsPtr(conflict[0].first._obj1);
-        const void *ptr2           = conflictQueue.idToObjsPtr(conflict[0].first._obj2);
-        double      conflictHeight = conflict[0].second;
+    if (size_t layer_idx = first_conflict_layer.load(); layer_idx < layersLines.size()) {
+        const void *ptr1           = conflictQueue.idToObjsPtr(conflicts[layer_idx]->_obj1);
+        const void *ptr2           = conflictQueue.idToObjsPtr(conflicts[layer_idx]->_obj2);
+        double      conflictHeight = heights[layer_idx];
         if (ptr1 == &wtptr || ptr2 == &wtptr) {
             assert(! wipe_tower_data.z_and_depth_pairs.empty());
             if (ptr2 == &wtptr) { std::swap(ptr1, ptr2); }
@@ -12,8 +12,9 @@
 #include "CoolingBuffer.hpp"
 #include <algorithm>
 #include <boost/algorithm/string/predicate.hpp>
-#include <boost/algorithm/string/replace.hpp>
 #include <boost/log/trivial.hpp>
+#include <charconv>
+#include <cstring>
 #include <iostream>
 #include <float.h>
 
@@ -123,53 +124,53 @@ struct PerExtruderAdjustments
     // Calculate the total elapsed time per this extruder, adjusted for the slowdown.
     float elapsed_time_total() const {
         float time_total = 0.f;
-        for (const CoolingLine &line : lines)
-            time_total += line.time;
+        for (const CoolingLine *line : lines)
+            time_total += line->time;
         return time_total;
     }
     // Calculate the total elapsed time when slowing down 
     // to the minimum extrusion feed rate defined for the current material.
     float maximum_time_after_slowdown(bool slowdown_external_perimeters) const {
         float time_total = 0.f;
-        for (const CoolingLine &line : lines)
-            if (line.adjustable(slowdown_external_perimeters)) {
-                if (line.time_max == FLT_MAX)
+        for (const CoolingLine *line : lines)
+            if (line->adjustable(slowdown_external_perimeters)) {
+                if (line->time_max == FLT_MAX)
                     return FLT_MAX;
                 else
-                    time_total += line.time_max;
+                    time_total += line->time_max;
             } else
-                time_total += line.time;
+                time_total += line->time;
         return time_total;
     }
     // Calculate the adjustable part of the total time.
     float adjustable_time(bool slowdown_external_perimeters) const {
         float time_total = 0.f;
-        for (const CoolingLine &line : lines)
-            if (line.adjustable(slowdown_external_perimeters))
-                time_total += line.time;
+        for (const CoolingLine *line : lines)
+            if (line->adjustable(slowdown_external_perimeters))
+                time_total += line->time;
         return time_total;
     }
     // Calculate the non-adjustable part of the total time.
     float non_adjustable_time(bool slowdown_external_perimeters) const {
         float time_total = 0.f;
-        for (const CoolingLine &line : lines)
-            if (! line.adjustable(slowdown_external_perimeters))
-                time_total += line.time;
+        for (const CoolingLine *line : lines)
+            if (! line->adjustable(slowdown_external_perimeters))
+                time_total += line->time;
         return time_total;
     }
     // Slow down the adjustable extrusions to the minimum feedrate allowed for the current extruder material.
     // Used by both proportional and non-proportional slow down.
     float slowdown_to_minimum_feedrate(bool slowdown_external_perimeters) {
         float time_total = 0.f;
-        for (CoolingLine &line : lines) {
-            if (line.adjustable(slowdown_external_perimeters)) {
-                assert(line.time_max >= 0.f && line.time_max < FLT_MAX);
-                line.slowdown = true;
-                line.time     = line.time_max;
-                assert(line.time > 0);
-                line.feedrate = line.length / line.time;
+        for (CoolingLine *line : lines) {
+            if (line->adjustable(slowdown_external_perimeters)) {
+                assert(line->time_max >= 0.f && line->time_max < FLT_MAX);
+                line->slowdown = true;
+                line->time     = line->time_max;
+                assert(line->time > 0);
+                line->feedrate = line->length / line->time;
             }
-            time_total += line.time;
+            time_total += line->time;
         }
         return time_total;
     }
@@ -178,14 +179,14 @@ struct PerExtruderAdjustments
     float slow_down_proportional(float factor, bool slowdown_external_perimeters) {
         assert(factor >= 1.f);
         float time_total = 0.f;
-        for (CoolingLine &line : lines) {
-            if (line.adjustable(slowdown_external_perimeters)) {
-                line.slowdown = true;
-                line.time     = std::min(line.time_max, line.time * factor);
-                assert(line.time > 0);
-                line.feedrate = line.length / line.time;
+        for (CoolingLine *line : lines) {
+            if (line->adjustable(slowdown_external_perimeters)) {
+                line->slowdown = true;
+                line->time     = std::min(line->time_max, line->time * factor);
+                assert(line->time > 0);
+                line->feedrate = line->length / line->time;
             }
-            time_total += line.time;
+            time_total += line->time;
         }
         return time_total;
     }
@@ -193,17 +194,17 @@ struct PerExtruderAdjustments
     // Sort the lines, adjustable first, higher feedrate first.
     // Used by non-proportional slow down.
     void sort_lines_by_decreasing_feedrate() {
-        std::sort(lines.begin(), lines.end(), [](const CoolingLine &l1, const CoolingLine &l2) {
-            bool adj1 = l1.adjustable();
-            bool adj2 = l2.adjustable();
-            return (adj1 == adj2) ? l1.feedrate > l2.feedrate : adj1;
+        std::sort(lines.begin(), lines.end(), [](const CoolingLine *l1, const CoolingLine *l2) {
+            bool adj1 = l1->adjustable();
+            bool adj2 = l2->adjustable();
+            return (adj1 == adj2) ? l1->feedrate > l2->feedrate : adj1;
         });
         for (n_lines_adjustable = 0; 
-            n_lines_adjustable < lines.size() && this->lines[n_lines_adjustable].adjustable();
+            n_lines_adjustable < lines.size() && this->lines[n_lines_adjustable]->adjustable();
             ++ n_lines_adjustable);
         time_non_adjustable = 0.f;
         for (size_t i = n_lines_adjustable; i < lines.size(); ++ i)
-            time_non_adjustable += lines[i].time;
+            time_non_adjustable += lines[i]->time;
     }
 
     // Calculate the maximum time stretch when slowing down to min_feedrate.
@@ -213,10 +214,10 @@ struct PerExtruderAdjustments
         float time_stretch = 0.f;
         assert(this->min_print_speed < min_feedrate + EPSILON);
         for (size_t i = 0; i < n_lines_adjustable; ++ i) {
-            const CoolingLine &line = lines[i];
-            if (line.feedrate > min_feedrate) {
+            const CoolingLine *line = lines[i];
+            if (line->feedrate > min_feedrate) {
                 assert(min_feedrate > 0);
-                time_stretch += line.time * (line.feedrate / min_feedrate - 1.f);
+                time_stretch += line->time * (line->feedrate / min_feedrate - 1.f);
             }
         }
         return time_stretch;
@@ -228,12 +229,12 @@ struct PerExtruderAdjustments
     void slow_down_to_feedrate(float min_feedrate) {
         assert(this->min_print_speed < min_feedrate + EPSILON);
         for (size_t i = 0; i < n_lines_adjustable; ++ i) {
-            CoolingLine &line = lines[i];
-            if (line.feedrate > min_feedrate) {
+            CoolingLine *line = lines[i];
+            if (line->feedrate > min_feedrate) {
                 assert(min_feedrate > 0);
-                line.time *= std::max(1.f, line.feedrate / min_feedrate);
-                line.feedrate = min_feedrate;
-                line.slowdown = true;
+                line->time *= std::max(1.f, line->feedrate / min_feedrate);
+                line->feedrate = min_feedrate;
+                line->slowdown = true;
             }
         }
     }
@@ -247,8 +248,9 @@ struct PerExtruderAdjustments
     // Minimum print speed allowed for this extruder.
     float                       min_print_speed     = 0.f;
 
-    // Parsed lines.
-    std::vector<CoolingLine>    lines;
+    // Parsed lines of this extruder, pointing to the lines of the whole layer stored in the G-code order.
+    // Sorted by sort_lines_by_decreasing_feedrate() for the non-proportional slow down.
+    std::vector<CoolingLine*>   lines;
     // The following two values are set by sort_lines_by_decreasing_feedrate():
     // Number of adjustable lines, at the start of lines.
     size_t                      n_lines_adjustable  = 0;
@@ -277,7 +279,7 @@ float new_feedrate_to_reach_time_stretch(
         for (auto it = it_begin; it != it_end; ++ it) {
 			assert((*it)->min_print_speed < min_feedrate + EPSILON);
 			for (size_t i = 0; i < (*it)->n_lines_adjustable; ++i) {
-				const CoolingLine &line = (*it)->lines[i];
+				const CoolingLine &line = *(*it)->lines[i];
                 if (line.feedrate > min_feedrate) {
                     nomin += line.time * line.feedrate;
                     denom += line.time;
@@ -293,7 +295,7 @@ float new_feedrate_to_reach_time_stretch(
             goto finished;
         for (auto it = it_begin; it != it_end; ++ it)
 			for (size_t i = 0; i < (*it)->n_lines_adjustable; ++i) {
-				const CoolingLine &line = (*it)->lines[i];
+				const CoolingLine &line = *(*it)->lines[i];
                 if (line.feedrate > min_feedrate && line.feedrate < new_feedrate)
                     // Some of the line segments taken into account in the calculation of nomin / denom are now slower than new_feedrate, 
                     // which makes the new_feedrate lower than it should be.
@@ -333,17 +335,19 @@ std::string CoolingBuffer::process_layer(std::string &&gcode, size_t layer_id, b
     if (flush) {
         // This is either an object layer or the very last print layer. Calculate cool down over the collected support layers
         // and one object layer.
-        std::vector<PerExtruderAdjustments> per_extruder_adjustments = this->parse_layer_gcode(m_gcode, m_current_pos);
+        // The lines are parsed in the G-code order, thus the G-code is rewritten in a single pass over the lines.
+        std::vector<CoolingLine>            lines;
+        std::vector<PerExtruderAdjustments> per_extruder_adjustments = this->parse_layer_gcode(m_gcode, m_current_pos, lines);
         float layer_time_stretched = this->calculate_layer_slowdown(per_extruder_adjustments);
-        out = this->apply_layer_cooldown(m_gcode, layer_id, layer_time_stretched, per_extruder_adjustments);
+        out = this->apply_layer_cooldown(m_gcode, layer_id, layer_time_stretched, lines);
         m_gcode.clear();
     }
     return out;
 }
 
 // Parse the layer G-code for the moves, which could be adjusted.
-// Return the list of parsed lines, bucketed by an extruder.
-std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::string &gcode, std::array<float, 5> &current_pos) const
+// The parsed lines are stored into lines in the G-code order, the returned adjustments reference them bucketed by an extruder.
+std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::string &gcode, std::array<float, 5> &current_pos, std::vector<CoolingLine> &lines) const
 {
     std::vector<PerExtruderAdjustments> per_extruder_adjustments(m_extruder_ids.size());
     std::vector<size_t>                 map_extruder_to_per_extruder_adjustment(m_num_extruders, 0);
@@ -362,9 +366,11 @@ std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::
     const char       *line_start = gcode.c_str();
     const char       *line_end   = line_start;
     const char        extrusion_axis = get_extrusion_axis(m_config)[0];
-    // Index of an existing CoolingLine of the current adjustment, which holds the feedrate setting command
+    // Index of an existing CoolingLine, which holds the feedrate setting command
     // for a sequence of extrusion moves.
     size_t            active_speed_modifier = size_t(-1);
+    // Index of PerExtruderAdjustments for each of lines.
+    std::vector<size_t> line_adjustment_idxs;
 
     std::array<float, AxisIdx::Count> new_pos;
     for (; *line_start != 0; line_start = line_end) 
@@ -373,6 +379,8 @@ std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::
             ++ line_end;
         // sline will not contain the trailing '\n'.
         std::string_view sline(line_start, line_end - line_start);
+        // The cooling markers are stored in G-code comments, search for them in the comment only.
+        std::string_view comment = sline.substr(std::min(sline.find(';'), sline.size()));
         // CoolingLine will contain the trailing '\n'.
         if (*line_end == '\n')
             ++ line_end;
@@ -428,15 +436,15 @@ std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::
                 (line.type & (CoolingLine::TYPE_G2G3_IJ | CoolingLine::TYPE_G2G3_R)));
             // Arc is defined either by IJ or by R, not by both.
             assert(! ((line.type & CoolingLine::TYPE_G2G3_IJ) && (line.type & CoolingLine::TYPE_G2G3_R)));
-            bool external_perimeter = boost::contains(sline, ";_EXTERNAL_PERIMETER");
-            bool wipe               = boost::contains(sline, ";_WIPE");
+            bool external_perimeter = ! comment.empty() && comment.find(";_EXTERNAL_PERIMETER") != std::string_view::npos;
+            bool wipe               = ! comment.empty() && comment.find(";_WIPE") != std::string_view::npos;
             if (external_perimeter)
                 line.type |= CoolingLine::TYPE_EXTERNAL_PERIMETER;
             if (wipe)
                 line.type |= CoolingLine::TYPE_WIPE;
-            if (boost::contains(sline, ";_EXTRUDE_SET_SPEED") && ! wipe) {
+            if (! comment.empty() && comment.find(";_EXTRUDE_SET_SPEED") != std::string_view::npos && ! wipe) {
                 line.type |= CoolingLine::TYPE_ADJUSTABLE;
-                active_speed_modifier = adjustment->lines.size();
+                active_speed_modifier = lines.size();
             }
             if ((line.type & CoolingLine::TYPE_G92) == 0) {
                 // G0, G1, G2, G3. Calculate the duration.
@@ -485,10 +493,10 @@ std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::
                     assert(adjustment->min_print_speed >= 0);
                     line.time_max = (adjustment->min_print_speed == 0.f) ? FLT_MAX : std::max(line.time, line.length / adjustment->min_print_speed);
                 }
-                if (active_speed_modifier < adjustment->lines.size() && (line.type & (CoolingLine::TYPE_G1 | CoolingLine::TYPE_G2G3))) {
+                if (active_speed_modifier < lines.size() && (line.type & (CoolingLine::TYPE_G1 | CoolingLine::TYPE_G2G3))) {
                     // Inside the ";_EXTRUDE_SET_SPEED" blocks, there must not be a G1 Fxx entry.
                     assert((line.type & CoolingLine::TYPE_HAS_F) == 0);
-                    CoolingLine &sm = adjustment->lines[active_speed_modifier];
+                    CoolingLine &sm = lines[active_speed_modifier];
                     assert(sm.feedrate > 0.f);
                     sm.length   += line.length;
                     sm.time     += line.time;
@@ -507,8 +515,8 @@ std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::
             // Closing a block of non-zero length extrusion moves.
             line.type = CoolingLine::TYPE_EXTRUDE_END;
             if (active_speed_modifier != size_t(-1)) {
-                assert(active_speed_modifier < adjustment->lines.size());
-                CoolingLine &sm = adjustment->lines[active_speed_modifier];
+                assert(active_speed_modifier < lines.size());
+                CoolingLine &sm = lines[active_speed_modifier];
                 // There should be at least some extrusion move inside the adjustment block.
                 // However if the block has no extrusion (which is wrong), fix it for the cooling buffer to work.
                 assert(sm.length > 0);
@@ -562,7 +570,9 @@ std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::
             line.time_max = line.time;
         }
 
-        if (boost::contains(sline, ";_SET_FAN_SPEED")) {
+        if (comment.empty()) {
+            // No cooling markers.
+        } else if (comment.find(";_SET_FAN_SPEED") != std::string_view::npos) {
             auto speed_start = sline.find_last_of('D');
             int  speed       = 0;
             for (char num : sline.substr(speed_start + 1)) {
@@ -570,14 +580,20 @@ std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::
             }
             line.type |= CoolingLine::TYPE_SET_FAN_SPEED;
             line.fan_speed = speed;
-        } else if (boost::contains(sline, ";_RESET_FAN_SPEED")) {
+        } else if (comment.find(";_RESET_FAN_SPEED") != std::string_view::npos) {
             line.type |= CoolingLine::TYPE_RESET_FAN_SPEED;
         }
 
-        if (line.type != 0)
-            adjustment->lines.emplace_back(std::move(line));
+        if (line.type != 0) {
+            lines.emplace_back(std::move(line));
+            line_adjustment_idxs.emplace_back(adjustment - per_extruder_adjustments.data());
+        }
     }
 
+    // All lines are parsed, pointers to them will not be invalidated anymore.
+    for (size_t i = 0; i < lines.size(); ++ i)
+        per_extruder_adjustments[line_adjustment_idxs[i]].lines.emplace_back(&lines[i]);
+
     return per_extruder_adjustments;
 }
 
@@ -652,8 +668,8 @@ static inline void extruder_range_slow_down_non_proportional(
         adj->idx_line_begin = 0;
         adj->idx_line_end   = 0;
         assert(adj->idx_line_begin < adj->n_lines_adjustable);
-        if (adj->lines[adj->idx_line_begin].feedrate > feedrate)
-            feedrate = adj->lines[adj->idx_line_begin].feedrate;
+        if (adj->lines[adj->idx_line_begin]->feedrate > feedrate)
+            feedrate = adj->lines[adj->idx_line_begin]->feedrate;
     }
     assert(feedrate > 0.f);
     // Sort by min_print_speed, maximum speed first.
@@ -664,14 +680,14 @@ static inline void extruder_range_slow_down_non_proportional(
         // For each extruder, find the span of lines with a feedrate close to feedrate.
         for (PerExtruderAdjustments *adj : by_min_print_speed) {
             for (adj->idx_line_end = adj->idx_line_begin;
-                adj->idx_line_end < adj->n_lines_adjustable && adj->lines[adj->idx_line_end].feedrate > feedrate - EPSILON;
+                adj->idx_line_end < adj->n_lines_adjustable && adj->lines[adj->idx_line_end]->feedrate > feedrate - EPSILON;
                  ++ adj->idx_line_end) ;
         }
         // Find the next highest adjustable feedrate among the extruders.
         float feedrate_next = 0.f;
         for (PerExtruderAdjustments *adj : by_min_print_speed)
-            if (adj->idx_line_end < adj->n_lines_adjustable && adj->lines[adj->idx_line_end].feedrate > feedrate_next)
-                feedrate_next = adj->lines[adj->idx_line_end].feedrate;
+            if (adj->idx_line_end < adj->n_lines_adjustable && adj->lines[adj->idx_line_end]->feedrate > feedrate_next)
+                feedrate_next = adj->lines[adj->idx_line_end]->feedrate;
         // Slow down, limited by max(feedrate_next, min_print_speed).
         for (auto adj = by_min_print_speed.begin(); adj != by_min_print_speed.end();) {
             // Slow down at most by time_stretch.
@@ -777,6 +793,32 @@ float CoolingBuffer::calculate_layer_slowdown(std::vector<PerExtruderAdjustments
     return elapsed_time_total0;
 }
 
+// Append a G-code comment to out, leaving out the ";_EXTRUDE_SET_SPEED" marker and optionally
+// the ";_EXTERNAL_PERIMETER" and ";_WIPE" markers.
+static void append_comment_without_markers(std::string &out, std::string_view comment, bool remove_external_perimeter, bool remove_wipe)
+{
+    auto starts_with = [](std::string_view str, std::string_view prefix) { return str.substr(0, prefix.size()) == prefix; };
+    for (size_t pos = 0;;) {
+        size_t next = comment.find(";_", pos);
+        if (next == std::string_view::npos) {
+            out.append(comment.data() + pos, comment.size() - pos);
+            break;
+        }
+        out.append(comment.data() + pos, next - pos);
+        std::string_view rest = comment.substr(next);
+        if (starts_with(rest, ";_EXTRUDE_SET_SPEED"))
+            pos = next + strlen(";_EXTRUDE_SET_SPEED");
+        else if (remove_external_perimeter && starts_with(rest, ";_EXTERNAL_PERIMETER"))
+            pos = next + strlen(";_EXTERNAL_PERIMETER");
+        else if (remove_wipe && starts_with(rest, ";_WIPE"))
+            pos = next + strlen(";_WIPE");
+        else {
+            out.append(";_");
+            pos = next + 2;
+        }
+    }
+}
+
 // Apply slow down over G-code lines stored in per_extruder_adjustments, enable fan if needed.
 // Returns the adjusted G-code.
 std::string CoolingBuffer::apply_layer_cooldown(
@@ -786,22 +828,10 @@ std::string CoolingBuffer::apply_layer_cooldown(
     size_t                                  layer_id, 
     // Total time of this layer after slow down, used to control the fan.
     float                                   layer_time,
-    // Per extruder list of G-code lines and their cool down attributes.
-    std::vector<PerExtruderAdjustments>    &per_extruder_adjustments)
+    // G-code lines of all extruders with their cool down attributes, in the G-code order.
+    const std::vector<CoolingLine>         &lines)
 {
-    // First sort the adjustment lines by of multiple extruders by their position in the source G-code.
-    std::vector<const CoolingLine*> lines;
-    {
-        size_t n_lines = 0;
-        for (const PerExtruderAdjustments &adj : per_extruder_adjustments)
-            n_lines += adj.lines.size();
-        lines.reserve(n_lines);
-        for (const PerExtruderAdjustments &adj : per_extruder_adjustments)
-            for (const CoolingLine &line : adj.lines)
-                lines.emplace_back(&line);
-        std::sort(lines.begin(), lines.end(), [](const CoolingLine *ln1, const CoolingLine *ln2) { return ln1->line_start < ln2->line_start; } );
-    }
-    // Second generate the adjusted G-code.
+    // Generate the adjusted G-code.
     std::string new_gcode;
     new_gcode.reserve(gcode.size() * 2);
     bool bridge_fan_control = false;
@@ -863,7 +893,8 @@ std::string CoolingBuffer::apply_layer_cooldown(
     const char         *pos               = gcode.c_str();
     int                 current_feedrate  = 0;
     std::pair<int,int> fan_speed_limits = change_extruder_set_fan();
-    for (const CoolingLine *line : lines) {
+    for (const CoolingLine &cooling_line : lines) {
+        const CoolingLine *line = &cooling_line;
         const char *line_start  = gcode.c_str() + line->line_start;
         const char *line_end    = gcode.c_str() + line->line_end;
         if (line_start > pos)
@@ -932,8 +963,7 @@ std::string CoolingBuffer::apply_layer_cooldown(
                     new_gcode.append(line_start, fpos - line_start);
                     current_feedrate = new_feedrate;
                     char buf[64];
-                    sprintf(buf, "%d", int(current_feedrate));
-                    new_gcode += buf;
+                    new_gcode.append(buf, std::to_chars(buf, buf + sizeof(buf), int(current_feedrate)).ptr);
                 } else {
                     // Remove the feedrate word.
                     const char *f = fpos;
@@ -958,13 +988,8 @@ std::string CoolingBuffer::apply_layer_cooldown(
             if (end < line_end) {
                 if (line->type & (CoolingLine::TYPE_ADJUSTABLE | CoolingLine::TYPE_ADJUSTABLE_EMPTY | CoolingLine::TYPE_EXTERNAL_PERIMETER | CoolingLine::TYPE_WIPE)) {
                     // Process comments, remove ";_EXTRUDE_SET_SPEED", ";_EXTERNAL_PERIMETER", ";_WIPE"
-                    std::string comment(end, line_end);
-                    boost::replace_all(comment, ";_EXTRUDE_SET_SPEED", "");
-                    if (line->type & CoolingLine::TYPE_EXTERNAL_PERIMETER)
-                        boost::replace_all(comment, ";_EXTERNAL_PERIMETER", "");
-                    if (line->type & CoolingLine::TYPE_WIPE)
-                        boost::replace_all(comment, ";_WIPE", "");
-                    new_gcode += comment;
+                    append_comment_without_markers(new_gcode, std::string_view(end, line_end - end),
+                        (line->type & CoolingLine::TYPE_EXTERNAL_PERIMETER) != 0, (line->type & CoolingLine::TYPE_WIPE) != 0);
                 } else {
                     // Just attach the rest of the source line.
                     new_gcode.append(end, line_end - end);
@@ -19,6 +19,7 @@ namespace Slic3r {
 
 class GCodeGenerator;
 class Layer;
+struct CoolingLine;
 struct PerExtruderAdjustments;
 
 // A standalone G-code filter, to control cooling of the print.
@@ -41,11 +42,11 @@ public:
 
 private:
 	CoolingBuffer& operator=(const CoolingBuffer&) = delete;
-    std::vector<PerExtruderAdjustments> parse_layer_gcode(const std::string &gcode, std::array<float, 5> &current_pos) const;
+    std::vector<PerExtruderAdjustments> parse_layer_gcode(const std::string &gcode, std::array<float, 5> &current_pos, std::vector<CoolingLine> &lines) const;
     float       calculate_layer_slowdown(std::vector<PerExtruderAdjustments> &per_extruder_adjustments);
-    // Apply slow down over G-code lines stored in per_extruder_adjustments, enable fan if needed.
+    // Apply slow down over G-code lines, enable fan if needed.
     // Returns the adjusted G-code.
-    std::string apply_layer_cooldown(const std::string &gcode, size_t layer_id, float layer_time, std::vector<PerExtruderAdjustments> &per_extruder_adjustments);
+    std::string apply_layer_cooldown(const std::string &gcode, size_t layer_id, float layer_time, const std::vector<CoolingLine> &lines);
 
     // G-code snippet cached for the support layers preceding an object layer.
     std::string                 m_gcode;
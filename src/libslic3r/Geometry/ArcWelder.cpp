@@ -34,7 +34,6 @@
 #include <numeric>
 #include <random>
 #include <boost/log/trivial.hpp>
-#include <boost/container/small_vector.hpp>
 
 namespace Slic3r { namespace Geometry { namespace ArcWelder {
 
@@ -94,6 +93,25 @@ static bool foot_pt_on_segment(const Point &p1, const Point &p2, const Point &pt
     return false;
 }
 
+// Annulus of points at most tolerance away from a circle.
+// Tests the squared distances from the circle center, thus it does not need a square root per point tested.
+struct CircleBand
+{
+    CircleBand(const Point &center, const double radius, const double tolerance) :
+        center(center.cast<int64_t>()),
+        r2min(radius > tolerance ? sqr(radius - tolerance) : 0.),
+        r2max(sqr(radius + tolerance)) {}
+
+    bool inside(const Point &pt) const {
+        double d2 = double((pt.cast<int64_t>() - this->center).squaredNorm());
+        return d2 >= this->r2min && d2 <= this->r2max;
+    }
+
+    Vec2i64 center;
+    double  r2min;
+    double  r2max;
+};
+
 static inline bool circle_approximation_sufficient(const Circle &circle, const Points::const_iterator begin, const Points::const_iterator end, const double tolerance)
 {
     // The circle was calculated from the 1st and last point of the point sequence, thus the fitting of those points does not need to be evaluated.
@@ -101,21 +119,18 @@ static inline bool circle_approximation_sufficient(const Circle &circle, const P
     assert(std::abs((*std::prev(end) - circle.center).cast<double>().norm() - circle.radius) < SCALED_EPSILON);
     assert(end - begin >= 3);
 
+    const CircleBand band(circle.center, circle.radius, tolerance);
+
     // Test the 1st point.
-    if (double distance_from_center = (*begin - circle.center).cast<double>().norm();
-        std::abs(distance_from_center - circle.radius) > tolerance)
+    if (! band.inside(*begin))
         return false;
 
     for (auto it = std::next(begin); it != end; ++ it) {
-        if (double distance_from_center = (*it - circle.center).cast<double>().norm();
-            std::abs(distance_from_center - circle.radius) > tolerance)
+        if (! band.inside(*it))
             return false;
         Point closest_point;
-        if (foot_pt_on_segment(*std::prev(it), *it, circle.center, closest_point)) {
-            if (double distance_from_center = (closest_point - circle.center).cast<double>().norm();
-                std::abs(distance_from_center - circle.radius) > tolerance)
-                return false;
-        }
+        if (foot_pt_on_segment(*std::prev(it), *it, circle.center, closest_point) && ! band.inside(closest_point))
+            return false;
     }
     return true;
 }
@@ -217,7 +232,28 @@ static inline int sign(const int64_t i)
     return i > 0 ? 1 : i < 0 ? -1 : 0;
 }
 
-static std::optional<Circle> try_create_circle(const Points::const_iterator begin, const Points::const_iterator end, const double max_radius, const double tolerance)
+// Scratch data of fit_path() shared by the arc fitting attempts over growing windows of the same source polyline.
+struct FitPathWorkspace
+{
+    FitPathWorkspace(const Points &src) : src_begin(src.begin()) {
+        // Prefix sums of the polyline lengths, so that the length of any window of the polyline is known in constant time.
+        lengths.reserve(src.size());
+        lengths.emplace_back(0.);
+        for (auto it = std::next(src.begin()); it != src.end(); ++ it)
+            lengths.emplace_back(lengths.back() + (*it - *std::prev(it)).cast<double>().norm());
+    }
+
+    // Length of the <begin, end) window of the source polyline.
+    double length(const Points::const_iterator begin, const Points::const_iterator end) const
+        { return lengths[end - 1 - src_begin] - lengths[begin - src_begin]; }
+
+    Points::const_iterator  src_begin;
+    std::vector<double>     lengths;
+    // Points to fit a circle to by least squares, reused between the fitting attempts.
+    std::vector<Vec2d>      fpts;
+};
+
+static std::optional<Circle> try_create_circle(const Points::const_iterator begin, const Points::const_iterator end, const double max_radius, const double tolerance, FitPathWorkspace &workspace)
 {
     std::optional<Circle> out;
     size_t size = end - begin;
@@ -310,7 +346,8 @@ static std::optional<Circle> try_create_circle(const Points::const_iterator begi
         if (circle) {
             // Fit the arc between the end points by least squares.
             // Optimize over all points along the path and the centers of the segments.
-            boost::container::small_vector<Vec2d, 16> fpts;
+            std::vector<Vec2d> &fpts = workspace.fpts;
+            fpts.clear();
             Vec2d first_point = begin->cast<double>();
             Vec2d last_point  = std::prev(end)->cast<double>();
             Vec2d prev_point  = first_point;            
@@ -321,8 +358,12 @@ static std::optional<Circle> try_create_circle(const Points::const_iterator begi
                 prev_point = this_point;
             }
             fpts.emplace_back(0.5 * (prev_point + last_point));
+            // The linearized (algebraic) fit needs no square roots and it is a much better initial solution of the Gauss-Newton method
+            // than the circle through three points, thus the Gauss-Newton method converges in fewer iterations.
+            Vec2d init_center = ArcWelder::arc_fit_center_algebraic_ls(first_point, last_point,
+                circle->center.cast<double>(), fpts.begin(), fpts.end());
             std::optional<Vec2d> opt_center = ArcWelder::arc_fit_center_gauss_newton_ls(first_point, last_point,
-                circle->center.cast<double>(), fpts.begin(), fpts.end(), 5);
+                init_center, fpts.begin(), fpts.end(), 5);
             if (opt_center) {
                 // Fitted radius must not be excessively large. If so, it is better to fit with a line segment.
                 if (const double r2 = (*opt_center - first_point).squaredNorm(); r2 < max_radius * max_radius) {
@@ -408,7 +449,8 @@ static inline std::optional<Arc> try_create_arc_impl(
     const Points::const_iterator begin,
     const Points::const_iterator end,
     const double                 tolerance,
-    const double                 path_tolerance_percent)
+    const double                 path_tolerance_percent,
+    const FitPathWorkspace      &workspace)
 {
     assert(end - begin >= 3);
     // Assumption: Two successive points of a single segment span an angle smaller than PI.
@@ -430,7 +472,7 @@ static inline std::optional<Arc> try_create_arc_impl(
     // but also could indicate that the vector calculation above
     // got wrong direction
     const double arc_length                     = circle.radius * angle;
-    const double approximate_length             = length(begin, end);
+    const double approximate_length             = workspace.length(begin, end);
     assert(approximate_length > 0);
     const double arc_length_difference_relative = (arc_length - approximate_length) / approximate_length;
 
@@ -451,14 +493,15 @@ static inline std::optional<Arc> try_create_arc_impl(
 static inline std::optional<Arc> try_create_arc(
     const Points::const_iterator begin,
     const Points::const_iterator end,
+    FitPathWorkspace            &workspace,
     double                       max_radius             = default_scaled_max_radius,
     double                       tolerance              = default_scaled_resolution,
     double                       path_tolerance_percent = default_arc_length_percent_tolerance)
 {
-    std::optional<Circle> circle = try_create_circle(begin, end, max_radius, tolerance);
+    std::optional<Circle> circle = try_create_circle(begin, end, max_radius, tolerance, workspace);
     if (! circle)
         return {};
-    return try_create_arc_impl(*circle, begin, end, tolerance, path_tolerance_percent);
+    return try_create_arc_impl(*circle, begin, end, tolerance, path_tolerance_percent, workspace);
 }
 
 float arc_angle(const Vec2f &start_pos, const Vec2f &end_pos, Vec2f &center_pos, bool is_ccw)
@@ -507,6 +550,7 @@ Path fit_path(const Points &src_in, double tolerance, double fit_circle_percent_
     } else {
         // Simplify the polyline first using a fine threshold.
         Points src = douglas_peucker(src_in, tolerance_fine);
+        FitPathWorkspace workspace(src);
         // Perform simplification & fitting.
         // Index of the start of a last polyline, which has not yet been decimated.
         int begin_pl_idx = 0;
@@ -520,7 +564,7 @@ Path fit_path(const Points &src_in, double tolerance, double fit_circle_percent_
             while (end != src.end()) {
                 auto next_end = std::next(end);
                 if (std::optional<Arc> this_arc = try_create_arc(
-                                                        begin, next_end,
+                                                        begin, next_end, workspace,
                                                         ArcWelder::default_scaled_max_radius,
                                                         tolerance, fit_circle_percent_tolerance);
                     this_arc) {
@@ -537,8 +581,10 @@ Path fit_path(const Points &src_in, double tolerance, double fit_circle_percent_
                         {
                             Vec2i64 v1 = arc->start_point.cast<int64_t>() - arc->center.cast<int64_t>();
                             Vec2i64 v2 = arc->end_point.cast<int64_t>() - arc->center.cast<int64_t>();
+                            const CircleBand band(arc->center, arc->radius, tolerance);
                             do {
-                                if (std::abs((arc->center.cast<double>() - next_end->cast<double>()).norm() - arc->radius) >= tolerance ||
+                                if (// Only arches shorter than PI (positive radius) are extended point by point.
+                                    arc->radius < 0 || ! band.inside(*next_end) ||
                                     inside_arc_wedge_vectors(v1, v2,
                                         arc->radius > 0, arc->direction == Orientation::CCW,
                                         next_end->cast<int64_t>() - arc->center.cast<int64_t>()))
@@ -554,7 +600,7 @@ Path fit_path(const Points &src_in, double tolerance, double fit_circle_percent_
                         auto last_tested_failed = src.begin();
                         for (;;) {
                             this_arc = try_create_arc(
-                                begin, next_end,
+                                begin, next_end, workspace,
                                 ArcWelder::default_scaled_max_radius,
                                 tolerance, fit_circle_percent_tolerance);
                             if (this_arc) {
@@ -267,7 +267,11 @@ inline std::optional<typename Eigen::Matrix<typename Derived::Scalar, 2, 1, Eige
         if (denom == 0)
             // Fitting diverged, the input points are likely nearly collinear with the arch end points.
             return std::optional<Vector>();
-        c_x -= num / denom;
+        Float step = num / denom;
+        c_x -= step;
+        if (std::abs(step) < Float(0.01))
+            // Converged well below the resolution of the scaled coordinates.
+            break;
     }
     // Transform the center back.
     return std::optional<Vector>(dir_x * c_x + dir_y * offset_y);
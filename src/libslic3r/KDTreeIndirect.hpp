@@ -80,6 +80,16 @@ public:
         visit_recursive(0, 0, visitor);
     }
 
+    // Closest point search. Visitor is called with a point index for each node visited and it is supposed to provide
+    // search_radius_squared() of the current candidates. The half space containing the point being searched for
+    // is visited first, the other half space is only visited if the search radius still reaches the splitting plane.
+    template<typename PointType, typename Visitor>
+    void visit_closest(const PointType &point, Visitor &visitor) const
+    {
+        if (! m_nodes.empty())
+            visit_closest_recursive(0, 0, point, visitor);
+    }
+
     CoordinateFn coordinate;
 
 private:
@@ -190,6 +200,25 @@ private:
         }
     }
 
+    template<typename PointType, typename Visitor>
+    void visit_closest_recursive(size_t node, size_t dimension, const PointType &point, Visitor &visitor) const
+    {
+        if (node >= m_nodes.size() || m_nodes[node] == npos)
+            return;
+
+        size_t idx = m_nodes[node];
+        visitor(idx);
+        CoordType dist           = CoordType(point[dimension]) - this->coordinate(idx, dimension);
+        size_t    next_dimension = (dimension + 1 == NumDimensions) ? 0 : dimension + 1;
+        // Left / right child node index.
+        size_t    left           = node * 2 + 1;
+        size_t    right          = left + 1;
+        visit_closest_recursive(dist > CoordType(0) ? right : left, next_dimension, point, visitor);
+        // Shrunk search radius of the candidates found in the first half space may not reach the other half space.
+        if (dist * dist < visitor.search_radius_squared() + CoordType(EPSILON))
+            visit_closest_recursive(dist > CoordType(0) ? left : right, next_dimension, point, visitor);
+    }
+
     std::vector<size_t> m_nodes;
 };
 
@@ -222,7 +251,9 @@ std::array<size_t, K> find_closest_points(
             results.fill(std::make_pair(Tree::npos,
                                         std::numeric_limits<CoordT>::max()));
         }
-        unsigned int operator()(size_t idx, size_t dimension)
+        CoordT search_radius_squared() const { return results.back().second; }
+
+        void operator()(size_t idx)
         {
             if (this->filter(idx)) {
                 auto dist = CoordT(0);
@@ -242,13 +273,10 @@ std::array<size_t, K> find_closest_points(
                     *it = res;
                 }
             }
-            return kdtree.descent_mask(point[dimension],
-                                       results.front().second, idx,
-                                       dimension);
         }
     } visitor(kdtree, point, filter);
 
-    kdtree.visit(visitor);
+    kdtree.visit_closest(point, visitor);
     std::array<size_t, K> ret;
     for (size_t i = 0; i < K; i++) ret[i] = visitor.results[i].first;
 
@@ -9,6 +9,7 @@
 #include <cstdint>
 #include <vector>
 #include <algorithm>
+#include <numeric>
 #include <cassert>
 
 namespace marchsq {
@@ -41,6 +42,11 @@ template<class T, class Enable = void> struct _RasterTraits {
     // Number of rows and cols of the raster
     static size_t rows(const T &raster);
     static size_t cols(const T &raster);
+
+    // Optional: pointer to the pixels of a row, stored continuously. Rasters
+    // of uint8_t pixels providing it are tagged row by row, which is a lot
+    // faster than sampling the raster cell by cell.
+    // static const uint8_t *row(const T &raster, size_t row);
 };
 
 // Specialize this to use parellel loops within the algorithm
@@ -71,6 +77,12 @@ template<class T> TRasterValue<T> isoval(const T &rst, const Coord &crd)
     return RasterTraits<T>::get(rst, crd.r, crd.c);
 }
 
+template<class T, class = void> struct HasRowAccess : std::false_type {};
+template<class T>
+struct HasRowAccess<T, std::void_t<decltype(RasterTraits<T>::row(
+                           std::declval<const T &>(), size_t(0)))>>
+    : std::is_same<TRasterValue<T>, uint8_t> {};
+
 template<class ExecutionPolicy, class It, class Fn>
 void for_each(ExecutionPolicy&& policy, It from, It to, Fn &&fn)
 {
@@ -207,13 +219,41 @@ template<class Rst> class Grid {
         return t == SquareTag::ac || t == SquareTag::bd;
     }
 
+    // Whether any of n squares from the given one is neither empty nor full.
+    // A loop without early exit, vectorized by the compiler.
+    bool has_contour(size_t from, size_t n) const
+    {
+        // The tags of the other squares are from 1 to 14.
+        static_assert(_t(SquareTag::none) == 0 && _t(SquareTag::full) == 15);
+
+        const uint8_t *tags = m_tags.data() + from;
+        uint8_t any = 0;
+        for (size_t i = 0; i < n; ++i)
+            any |= uint8_t((tags[i] & 0x0f) - 1) < 14;
+
+        return any;
+    }
+
     // Search for a new starting square
     size_t search_start_cell(size_t i = 0) const
     {
-        // Skip ambiguous tags as starting tags due to unknown previous
-        // direction.
-        while ((i < m_tags.size()) && (is_visited(i) || is_ambiguous(i))) ++i;
-        
+        // Most of the squares are empty or full, they are skipped in blocks.
+        static constexpr size_t Block = 32;
+
+        while (i < m_tags.size()) {
+            if (i + Block <= m_tags.size() && !has_contour(i, Block)) {
+                i += Block;
+                continue;
+            }
+
+            // Skip ambiguous tags as starting tags due to unknown previous
+            // direction.
+            size_t end = std::min(i + Block, m_tags.size());
+            for (; i < end; ++i)
+                if (!is_visited(i) && !is_ambiguous(i))
+                    return i;
+        }
+
         return i;
     }
     
@@ -345,7 +385,14 @@ public:
     // Go through the cells and mark them with the appropriate tag.
     template<class ExecutionPolicy>
     void tag_grid(ExecutionPolicy &&policy, TRasterValue<Rst> isoval)
-    {        
+    {
+        if constexpr (HasRowAccess<Rst>::value) {
+            if (m_window.r == m_res_1.r && m_window.c == m_res_1.c) {
+                tag_grid_rows(std::forward<ExecutionPolicy>(policy), isoval);
+                return;
+            }
+        }
+
         // parallel for r
         for_each (std::forward<ExecutionPolicy>(policy),
                  m_tags.begin(), m_tags.end(),
@@ -353,6 +400,59 @@ public:
             tag = get_tag_for_cell(coord(idx), isoval);
         });
     }
+
+    // Tagging of rasters with continuous rows of 8 bit pixels. The corners
+    // of a row of squares are compared with the isovalue into two rows of
+    // 0 or 1 samples, the tags are then combined from the neighbouring
+    // samples. Both steps are plain loops over whole rows, which the
+    // compiler vectorizes.
+    template<class ExecutionPolicy>
+    void tag_grid_rows(ExecutionPolicy &&policy, uint8_t isoval)
+    {
+        const long  R = rows(*m_rst), C = cols(*m_rst);
+        const long  scols = m_gridsize.c + 1;
+        const Coord win   = m_window;
+        const Rst & rst   = *m_rst;
+        uint8_t *   tags  = m_tags.data();
+
+        // Sample k, j is the raster pixel ((k - 1) * win.r, (j - 1) * win.c),
+        // zero if out of the raster.
+        auto sample_row = [&rst, win, scols, R, C, isoval](long k, uint8_t *smp) {
+            long r = (k - 1) * win.r;
+            if (r < 0 || r >= R)
+                return;
+
+            const uint8_t *px = RasterTraits<Rst>::row(rst, size_t(r));
+            const long     n  = std::min(scols - 1, 1 + (C - 1) / win.c);
+
+            ++smp;
+            if (win.c == 1)
+                for (long j = 0; j < n; ++j)
+                    smp[j] = px[j] >= isoval;
+            else
+                for (long j = 0; j < n; ++j)
+                    smp[j] = px[j * win.c] >= isoval;
+        };
+
+        std::vector<long> ids(m_gridsize.r);
+        std::iota(ids.begin(), ids.end(), 0l);
+
+        // parallel for r
+        for_each(std::forward<ExecutionPolicy>(policy), ids.begin(), ids.end(),
+                 [&sample_row, tags, scols](long r, size_t) {
+            // Square r, c has the samples r, c and r + 1, c + 1 in its
+            // top left and bottom right corner.
+            std::vector<uint8_t> samples(2 * scols, 0);
+            const uint8_t *top = samples.data(), *bottom = top + scols;
+            sample_row(r, samples.data());
+            sample_row(r + 1, samples.data() + scols);
+
+            uint8_t *row = tags + r * (scols - 1);
+            for (long c = 0; c < scols - 1; ++c)
+                row[c] = bottom[c] | (bottom[c + 1] << 1) |
+                         (top[c + 1] << 2) | (top[c] << 3);
+        });
+    }
     
     // Scan for the rings on the tagged grid. Each ring vertex stores the
     // sequential index of the cell and the next direction (Dir).
@@ -442,10 +542,99 @@ std::vector<marchsq::Ring> execute(const Raster &raster,
     return execute_with_policy(nullptr, raster, isoval, windowsize);
 }
 
+// Rectangular part of a raster, from the origin with the given size
+template<class Raster> struct RasterRegion {
+    const Raster *raster = nullptr;
+    Coord origin, size;
+};
+
+} // namespace __impl
+
+template<class Raster> struct _RasterTraits<__impl::RasterRegion<Raster>> {
+    using Rst = __impl::RasterRegion<Raster>;
+    using ValueType = __impl::TRasterValue<Raster>;
+
+    static ValueType get(const Rst &rst, size_t row, size_t col)
+    {
+        return __impl::RasterTraits<Raster>::get(*rst.raster,
+                                                 rst.origin.r + row,
+                                                 rst.origin.c + col);
+    }
+
+    static size_t rows(const Rst &rst) { return rst.size.r; }
+    static size_t cols(const Rst &rst) { return rst.size.c; }
+
+    template<class R = Raster>
+    static auto row(const Rst &rst, size_t r)
+        -> decltype(__impl::RasterTraits<R>::row(*rst.raster, r))
+    {
+        return __impl::RasterTraits<R>::row(*rst.raster, rst.origin.r + r) +
+               rst.origin.c;
+    }
+};
+
+namespace __impl {
+
+// Same rings as with execute_with_policy() on the whole raster, but only the
+// squares around the rows [from.r, to.r) and columns [from.c, to.c) of the
+// raster are processed. Every pixel outside of this region must be below the
+// isovalue.
+template<class Raster, class ExecutionPolicy>
+std::vector<marchsq::Ring> execute_in_region_with_policy(
+    ExecutionPolicy &&   policy,
+    const Raster &       raster,
+    TRasterValue<Raster> isoval,
+    Coord                from,
+    Coord                to,
+    Coord                windowsize = {})
+{
+    const long R = rows(raster), C = cols(raster);
+    if (!R || !C || from.r >= to.r || from.c >= to.c) return {};
+
+    size_t ratio = cols(raster) / rows(raster);
+
+    if (!windowsize.r) windowsize.r = 2;
+    if (!windowsize.c)
+        windowsize.c = std::max(2l, long(windowsize.r * ratio));
+
+    // The region is aligned to the squares of the whole raster and extended
+    // so that the edges of the squares at its boundary are not clipped any
+    // differently than in the whole raster.
+    Coord step{windowsize.r - 1, windowsize.c - 1};
+    Coord origin{std::max(0l, (from.r / step.r - 2) * step.r),
+                 std::max(0l, (from.c / step.c - 2) * step.c)};
+    Coord end{std::min(R, to.r + step.r + 2), std::min(C, to.c + step.c + 2)};
+
+    RasterRegion<Raster> region{&raster, origin,
+                                {end.r - origin.r, end.c - origin.c}};
+
+    std::vector<marchsq::Ring> rings =
+        execute_with_policy(std::forward<ExecutionPolicy>(policy), region,
+                            isoval, windowsize);
+
+    for (Ring &ring : rings)
+        for (Coord &crd : ring) crd += origin;
+
+    return rings;
+}
+
+template<class Raster>
+std::vector<marchsq::Ring> execute_in_region(const Raster &       raster,
+                                             TRasterValue<Raster> isoval,
+                                             const Coord &        from,
+                                             const Coord &        to,
+                                             Coord windowsize = {})
+{
+    return execute_in_region_with_policy(nullptr, raster, isoval, from, to,
+                                         windowsize);
+}
+
 } // namespace __impl
 
 using __impl::execute_with_policy;
 using __impl::execute;
+using __impl::execute_in_region_with_policy;
+using __impl::execute_in_region;
 
 } // namespace marchsq
 
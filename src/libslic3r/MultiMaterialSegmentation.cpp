@@ -9,16 +9,17 @@
 #include "Print.hpp"
 #include "Geometry/VoronoiVisualUtils.hpp"
 #include "MutablePolygon.hpp"
+#include "Timer.hpp"
 #include "format.hpp"
 
+#include <atomic>
 #include <utility>
 #include <cfloat>
 #include <unordered_set>
 
 #include <boost/log/trivial.hpp>
 #include <tbb/parallel_for.h>
-#include <mutex>
-#include <boost/thread/lock_guard.hpp>
+#include <tbb/enumerable_thread_specific.h>
 
 namespace Slic3r {
 struct ColoredLine {
@@ -85,9 +86,10 @@ struct PaintedLine
     int    color;
 };
 
+// Collects painted lines of a single layer. Each layer is processed by a single thread, thus no locking is needed.
 struct PaintedLineVisitor
 {
-    PaintedLineVisitor(const EdgeGrid::Grid &grid, std::vector<PaintedLine> &painted_lines, std::mutex &painted_lines_mutex, size_t reserve) : grid(grid), painted_lines(painted_lines), painted_lines_mutex(painted_lines_mutex)
+    PaintedLineVisitor(const EdgeGrid::Grid &grid, std::vector<PaintedLine> &painted_lines, size_t reserve) : grid(grid), painted_lines(painted_lines)
     {
         painted_lines_set.reserve(reserve);
     }
@@ -129,10 +131,7 @@ struct PaintedLineVisitor
                             line_to_test_projected.reverse();
 
                         painted_lines_set.insert(*it_contour_and_segment);
-                        {
-                            boost::lock_guard<std::mutex> lock(painted_lines_mutex);
-                            painted_lines.push_back({it_contour_and_segment->first, it_contour_and_segment->second, line_to_test_projected, this->color});
-                        }
+                        painted_lines.push_back({it_contour_and_segment->first, it_contour_and_segment->second, line_to_test_projected, this->color});
                     }
                 }
             }
@@ -143,7 +142,6 @@ struct PaintedLineVisitor
 
     const EdgeGrid::Grid                                                                 &grid;
     std::vector<PaintedLine>                                                             &painted_lines;
-    std::mutex                                                                           &painted_lines_mutex;
     Line                                                                                  line_to_test;
     std::unordered_set<std::pair<size_t, size_t>, boost::hash<std::pair<size_t, size_t>>> painted_lines_set;
     int                                                                                   color             = -1;
@@ -882,9 +880,17 @@ static inline Line clip_finite_voronoi_edge(const Voronoi::VD::edge_type &edge,
     return {v0.cast<coord_t>(), v1.cast<coord_t>()};
 }
 
-static MMU_Graph build_graph(size_t layer_idx, const std::vector<std::vector<ColoredLine>> &color_poly)
+// Buffers reused by the segmentation of layers processed by the same thread.
+struct MMUSegmentationWorkspace
+{
+    Geometry::VoronoiDiagram                     vd;
+    boost::polygon::default_voronoi_builder      vd_builder;
+    std::vector<Voronoi::Internal::segment_type> segments;
+};
+
+static MMU_Graph build_graph(size_t layer_idx, const std::vector<std::vector<ColoredLine>> &color_poly, MMUSegmentationWorkspace &workspace)
 {
-    Geometry::VoronoiDiagram vd;
+    Geometry::VoronoiDiagram &vd            = workspace.vd;
     std::vector<ColoredLine> lines_colored  = to_lines(color_poly);
     const Polygons           color_poly_tmp = colored_points_to_polygon(color_poly);
     const Points             points         = to_points(color_poly_tmp);
@@ -908,7 +914,11 @@ static MMU_Graph build_graph(size_t layer_idx, const std::vector<std::vector<Col
         force_edge_adding[&c_poly - &color_poly.front()] = force_edge;
     }
 
-    boost::polygon::construct_voronoi(lines_colored.begin(), lines_colored.end(), &vd);
+    // Equivalent to boost::polygon::construct_voronoi(), reusing the memory allocated by the previous layers.
+    vd.clear();
+    workspace.vd_builder.clear();
+    boost::polygon::insert(lines_colored.begin(), lines_colored.end(), &workspace.vd_builder);
+    workspace.vd_builder.construct(&vd);
     MMU_Graph graph;
     graph.nodes.reserve(points.size() + vd.vertices().size());
     for (const Point &point : points)
@@ -942,7 +952,8 @@ static MMU_Graph build_graph(size_t layer_idx, const std::vector<std::vector<Col
     const double       bbox_dim_max = double(std::max(bbox.size().x(), bbox.size().y()));
 
     // Make a copy of the input segments with the double type.
-    std::vector<Voronoi::Internal::segment_type> segments;
+    std::vector<Voronoi::Internal::segment_type> &segments = workspace.segments;
+    segments.clear();
     for (const Line &line : lines)
         segments.emplace_back(Voronoi::Internal::point_type(double(line.a(0)), double(line.a(1))),
                               Voronoi::Internal::point_type(double(line.b(0)), double(line.b(1))));
@@ -1691,6 +1702,132 @@ static bool has_layer_only_one_color(const std::vector<std::vector<ColoredLine>>
     return true;
 }
 
+// Time spent in the individual stages of the MMU segmentation in nanoseconds, summed over all threads.
+struct MMUSegmentationTimings
+{
+    std::atomic<uint64_t> slices_preparation          { 0 };
+    std::atomic<uint64_t> edge_grids                  { 0 };
+    std::atomic<uint64_t> painted_facets_index        { 0 };
+    std::atomic<uint64_t> painted_lines_projection    { 0 };
+    std::atomic<uint64_t> painted_lines_processing    { 0 };
+    std::atomic<uint64_t> contours_colorization       { 0 };
+    std::atomic<uint64_t> voronoi_graph               { 0 };
+    std::atomic<uint64_t> colored_segments_extraction { 0 };
+    std::atomic<uint64_t> cutting                     { 0 };
+    std::atomic<uint64_t> top_and_bottom_layers       { 0 };
+    std::atomic<uint64_t> merging                     { 0 };
+
+    // Adds the time elapsed since the last call (or since the timer was started) to the counter.
+    static void lap(Timing::Timer &timer, std::atomic<uint64_t> &counter) {
+        counter += timer.elapsed_nanoseconds();
+        timer.start();
+    }
+
+    void log() const {
+        auto ms = [](const std::atomic<uint64_t> &counter) { return double(counter.load()) / 1000000.; };
+        BOOST_LOG_TRIVIAL(debug) << "MMU segmentation - time spent in stages summed over threads [ms]:"
+                                 << " slices preparation: "          << ms(slices_preparation)
+                                 << ", edge grids: "                 << ms(edge_grids)
+                                 << ", painted facets index: "       << ms(painted_facets_index)
+                                 << ", painted lines projection: "   << ms(painted_lines_projection)
+                                 << ", painted lines processing: "   << ms(painted_lines_processing)
+                                 << ", contours colorization: "      << ms(contours_colorization)
+                                 << ", Voronoi graph: "              << ms(voronoi_graph)
+                                 << ", colored segments extraction: " << ms(colored_segments_extraction)
+                                 << ", cutting: "                    << ms(cutting)
+                                 << ", top and bottom layers: "      << ms(top_and_bottom_layers)
+                                 << ", merging: "                    << ms(merging);
+    }
+};
+
+// Painted triangle transformed into the coordinate system of the print object with vertices sorted by the z-axis.
+struct PaintedFacet
+{
+    std::array<Vec3f, 3> vertices;
+    int                  color;
+    // Range of layers [first_layer_idx, last_layer_idx) the facet may intersect.
+    uint32_t             first_layer_idx;
+    uint32_t             last_layer_idx;
+};
+
+// Collect painted facets of all model parts of the print object together with the range of layers each facet may intersect.
+static std::vector<PaintedFacet> collect_painted_facets(const PrintObject &print_object, const std::vector<coordf_t> &layers_slice_z, const size_t num_extruders, const std::function<void()> &throw_on_cancel_callback)
+{
+    std::vector<PaintedFacet> painted_facets;
+    for (const ModelVolume *mv : print_object.model_object()->volumes) {
+        if (!mv->is_model_part())
+            continue;
+
+        std::vector<std::vector<PaintedFacet>> painted_facets_by_extruder(num_extruders + 1);
+        const Transform3f                      tr = print_object.trafo().cast<float>() * mv->get_matrix().cast<float>();
+        tbb::parallel_for(tbb::blocked_range<size_t>(1, num_extruders + 1), [&mv, &tr, &layers_slice_z, &painted_facets_by_extruder, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+            for (size_t extruder_idx = range.begin(); extruder_idx < range.end(); ++extruder_idx) {
+                throw_on_cancel_callback();
+                const indexed_triangle_set custom_facets = mv->mmu_segmentation_facets.get_facets(*mv, EnforcerBlockerType(extruder_idx));
+                if (custom_facets.indices.empty())
+                    continue;
+
+                std::vector<PaintedFacet> &out = painted_facets_by_extruder[extruder_idx];
+                out.resize(custom_facets.indices.size());
+                tbb::parallel_for(tbb::blocked_range<size_t>(0, custom_facets.indices.size()), [&tr, &custom_facets, &layers_slice_z, &out, &extruder_idx](const tbb::blocked_range<size_t> &range) {
+                    for (size_t facet_idx = range.begin(); facet_idx < range.end(); ++facet_idx) {
+                        PaintedFacet &facet = out[facet_idx];
+                        facet.color = int(extruder_idx);
+                        for (int p_idx = 0; p_idx < 3; ++p_idx)
+                            facet.vertices[p_idx] = tr * custom_facets.vertices[custom_facets.indices[facet_idx](p_idx)];
+
+                        // Sort the vertices by z-axis for simplification of projected_facet on slices
+                        std::sort(facet.vertices.begin(), facet.vertices.end(), [](const Vec3f &p1, const Vec3f &p2) { return p1.z() < p2.z(); });
+
+                        // Find lowest slice not below the triangle and the first slice above the triangle.
+                        const float min_z     = facet.vertices.front().z();
+                        const float max_z     = facet.vertices.back().z();
+                        facet.first_layer_idx = uint32_t(std::upper_bound(layers_slice_z.begin(), layers_slice_z.end(), float(min_z - EPSILON)) - layers_slice_z.begin());
+                        facet.last_layer_idx  = uint32_t(std::upper_bound(layers_slice_z.begin(), layers_slice_z.end(), float(max_z + EPSILON)) - layers_slice_z.begin());
+                    }
+                }); // end of parallel_for
+            }
+        }); // end of parallel_for
+
+        for (std::vector<PaintedFacet> &facets : painted_facets_by_extruder)
+            for (const PaintedFacet &facet : facets)
+                if (facet.first_layer_idx < facet.last_layer_idx)
+                    painted_facets.emplace_back(facet);
+    }
+    return painted_facets;
+}
+
+// For each layer, indices of painted facets intersecting this layer, stored compactly:
+// Facets of the i-th layer are facet_idxs[layer_begin[i]] to facet_idxs[layer_begin[i + 1] - 1].
+struct PaintedFacetsLayerIndex
+{
+    std::vector<size_t>   layer_begin;
+    std::vector<uint32_t> facet_idxs;
+
+    PaintedFacetsLayerIndex(const std::vector<PaintedFacet> &painted_facets, const size_t num_layers) : layer_begin(num_layers + 1, 0)
+    {
+        // Count the facets starting and ending at each layer, then accumulate the counts to get the number of facets per layer.
+        std::vector<int64_t> delta(num_layers + 1, 0);
+        for (const PaintedFacet &facet : painted_facets) {
+            ++ delta[facet.first_layer_idx];
+            -- delta[facet.last_layer_idx];
+        }
+        int64_t num_facets = 0;
+        for (size_t layer_idx = 0; layer_idx < num_layers; ++ layer_idx) {
+            num_facets += delta[layer_idx];
+            layer_begin[layer_idx + 1] = layer_begin[layer_idx] + size_t(num_facets);
+        }
+
+        facet_idxs.assign(layer_begin.back(), 0);
+        std::vector<size_t> layer_end(layer_begin.begin(), layer_begin.end() - 1);
+        for (const PaintedFacet &facet : painted_facets)
+            for (uint32_t layer_idx = facet.first_layer_idx; layer_idx < facet.last_layer_idx; ++ layer_idx)
+                facet_idxs[layer_end[layer_idx] ++] = uint32_t(&facet - painted_facets.data());
+    }
+
+    size_t num_facets(size_t layer_idx) const { return layer_begin[layer_idx + 1] - layer_begin[layer_idx]; }
+};
+
 std::vector<std::vector<ExPolygons>> multi_material_segmentation_by_painting(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback)
 {
     const size_t                          num_extruders = print_object.print()->config().nozzle_diameter.size();
@@ -1698,12 +1835,14 @@ std::vector<std::vector<ExPolygons>> multi_material_segmentation_by_painting(con
     std::vector<std::vector<ExPolygons>>  segmented_regions(num_layers);
     segmented_regions.assign(num_layers, std::vector<ExPolygons>(num_extruders + 1));
     std::vector<std::vector<PaintedLine>> painted_lines(num_layers);
-    std::array<std::mutex, 64>            painted_lines_mutex;
     std::vector<EdgeGrid::Grid>           edge_grids(num_layers);
     const SpanOfConstPtrs<Layer>          layers = print_object.layers();
     std::vector<ExPolygons>               input_expolygons(num_layers);
+    MMUSegmentationTimings                timings;
+    Timing::Timer                         timer;
 
     throw_on_cancel_callback();
+    timer.start();
 
     // Merge all regions and remove small holes
     BOOST_LOG_TRIVIAL(debug) << "MMU segmentation - slices preparation in parallel - begin";
@@ -1737,118 +1876,113 @@ std::vector<std::vector<ExPolygons>> multi_material_segmentation_by_painting(con
         }
     }); // end of parallel_for
     BOOST_LOG_TRIVIAL(debug) << "MMU segmentation - slices preparation in parallel - end";
+    MMUSegmentationTimings::lap(timer, timings.slices_preparation);
 
     std::vector<BoundingBox> layer_bboxes(num_layers);
-    for (size_t layer_idx = 0; layer_idx < num_layers; ++layer_idx) {
-        throw_on_cancel_callback();
-        layer_bboxes[layer_idx] = get_extents(layers[layer_idx]->regions());
-        layer_bboxes[layer_idx].merge(get_extents(input_expolygons[layer_idx]));
-    }
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers), [&layers, &input_expolygons, &layer_bboxes, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+        for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++layer_idx) {
+            throw_on_cancel_callback();
+            layer_bboxes[layer_idx] = get_extents(layers[layer_idx]->regions());
+            layer_bboxes[layer_idx].merge(get_extents(input_expolygons[layer_idx]));
+        }
+    }); // end of parallel_for
 
-    for (size_t layer_idx = 0; layer_idx < num_layers; ++layer_idx) {
-        throw_on_cancel_callback();
-        BoundingBox bbox = layer_bboxes[layer_idx];
-        // Projected triangles could, in rare cases (as in GH issue #7299), belongs to polygons printed in the previous or the next layer.
-        // Let's merge the bounding box of the current layer with bounding boxes of the previous and the next layer to ensure that
-        // every projected triangle will be inside the resulting bounding box.
-        if (layer_idx > 1) bbox.merge(layer_bboxes[layer_idx - 1]);
-        if (layer_idx < num_layers - 1) bbox.merge(layer_bboxes[layer_idx + 1]);
-        // Projected triangles may slightly exceed the input polygons.
-        bbox.offset(20 * SCALED_EPSILON);
-        edge_grids[layer_idx].set_bbox(bbox);
-        edge_grids[layer_idx].create(input_expolygons[layer_idx], coord_t(scale_(10.)));
-    }
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers), [&layer_bboxes, &input_expolygons, &edge_grids, &num_layers, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+        for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++layer_idx) {
+            throw_on_cancel_callback();
+            BoundingBox bbox = layer_bboxes[layer_idx];
+            // Projected triangles could, in rare cases (as in GH issue #7299), belongs to polygons printed in the previous or the next layer.
+            // Let's merge the bounding box of the current layer with bounding boxes of the previous and the next layer to ensure that
+            // every projected triangle will be inside the resulting bounding box.
+            if (layer_idx > 1) bbox.merge(layer_bboxes[layer_idx - 1]);
+            if (layer_idx < num_layers - 1) bbox.merge(layer_bboxes[layer_idx + 1]);
+            // Projected triangles may slightly exceed the input polygons.
+            bbox.offset(20 * SCALED_EPSILON);
+            edge_grids[layer_idx].set_bbox(bbox);
+            edge_grids[layer_idx].create(input_expolygons[layer_idx], coord_t(scale_(10.)));
+        }
+    }); // end of parallel_for
+    MMUSegmentationTimings::lap(timer, timings.edge_grids);
 
     BOOST_LOG_TRIVIAL(debug) << "MMU segmentation - projection of painted triangles - begin";
-    for (const ModelVolume *mv : print_object.model_object()->volumes) {
-        tbb::parallel_for(tbb::blocked_range<size_t>(1, num_extruders + 1), [&mv, &print_object, &layers, &edge_grids, &painted_lines, &painted_lines_mutex, &input_expolygons, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
-            for (size_t extruder_idx = range.begin(); extruder_idx < range.end(); ++extruder_idx) {
-                throw_on_cancel_callback();
-                const indexed_triangle_set custom_facets = mv->mmu_segmentation_facets.get_facets(*mv, EnforcerBlockerType(extruder_idx));
-                if (!mv->is_model_part() || custom_facets.indices.empty())
-                    continue;
+    std::vector<coordf_t> layers_slice_z(num_layers);
+    for (size_t layer_idx = 0; layer_idx < num_layers; ++layer_idx)
+        layers_slice_z[layer_idx] = layers[layer_idx]->slice_z;
+
+    // Painted facets are bucketed by the layers they intersect, so that each layer is projected by a single task without any locking.
+    const std::vector<PaintedFacet> painted_facets = collect_painted_facets(print_object, layers_slice_z, num_extruders, throw_on_cancel_callback);
+    const PaintedFacetsLayerIndex   painted_facets_index(painted_facets, num_layers);
+    MMUSegmentationTimings::lap(timer, timings.painted_facets_index);
+
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers), [&print_object, &layers_slice_z, &edge_grids, &input_expolygons, &painted_lines, &painted_facets, &painted_facets_index, &timings, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+        Timing::Timer timer;
+        timer.start();
+        for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++layer_idx) {
+            throw_on_cancel_callback();
+            if (input_expolygons[layer_idx].empty() || painted_facets_index.num_facets(layer_idx) == 0)
+                continue;
 
-                const Transform3f tr = print_object.trafo().cast<float>() * mv->get_matrix().cast<float>();
-                tbb::parallel_for(tbb::blocked_range<size_t>(0, custom_facets.indices.size()), [&tr, &custom_facets, &print_object, &layers, &edge_grids, &input_expolygons, &painted_lines, &painted_lines_mutex, &extruder_idx](const tbb::blocked_range<size_t> &range) {
-                    for (size_t facet_idx = range.begin(); facet_idx < range.end(); ++facet_idx) {
-                        float min_z = std::numeric_limits<float>::max();
-                        float max_z = std::numeric_limits<float>::lowest();
-
-                        std::array<Vec3f, 3> facet;
-                        for (int p_idx = 0; p_idx < 3; ++p_idx) {
-                            facet[p_idx] = tr * custom_facets.vertices[custom_facets.indices[facet_idx](p_idx)];
-                            max_z        = std::max(max_z, facet[p_idx].z());
-                            min_z        = std::min(min_z, facet[p_idx].z());
-                        }
+            const coordf_t     slice_z        = layers_slice_z[layer_idx];
+            const BoundingBox &edge_grid_bbox = edge_grids[layer_idx].bbox();
+            PaintedLineVisitor visitor(edge_grids[layer_idx], painted_lines[layer_idx], 16);
+            for (size_t idx = painted_facets_index.layer_begin[layer_idx]; idx < painted_facets_index.layer_begin[layer_idx + 1]; ++idx) {
+                const PaintedFacet         &painted_facet = painted_facets[painted_facets_index.facet_idxs[idx]];
+                const std::array<Vec3f, 3> &facet         = painted_facet.vertices;
+                if (facet[0].z() > slice_z || slice_z > facet[2].z())
+                    continue;
 
-                        // Sort the vertices by z-axis for simplification of projected_facet on slices
-                        std::sort(facet.begin(), facet.end(), [](const Vec3f &p1, const Vec3f &p2) { return p1.z() < p2.z(); });
-
-                        // Find lowest slice not below the triangle.
-                        auto first_layer = std::upper_bound(layers.begin(), layers.end(), float(min_z - EPSILON),
-                                                            [](float z, const Layer *l1) { return z < l1->slice_z; });
-                        auto last_layer  = std::upper_bound(layers.begin(), layers.end(), float(max_z + EPSILON),
-                                                           [](float z, const Layer *l1) { return z < l1->slice_z; });
-                        --last_layer;
-
-                        for (auto layer_it = first_layer; layer_it != (last_layer + 1); ++layer_it) {
-                            const Layer *layer     = *layer_it;
-                            size_t       layer_idx = layer_it - layers.begin();
-                            if (input_expolygons[layer_idx].empty() || facet[0].z() > layer->slice_z || layer->slice_z > facet[2].z())
-                                continue;
-
-                            // https://kandepet.com/3d-printing-slicing-3d-objects/
-                            float t            = (float(layer->slice_z) - facet[0].z()) / (facet[2].z() - facet[0].z());
-                            Vec3f line_start_f = facet[0] + t * (facet[2] - facet[0]);
-                            Vec3f line_end_f;
-
-                            if (facet[1].z() > layer->slice_z) {
-                                // [P0, P2] and [P0, P1]
-                                float t1   = (float(layer->slice_z) - facet[0].z()) / (facet[1].z() - facet[0].z());
-                                line_end_f = facet[0] + t1 * (facet[1] - facet[0]);
-                            } else {
-                                // [P0, P2] and [P1, P2]
-                                float t2   = (float(layer->slice_z) - facet[1].z()) / (facet[2].z() - facet[1].z());
-                                line_end_f = facet[1] + t2 * (facet[2] - facet[1]);
-                            }
+                // https://kandepet.com/3d-printing-slicing-3d-objects/
+                float t            = (float(slice_z) - facet[0].z()) / (facet[2].z() - facet[0].z());
+                Vec3f line_start_f = facet[0] + t * (facet[2] - facet[0]);
+                Vec3f line_end_f;
 
-                            Line line_to_test(Point(scale_(line_start_f.x()), scale_(line_start_f.y())),
-                                              Point(scale_(line_end_f.x()), scale_(line_end_f.y())));
-                            line_to_test.translate(-print_object.center_offset());
-
-                            // BoundingBoxes for EdgeGrids are computed from printable regions. It is possible that the painted line (line_to_test) could
-                            // be outside EdgeGrid's BoundingBox, for example, when the negative volume is used on the painted area (GH #7618).
-                            // To ensure that the painted line is always inside EdgeGrid's BoundingBox, it is clipped by EdgeGrid's BoundingBox in cases
-                            // when any of the endpoints of the line are outside the EdgeGrid's BoundingBox.
-                            if (const BoundingBox &edge_grid_bbox = edge_grids[layer_idx].bbox(); !edge_grid_bbox.contains(line_to_test.a) || !edge_grid_bbox.contains(line_to_test.b)) {
-                                // If the painted line (line_to_test) is entirely outside EdgeGrid's BoundingBox, skip this painted line.
-                                if (!edge_grid_bbox.overlap(BoundingBox(Points{line_to_test.a, line_to_test.b})) ||
-                                    !line_to_test.clip_with_bbox(edge_grid_bbox))
-                                    continue;
-                            }
+                if (facet[1].z() > slice_z) {
+                    // [P0, P2] and [P0, P1]
+                    float t1   = (float(slice_z) - facet[0].z()) / (facet[1].z() - facet[0].z());
+                    line_end_f = facet[0] + t1 * (facet[1] - facet[0]);
+                } else {
+                    // [P0, P2] and [P1, P2]
+                    float t2   = (float(slice_z) - facet[1].z()) / (facet[2].z() - facet[1].z());
+                    line_end_f = facet[1] + t2 * (facet[2] - facet[1]);
+                }
 
-                            size_t mutex_idx = layer_idx & 0x3F;
-                            assert(mutex_idx < painted_lines_mutex.size());
+                Line line_to_test(Point(scale_(line_start_f.x()), scale_(line_start_f.y())),
+                                  Point(scale_(line_end_f.x()), scale_(line_end_f.y())));
+                line_to_test.translate(-print_object.center_offset());
+
+                // BoundingBoxes for EdgeGrids are computed from printable regions. It is possible that the painted line (line_to_test) could
+                // be outside EdgeGrid's BoundingBox, for example, when the negative volume is used on the painted area (GH #7618).
+                // To ensure that the painted line is always inside EdgeGrid's BoundingBox, it is clipped by EdgeGrid's BoundingBox in cases
+                // when any of the endpoints of the line are outside the EdgeGrid's BoundingBox.
+                if (!edge_grid_bbox.contains(line_to_test.a) || !edge_grid_bbox.contains(line_to_test.b)) {
+                    // If the painted line (line_to_test) is entirely outside EdgeGrid's BoundingBox, skip this painted line.
+                    if (!edge_grid_bbox.overlap(BoundingBox(Points{line_to_test.a, line_to_test.b})) ||
+                        !line_to_test.clip_with_bbox(edge_grid_bbox))
+                        continue;
+                }
 
-                            PaintedLineVisitor visitor(edge_grids[layer_idx], painted_lines[layer_idx], painted_lines_mutex[mutex_idx], 16);
-                            visitor.line_to_test = line_to_test;
-                            visitor.color        = int(extruder_idx);
-                            edge_grids[layer_idx].visit_cells_intersecting_line(line_to_test.a, line_to_test.b, visitor);
-                        }
-                    }
-                }); // end of parallel_for
+                visitor.reset();
+                visitor.line_to_test = line_to_test;
+                visitor.color        = painted_facet.color;
+                edge_grids[layer_idx].visit_cells_intersecting_line(line_to_test.a, line_to_test.b, visitor);
             }
-        }); // end of parallel_for
-    }
+        }
+        MMUSegmentationTimings::lap(timer, timings.painted_lines_projection);
+    }); // end of parallel_for
     BOOST_LOG_TRIVIAL(debug) << "MMU segmentation - projection of painted triangles - end";
     BOOST_LOG_TRIVIAL(debug) << "MMU segmentation - painted layers count: "
                              << std::count_if(painted_lines.begin(), painted_lines.end(), [](const std::vector<PaintedLine> &pl) { return !pl.empty(); });
+    throw_on_cancel_callback();
 
     BOOST_LOG_TRIVIAL(debug) << "MMU segmentation - layers segmentation in parallel - begin";
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers), [&edge_grids, &input_expolygons, &painted_lines, &segmented_regions, &num_extruders, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+    tbb::enumerable_thread_specific<MMUSegmentationWorkspace> workspaces;
+    // Layers differ a lot in the complexity of their segmentation, thus each layer is processed as a separate task.
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers, 1), [&edge_grids, &input_expolygons, &painted_lines, &segmented_regions, &num_extruders, &workspaces, &timings, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
         for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++layer_idx) {
             throw_on_cancel_callback();
             if (!painted_lines[layer_idx].empty()) {
+                Timing::Timer timer;
+                timer.start();
 #ifdef MMU_SEGMENTATION_DEBUG_PAINTED_LINES
                 {
                     static int iRun = 0;
@@ -1857,6 +1991,7 @@ std::vector<std::vector<ExPolygons>> multi_material_segmentation_by_painting(con
 #endif // MMU_SEGMENTATION_DEBUG_PAINTED_LINES
 
                 std::vector<std::vector<PaintedLine>> post_processed_painted_lines = post_process_painted_lines(edge_grids[layer_idx].contours(), std::move(painted_lines[layer_idx]));
+                MMUSegmentationTimings::lap(timer, timings.painted_lines_processing);
 
 #ifdef MMU_SEGMENTATION_DEBUG_PAINTED_LINES
                 {
@@ -1866,6 +2001,7 @@ std::vector<std::vector<ExPolygons>> multi_material_segmentation_by_painting(con
 #endif // MMU_SEGMENTATION_DEBUG_PAINTED_LINES
 
                 std::vector<std::vector<ColoredLine>> color_poly = colorize_contours(edge_grids[layer_idx].contours(), post_processed_painted_lines);
+                MMUSegmentationTimings::lap(timer, timings.contours_colorization);
 
 #ifdef MMU_SEGMENTATION_DEBUG_COLORIZED_POLYGONS
                 {
@@ -1880,9 +2016,11 @@ std::vector<std::vector<ExPolygons>> multi_material_segmentation_by_painting(con
                     // If the whole layer is painted using the same color, it is not needed to construct a Voronoi diagram for the segmentation of this layer.
                     segmented_regions[layer_idx][size_t(color_poly.front().front().color)] = input_expolygons[layer_idx];
                 } else {
-                    MMU_Graph graph = build_graph(layer_idx, color_poly);
+                    throw_on_cancel_callback();
+                    MMU_Graph graph = build_graph(layer_idx, color_poly, workspaces.local());
                     remove_multiple_edges_in_vertices(graph, color_poly);
                     graph.remove_nodes_with_one_arc();
+                    MMUSegmentationTimings::lap(timer, timings.voronoi_graph);
 
 #ifdef MMU_SEGMENTATION_DEBUG_GRAPH
                     {
@@ -1891,7 +2029,9 @@ std::vector<std::vector<ExPolygons>> multi_material_segmentation_by_painting(con
                     }
 #endif // MMU_SEGMENTATION_DEBUG_GRAPH
 
+                    throw_on_cancel_callback();
                     segmented_regions[layer_idx] = extract_colored_segments(graph, num_extruders);
+                    MMUSegmentationTimings::lap(timer, timings.colored_segments_extraction);
                 }
 
 #ifdef MMU_SEGMENTATION_DEBUG_REGIONS
@@ -1905,18 +2045,23 @@ std::vector<std::vector<ExPolygons>> multi_material_segmentation_by_painting(con
     }); // end of parallel_for
     BOOST_LOG_TRIVIAL(debug) << "MMU segmentation - layers segmentation in parallel - end";
     throw_on_cancel_callback();
+    timer.start();
 
     if (auto max_width = print_object.config().mmu_segmented_region_max_width, interlocking_depth = print_object.config().mmu_segmented_region_interlocking_depth; max_width > 0.f) {
         cut_segmented_layers(input_expolygons, segmented_regions, float(scale_(max_width)), float(scale_(interlocking_depth)), throw_on_cancel_callback);
         throw_on_cancel_callback();
     }
+    MMUSegmentationTimings::lap(timer, timings.cutting);
 
     // The first index is extruder number (includes default extruder), and the second one is layer number
     std::vector<std::vector<ExPolygons>> top_and_bottom_layers = mmu_segmentation_top_and_bottom_layers(print_object, input_expolygons, throw_on_cancel_callback);
     throw_on_cancel_callback();
+    MMUSegmentationTimings::lap(timer, timings.top_and_bottom_layers);
 
     std::vector<std::vector<ExPolygons>> segmented_regions_merged = merge_segmented_layers(segmented_regions, std::move(top_and_bottom_layers), num_extruders, throw_on_cancel_callback);
     throw_on_cancel_callback();
+    MMUSegmentationTimings::lap(timer, timings.merging);
+    timings.log();
 
 #ifdef MMU_SEGMENTATION_DEBUG_REGIONS
     {
@@ -83,6 +83,9 @@ void grid_intersection(VoxelGrid &grid, VoxelGrid &arg);
 
 bool is_grid_empty(const VoxelGrid &grid);
 
+// Memory occupied by the grid in bytes.
+size_t get_memory_usage(const VoxelGrid &grid);
+
 } // namespace Slic3r
 
 #endif // OPENVDBUTILS_HPP
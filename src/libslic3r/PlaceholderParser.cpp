@@ -15,6 +15,10 @@
 #include <iomanip>
 #include <sstream>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
 #ifdef _MSC_VER
     #include <stdlib.h>  // provides **_environ
 #else
@@ -801,6 +805,9 @@ namespace client
         // If true, the macro processor will evaluate just a boolean condition using the full expressive power of the macro processor.
         bool                     just_boolean_expression = false;
         std::string              error_message;
+        // If a compiled template is processed piece by piece, then this is the range of the complete template.
+        // Used to report the line and position of an error relative to the complete template, not to the piece being parsed.
+        std::optional<IteratorRange> template_range;
 
         // Table to translate symbol tag to a human readable error message.
         static std::map<std::string, std::string> tag_to_error_message;
@@ -1570,8 +1577,10 @@ namespace client
             boost::throw_exception(qi::expectation_failure(it_range.begin(), it_range.end(), spirit::info(std::string("*") + msg)));
         }
 
-        static void process_error_message(const MyContext *context, const boost::spirit::info &info, const Iterator &it_begin, const Iterator &it_end, const Iterator &it_error)
+        static void process_error_message(const MyContext *context, const boost::spirit::info &info, const Iterator &it_range_begin, const Iterator &it_range_end, const Iterator &it_error)
         {
+            const Iterator &it_begin = context->template_range ? context->template_range->begin() : it_range_begin;
+            const Iterator &it_end   = context->template_range ? context->template_range->end()   : it_range_end;
             std::string &msg = const_cast<MyContext*>(context)->error_message;
             std::string  first(it_begin, it_error);
             std::string  last(it_error, it_end);
@@ -2338,14 +2347,391 @@ namespace client
 
 static const client::macro_processor g_macro_processor_instance;
 
+static void throw_placeholder_parser_error(client::MyContext &context)
+{
+    if (context.error_message.back() != '\n' && context.error_message.back() != '\r')
+        context.error_message += '\n';
+    throw Slic3r::PlaceholderParserError(context.error_message);
+}
+
+static std::string process_macro(client::Iterator it_begin, client::Iterator it_end, client::MyContext &context)
+{
+    std::string output;
+    phrase_parse(it_begin, it_end, g_macro_processor_instance(&context), client::skipper{}, output);
+	if (! context.error_message.empty())
+        throw_placeholder_parser_error(context);
+    return output;
+}
+
 static std::string process_macro(const std::string &templ, client::MyContext &context)
 {
+    return process_macro(templ.begin(), templ.end(), context);
+}
+
+namespace client
+{
+    // Template split into a sequence of instructions, so that processing the same template repeatedly
+    // does not run the macro_processor grammar over the complete template again and again:
+    // The free-form text is copied to the output verbatim, the simple variable expansions are evaluated directly
+    // and only the remaining code blocks are handed over to the macro_processor grammar.
+    // The instructions reference the template by offsets, thus a compiled template is shared by all
+    // the PlaceholderParser instances and threads processing the same template.
+    struct CompiledTemplate
+    {
+        enum class OpCode : unsigned char {
+            // Free-form text, copied to the output.
+            Text,
+            // [variable] or [vector_variable_index]
+            LegacyVariable,
+            // [vector_variable[index_variable]]
+            LegacyVariableIndexed,
+            // {variable}
+            Variable,
+            // {vector_variable[index]}, where index is an integer literal or a variable.
+            VariableIndexed,
+            // Any other code block, possibly spanning multiple {if}{else}{endif} blocks, processed by the macro_processor grammar.
+            Macro,
+        };
+
+        struct Instruction {
+            OpCode  opcode      { OpCode::Text };
+            // Range of the template the instruction was compiled from.
+            size_t  begin       { 0 };
+            size_t  end         { 0 };
+            // Range of the variable name.
+            size_t  key_begin   { 0 };
+            size_t  key_end     { 0 };
+            // Range of the index, either an integer literal or a variable name.
+            size_t  index_begin { 0 };
+            size_t  index_end   { 0 };
+            // Value of the index literal, -1 if the index is a variable.
+            int     index       { -1 };
+        };
+
+        std::vector<Instruction> instructions;
+        // False if the template could not be split into instructions, for example due to a syntax error.
+        // Such a template is processed by the macro_processor grammar as a whole, which also reports the error.
+        bool                     valid { false };
+    };
+
+    static inline bool is_code_whitespace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+    static inline bool is_digit(char c) { return c >= '0' && c <= '9'; }
+    static inline bool is_identifier_start(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_'; }
+    static inline bool is_identifier_char(char c) { return is_identifier_start(c) || is_digit(c); }
+
+    // Validate an UTF-8 sequence the same way utf8_char_parser does.
+    // Returns false if a multi-byte character is not finished at the end of the range.
+    static bool is_valid_utf8(const char *begin, const char *end)
+    {
+        for (const char *it = begin; it != end;) {
+            unsigned char c = static_cast<unsigned char>(*it ++);
+            if ((c & 0xC0) == 0x80)
+                return false;
+            unsigned int cnt = 0;
+            for (unsigned char mask = 0x80u; c & mask; mask >>= 1)
+                ++ cnt;
+            cnt = (cnt == 0) ? 1 : ((cnt > 4) ? 4 : cnt);
+            for (-- cnt; cnt > 0; -- cnt) {
+                if (it == end)
+                    return false;
+                c = static_cast<unsigned char>(*it ++);
+                if (cnt > 1 && (c & 0xC0) != 0x80)
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    // Parse an identifier, which is not a keyword, starting at templ[begin].
+    // Returns end of the identifier or begin if there is no identifier.
+    static size_t parse_identifier(const std::string &templ, size_t begin, size_t end)
+    {
+        size_t i = begin;
+        if (i < end && is_identifier_start(templ[i]))
+            for (++ i; i < end && is_identifier_char(templ[i]); ++ i) ;
+        return i > begin && g_macro_processor_instance.keywords.find(templ.substr(begin, i - begin)) == nullptr ? i : begin;
+    }
+
+    // Find end of a code block starting with '{' at templ[begin]. If the code block opens an {if} block, which is closed
+    // by another code block, then the text blocks and code blocks up to the matching {endif} are included.
+    // Returns std::string::npos if the end of the code block was not found.
+    static size_t find_code_block_end(const std::string &templ, size_t begin)
+    {
+        assert(templ[begin] == '{');
+        int  depth_if = 0;
+        bool in_code  = true;
+        // Last non-whitespace character of the code, to distinguish a regular expression from a division.
+        char last     = '{';
+        for (size_t i = begin + 1; i < templ.size();) {
+            char c = templ[i];
+            if (! in_code) {
+                // Text block of an {if} / {elsif} / {else}.
+                if (c == '{') {
+                    in_code = true;
+                    last    = c;
+                }
+                ++ i;
+            } else if (is_code_whitespace(c)) {
+                ++ i;
+            } else if (c == '"' || (c == '/' && (last == '~' || last == ','))) {
+                // String literal or a regular expression, which may contain braces and keywords.
+                for (++ i; i < templ.size() && templ[i] != c; ++ i)
+                    if (templ[i] == '\\')
+                        ++ i;
+                if (i >= templ.size())
+                    return std::string::npos;
+                last = templ[i ++];
+            } else if (is_identifier_start(c)) {
+                size_t j = i;
+                for (++ j; j < templ.size() && is_identifier_char(templ[j]); ++ j) ;
+                std::string_view word(templ.data() + i, j - i);
+                if (word == "if")
+                    ++ depth_if;
+                else if (word == "endif" && -- depth_if < 0)
+                    return std::string::npos;
+                last = c;
+                i    = j;
+            } else if (is_digit(c)) {
+                for (++ i; i < templ.size() && (is_identifier_char(templ[i]) || templ[i] == '.'); ++ i) ;
+                last = c;
+            } else if (c == '{') {
+                // Not a valid code, let the macro_processor report the error.
+                return std::string::npos;
+            } else if (c == '}') {
+                ++ i;
+                if (depth_if == 0)
+                    return i;
+                in_code = false;
+            } else {
+                last = c;
+                ++ i;
+            }
+        }
+        return std::string::npos;
+    }
+
+    // Find end of a legacy variable expansion starting with '[' at templ[begin].
+    // Returns std::string::npos if the end was not found.
+    static size_t find_legacy_variable_end(const std::string &templ, size_t begin)
+    {
+        assert(templ[begin] == '[');
+        int depth = 0;
+        for (size_t i = begin; i < templ.size(); ++ i) {
+            char c = templ[i];
+            if (c == '[')
+                ++ depth;
+            else if (c == ']' && -- depth == 0)
+                return i + 1;
+            else if (c == '{' || c == '"')
+                break;
+        }
+        return std::string::npos;
+    }
+
+    // Compile [variable] or [vector_variable[index_variable]] without white spaces.
+    static bool compile_legacy_variable(const std::string &templ, CompiledTemplate::Instruction &instr)
+    {
+        const size_t end = instr.end - 1;
+        instr.key_begin  = instr.begin + 1;
+        instr.key_end    = parse_identifier(templ, instr.key_begin, end);
+        if (instr.key_end == instr.key_begin)
+            return false;
+        if (instr.key_end == end) {
+            instr.opcode = CompiledTemplate::OpCode::LegacyVariable;
+            return true;
+        }
+        if (templ[instr.key_end] != '[')
+            return false;
+        instr.index_begin = instr.key_end + 1;
+        instr.index_end   = parse_identifier(templ, instr.index_begin, end);
+        if (instr.index_end == instr.index_begin || instr.index_end + 1 != end || templ[instr.index_end] != ']')
+            return false;
+        instr.opcode = CompiledTemplate::OpCode::LegacyVariableIndexed;
+        return true;
+    }
+
+    // Compile a code block in the form of {variable} or {vector_variable[index]}.
+    static bool compile_variable(const std::string &templ, CompiledTemplate::Instruction &instr)
+    {
+        const size_t end = instr.end - 1;
+        size_t       i   = instr.begin + 1;
+        auto         skip_whitespaces = [&templ, &i, end]() { while (i < end && is_code_whitespace(templ[i])) ++ i; };
+        skip_whitespaces();
+        instr.key_begin = i;
+        instr.key_end   = i = parse_identifier(templ, i, end);
+        if (instr.key_end == instr.key_begin)
+            return false;
+        skip_whitespaces();
+        if (i == end) {
+            instr.opcode = CompiledTemplate::OpCode::Variable;
+            return true;
+        }
+        if (templ[i] != '[')
+            return false;
+        ++ i;
+        skip_whitespaces();
+        instr.index_begin = i;
+        if (i < end && is_digit(templ[i])) {
+            // Integer literal, limited to 9 digits to not overflow.
+            for (instr.index = 0; i < end && is_digit(templ[i]) && i - instr.index_begin < 9; ++ i)
+                instr.index = instr.index * 10 + (templ[i] - '0');
+            instr.index_end = i;
+        } else {
+            instr.index_end = i = parse_identifier(templ, i, end);
+            if (instr.index_end == instr.index_begin)
+                return false;
+        }
+        skip_whitespaces();
+        if (i == end || templ[i] != ']')
+            return false;
+        ++ i;
+        skip_whitespaces();
+        if (i != end)
+            return false;
+        instr.opcode = CompiledTemplate::OpCode::VariableIndexed;
+        return true;
+    }
+
+    static CompiledTemplate compile_template(const std::string &templ)
+    {
+        CompiledTemplate out;
+        for (size_t i = 0; i < templ.size();) {
+            CompiledTemplate::Instruction instr;
+            instr.begin = i;
+            if (templ[i] == '{') {
+                if (instr.end = find_code_block_end(templ, i); instr.end == std::string::npos)
+                    return out;
+                if (! compile_variable(templ, instr))
+                    instr.opcode = CompiledTemplate::OpCode::Macro;
+            } else if (templ[i] == '[') {
+                if (instr.end = find_legacy_variable_end(templ, i); instr.end == std::string::npos)
+                    return out;
+                if (! compile_legacy_variable(templ, instr))
+                    instr.opcode = CompiledTemplate::OpCode::Macro;
+            } else {
+                instr.end = std::min(templ.find_first_of("[{", i), templ.size());
+                if (! is_valid_utf8(templ.data() + i, templ.data() + instr.end))
+                    return out;
+                instr.opcode = CompiledTemplate::OpCode::Text;
+            }
+            out.instructions.emplace_back(instr);
+            i = instr.end;
+        }
+        out.valid = true;
+        return out;
+    }
+
+    // Templates compiled by PlaceholderParser::process(), shared by all PlaceholderParser instances and threads.
+    // These are mostly the custom G-code blocks of the active profiles, which are processed many times during G-code export.
+    // Once the cache grows over its limits, it is simply cleared.
+    class CompiledTemplateCache
+    {
+    public:
+        std::shared_ptr<const CompiledTemplate> get(const std::string &templ)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (auto it = m_templates.find(templ); it != m_templates.end())
+                    return it->second;
+            }
+            // Compile outside of the lock. If two threads compile the same template concurrently, the first one wins.
+            auto compiled = std::make_shared<const CompiledTemplate>(compile_template(templ));
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_templates.size() >= max_templates || m_size + templ.size() > max_size) {
+                m_templates.clear();
+                m_size = 0;
+            }
+            auto [it, inserted] = m_templates.emplace(templ, std::move(compiled));
+            if (inserted)
+                m_size += templ.size();
+            return it->second;
+        }
+
+    private:
+        static constexpr const size_t max_templates = 1024;
+        static constexpr const size_t max_size      = 16 * 1024 * 1024;
+
+        std::mutex                                                               m_mutex;
+        std::unordered_map<std::string, std::shared_ptr<const CompiledTemplate>> m_templates;
+        // Sum of lengths of the cached templates.
+        size_t                                                                   m_size { 0 };
+    };
+}
+
+static client::CompiledTemplateCache g_compiled_template_cache;
+
+static std::string process_compiled_macro(const std::string &templ, const client::CompiledTemplate &compiled, client::MyContext &context)
+{
+    using namespace client;
+    using OpCode = CompiledTemplate::OpCode;
+
+    if (! compiled.valid)
+        return process_macro(templ, context);
+
+    // Report errors relative to the complete template.
+    context.template_range = IteratorRange(templ.begin(), templ.end());
+    auto range = [&templ](size_t begin, size_t end) { return IteratorRange(templ.begin() + begin, templ.begin() + end); };
     std::string output;
-    phrase_parse(templ.begin(), templ.end(), g_macro_processor_instance(&context), client::skipper{}, output);
-	if (! context.error_message.empty()) {
-        if (context.error_message.back() != '\n' && context.error_message.back() != '\r')
-            context.error_message += '\n';
-        throw Slic3r::PlaceholderParserError(context.error_message);
+    std::string value;
+    try {
+        for (const CompiledTemplate::Instruction &instr : compiled.instructions) {
+            switch (instr.opcode) {
+            case OpCode::Text:
+                output.append(templ, instr.begin, instr.end - instr.begin);
+                break;
+            case OpCode::LegacyVariable:
+            {
+                IteratorRange key = range(instr.key_begin, instr.key_end);
+                MyContext::legacy_variable_expansion(&context, key, value);
+                output += value;
+                break;
+            }
+            case OpCode::LegacyVariableIndexed:
+            {
+                IteratorRange key   = range(instr.key_begin, instr.key_end);
+                IteratorRange index = range(instr.index_begin, instr.index_end);
+                MyContext::legacy_variable_expansion2(&context, key, index, value);
+                output += value;
+                break;
+            }
+            case OpCode::Variable:
+            case OpCode::VariableIndexed:
+            {
+                // The same sequence of actions the macro_processor grammar executes for a variable reference statement.
+                IteratorRange key = range(instr.key_begin, instr.key_end);
+                OptWithPos    opt;
+                MyContext::resolve_variable(&context, key, opt);
+                if (instr.opcode == OpCode::VariableIndexed) {
+                    expr index_expr;
+                    if (instr.index >= 0)
+                        index_expr = expr(instr.index, templ.begin() + instr.index_begin, templ.begin() + instr.index_end);
+                    else {
+                        IteratorRange index_key = range(instr.index_begin, instr.index_end);
+                        OptWithPos    index_opt;
+                        MyContext::resolve_variable(&context, index_key, index_opt);
+                        MyContext::variable_value(&context, index_opt, index_expr);
+                    }
+                    int        index = 0;
+                    OptWithPos opt_indexed;
+                    MyContext::evaluate_index(index_expr, index);
+                    MyContext::store_variable_index(&context, opt, index, templ.begin() + instr.end - 1, opt_indexed);
+                    opt = opt_indexed;
+                }
+                expr val;
+                MyContext::variable_value(&context, opt, val);
+                expr::to_string2(val, value);
+                output += value;
+                break;
+            }
+            case OpCode::Macro:
+                output += process_macro(templ.begin() + instr.begin, templ.begin() + instr.end, context);
+                break;
+            }
+        }
+    } catch (const qi::expectation_failure<Iterator> &ex) {
+        // Errors of the instructions evaluated directly. Errors of the macro_processor grammar are reported by its error handler.
+        MyContext::process_error_message(&context, ex.what_, templ.begin(), templ.end(), ex.first);
+        throw_placeholder_parser_error(context);
     }
     return output;
 }
@@ -2359,7 +2745,7 @@ std::string PlaceholderParser::process(const std::string &templ, unsigned int cu
     context.config_outputs      = config_outputs;
     context.current_extruder_id = current_extruder_id;
     context.context_data        = context_data;
-    return process_macro(templ, context);
+    return process_compiled_macro(templ, *g_compiled_template_cache.get(templ), context);
 }
 
 // Evaluate a boolean expression using the full expressive power of the PlaceholderParser boolean expression syntax.
@@ -15,6 +15,8 @@
 #include <algorithm>
 #include <set>
 #include <fstream>
+#include <sstream>
+#include <unordered_map>
 #include <unordered_set>
 #include <boost/filesystem.hpp>
 #include <boost/algorithm/clamp.hpp>
@@ -348,13 +350,13 @@ std::pair<PresetsConfigSubstitutions, std::string> PresetBundle::load_system_pre
                 // Load the config bundle, flatten it.
                 if (first) {
                     // Reset this PresetBundle and load the first vendor config.
-                    append(substitutions, this->load_configbundle(dir_entry.path().string(), PresetBundle::LoadSystem, compatibility_rule).first);
+                    append(substitutions, this->load_configbundle(dir_entry.path().string(), LoadConfigBundleAttribute::LoadSystem | LoadConfigBundleAttribute::CacheSystem, compatibility_rule).first);
                     first = false;
                 } else {
                     // Load the other vendor configs, merge them with this PresetBundle.
                     // Report duplicate profiles.
                     PresetBundle other;
-                    append(substitutions, other.load_configbundle(dir_entry.path().string(), PresetBundle::LoadSystem, compatibility_rule).first);
+                    append(substitutions, other.load_configbundle(dir_entry.path().string(), LoadConfigBundleAttribute::LoadSystem | LoadConfigBundleAttribute::CacheSystem, compatibility_rule).first);
                     std::vector<std::string> duplicates = this->merge_presets(std::move(other));
                     if (! duplicates.empty()) {
                         errors_cummulative += "Vendor configuration file " + name + " contains the following presets with names used by other vendors: ";
@@ -1359,6 +1361,207 @@ static void flatten_configbundle_hierarchy(boost::property_tree::ptree &tree, co
     flatten_configbundle_hierarchy(tree, "printer",         preset_bundle ? preset_bundle->printers.system_preset_names()      : std::vector<std::string>());
 }
 
+// Option of a config bundle section, referencing a key and a value owned either by the source
+// boost::property_tree or by the string table of ConfigBundleCache.
+struct ConfigBundleOption {
+    const std::string &key;
+    const std::string &value;
+};
+
+struct ConfigBundleSection {
+    std::string                     name;
+    std::vector<ConfigBundleOption> options;
+};
+
+// Sections of a config bundle after its inheritance hierarchy was flattened.
+struct FlattenedConfigBundle {
+    std::vector<ConfigBundleSection> sections;
+    // Unique keys and values, if the config bundle was loaded from ConfigBundleCache.
+    std::vector<std::string>         strings;
+};
+
+static std::vector<ConfigBundleSection> config_bundle_sections(const boost::property_tree::ptree &tree)
+{
+    std::vector<ConfigBundleSection> out;
+    out.reserve(tree.size());
+    for (const auto &section : tree) {
+        ConfigBundleSection &dst = out.emplace_back();
+        dst.name = section.first;
+        dst.options.reserve(section.second.size());
+        for (const auto &kvp : section.second)
+            dst.options.push_back({ kvp.first, kvp.second.data() });
+    }
+    return out;
+}
+
+// Sections of the print, filament, printer and physical printer presets.
+// All other sections describe the vendor, the printer models and the active presets.
+static bool is_preset_section(const std::string &section_name)
+{
+    for (const char *prefix : { "print:", "filament:", "sla_print:", "sla_material:", "printer:", "physical_printer:" })
+        if (boost::starts_with(section_name, prefix))
+            return true;
+    return false;
+}
+
+// Binary cache of a system config bundle after flatten_configbundle_hierarchy(), stored into data_dir()/vendor/cache.
+// Only the bundles installed into data_dir()/vendor are cached, never the bundles in the read-only resources directory
+// or the temporary bundles validated by the PresetUpdater.
+// Parsing a large vendor config bundle with boost::property_tree and resolving its inheritance hierarchy
+// is a significant part of the application startup. The keys and values are stored into a table of unique strings,
+// as the values inherited by many presets are stored just once. The cache is valid for a single version
+// of PrusaSlicer and a single content of the config bundle, which is verified by its size and hash.
+namespace ConfigBundleCache {
+    static constexpr const char     magic[4]       = { 'P', 'S', 'C', 'B' };
+    static constexpr const uint32_t format_version = 1;
+
+    static boost::filesystem::path path(const std::string &bundle_path)
+    {
+        return (boost::filesystem::path(data_dir()) / "vendor" / "cache" / boost::filesystem::path(bundle_path).filename().replace_extension(".cache")).make_preferred();
+    }
+
+    // 64bit FNV-1a hash.
+    static uint64_t hash(const std::string &data)
+    {
+        uint64_t h = 0xcbf29ce484222325ull;
+        for (char c : data) {
+            h ^= uint64_t(static_cast<unsigned char>(c));
+            h *= 0x100000001b3ull;
+        }
+        return h;
+    }
+
+    template<typename T> static void write(std::string &out, T value) { out.append(reinterpret_cast<const char*>(&value), sizeof(T)); }
+    static void write(std::string &out, const std::string &str) { write(out, uint32_t(str.size())); out += str; }
+
+    class Reader {
+    public:
+        Reader(const std::string &data) : m_data(data) {}
+        template<typename T> bool read(T &value) {
+            if (m_data.size() - m_pos < sizeof(T))
+                return false;
+            memcpy(&value, m_data.data() + m_pos, sizeof(T));
+            m_pos += sizeof(T);
+            return true;
+        }
+        bool read(std::string &str) {
+            uint32_t len;
+            if (! this->read(len) || m_data.size() - m_pos < len)
+                return false;
+            str.assign(m_data, m_pos, len);
+            m_pos += len;
+            return true;
+        }
+        void skip(size_t n) { m_pos = std::min(m_pos + n, m_data.size()); }
+        bool eof() const { return m_pos == m_data.size(); }
+    private:
+        const std::string &m_data;
+        size_t             m_pos { 0 };
+    };
+
+    static void write_header(std::string &out, const std::string &bundle_data)
+    {
+        out.append(magic, sizeof(magic));
+        write(out, format_version);
+        write(out, std::string(SLIC3R_VERSION));
+        write(out, uint64_t(bundle_data.size()));
+        write(out, hash(bundle_data));
+    }
+
+    // Load the cache of a config bundle with the content of bundle_data. Returns false if there is no valid cache.
+    static bool load(const std::string &bundle_path, const std::string &bundle_data, FlattenedConfigBundle &out)
+    {
+        std::string data;
+        {
+            boost::nowide::ifstream ifs(path(bundle_path).string(), std::ios::binary);
+            if (! ifs)
+                return false;
+            data.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+        }
+        std::string header;
+        write_header(header, bundle_data);
+        if (data.size() < header.size() || data.compare(0, header.size(), header) != 0)
+            return false;
+        Reader   reader(data);
+        reader.skip(header.size());
+        uint32_t num_strings;
+        if (! reader.read(num_strings))
+            return false;
+        out.strings.assign(num_strings, std::string());
+        for (std::string &str : out.strings)
+            if (! reader.read(str))
+                return false;
+        uint32_t num_sections;
+        if (! reader.read(num_sections))
+            return false;
+        out.sections.resize(num_sections);
+        for (ConfigBundleSection &section : out.sections) {
+            uint32_t num_options;
+            if (! reader.read(section.name) || ! reader.read(num_options))
+                return false;
+            section.options.reserve(num_options);
+            for (uint32_t i = 0; i < num_options; ++ i) {
+                uint32_t key, value;
+                if (! reader.read(key) || ! reader.read(value) || key >= num_strings || value >= num_strings)
+                    return false;
+                section.options.push_back({ out.strings[key], out.strings[value] });
+            }
+        }
+        return reader.eof();
+    }
+
+    // Save the cache of a config bundle with the content of bundle_data. Failing to save the cache is not an error,
+    // for example if the data directory is not writable.
+    static void save(const std::string &bundle_path, const std::string &bundle_data, const std::vector<ConfigBundleSection> &sections)
+    {
+        std::string out;
+        write_header(out, bundle_data);
+        // Table of unique strings.
+        std::unordered_map<std::string_view, uint32_t> string_ids;
+        std::vector<const std::string*>                strings;
+        std::vector<uint32_t>                          option_ids;
+        for (const ConfigBundleSection &section : sections)
+            for (const ConfigBundleOption &option : section.options)
+                for (const std::string *str : { &option.key, &option.value }) {
+                    auto [it, inserted] = string_ids.emplace(*str, uint32_t(strings.size()));
+                    if (inserted)
+                        strings.emplace_back(str);
+                    option_ids.emplace_back(it->second);
+                }
+        write(out, uint32_t(strings.size()));
+        for (const std::string *str : strings)
+            write(out, *str);
+        write(out, uint32_t(sections.size()));
+        auto it_option_id = option_ids.begin();
+        for (const ConfigBundleSection &section : sections) {
+            write(out, section.name);
+            write(out, uint32_t(section.options.size()));
+            for (size_t i = 0; i < section.options.size(); ++ i) {
+                write(out, *it_option_id ++);
+                write(out, *it_option_id ++);
+            }
+        }
+        // Write into a temporary file first, so that a partially written cache is never loaded.
+        boost::filesystem::path   path_cache = path(bundle_path);
+        boost::filesystem::path   path_tmp   = path_cache;
+        path_tmp += ".tmp";
+        boost::system::error_code ec;
+        boost::filesystem::create_directories(path_cache.parent_path(), ec);
+        {
+            boost::nowide::ofstream ofs(path_tmp.string(), std::ios::binary | std::ios::trunc);
+            if (! ofs || ! ofs.write(out.data(), out.size())) {
+                BOOST_LOG_TRIVIAL(debug) << "Failed to write the config bundle cache " << path_tmp.string();
+                return;
+            }
+        }
+        boost::filesystem::rename(path_tmp, path_cache, ec);
+        if (ec) {
+            BOOST_LOG_TRIVIAL(debug) << "Failed to write the config bundle cache " << path_cache.string() << ": " << ec.message();
+            boost::filesystem::remove(path_tmp, ec);
+        }
+    }
+} // namespace ConfigBundleCache
+
 // Load a config bundle file, into presets and store the loaded presets into separate files
 // of the local configuration directory.
 std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_configbundle(
@@ -1373,12 +1576,29 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_configbundle(
         this->reset(flags.has(LoadConfigBundleAttribute::SaveImported));
 
     // 1) Read the complete config file into a boost::property_tree.
+    // A system config bundle is flattened the same way every time it is loaded, thus it is loaded from its cache if the cache is valid.
+    // Only the sections describing the vendor are then converted into a boost::property_tree.
     namespace pt = boost::property_tree;
-    pt::ptree tree;
+    pt::ptree             tree;
+    std::string           bundle_data;
+    FlattenedConfigBundle bundle;
     {
         boost::nowide::ifstream ifs(path);
+        bundle_data.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    }
+    const bool cacheable = flags.has(LoadConfigBundleAttribute::LoadSystem) && flags.has(LoadConfigBundleAttribute::CacheSystem);
+    const bool cached    = cacheable && ConfigBundleCache::load(path, bundle_data, bundle);
+    if (cached) {
+        for (const ConfigBundleSection &section : bundle.sections)
+            if (! is_preset_section(section.name)) {
+                pt::ptree &node = tree.push_back(std::make_pair(section.name, pt::ptree()))->second;
+                for (const ConfigBundleOption &option : section.options)
+                    node.push_back(std::make_pair(option.key, pt::ptree(option.value)));
+            }
+    } else {
+        std::istringstream iss(bundle_data);
         try {
-            pt::read_ini(ifs, tree);
+            pt::read_ini(iss, tree);
         } catch (const boost::property_tree::ini_parser::ini_parser_error &err) {
             throw Slic3r::RuntimeError(format("Failed loading config bundle \"%1%\"\nError: \"%2%\" at line %3%", path, err.message(), err.line()).c_str());
         }
@@ -1402,7 +1622,12 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_configbundle(
 
     // 1.5) Flatten the config bundle by applying the inheritance rules. Internal profiles (with names starting with '*') are removed.
     // If loading a user config bundle, do not flatten with the system profiles, but keep the "inherits" flag intact.
-    flatten_configbundle_hierarchy(tree, flags.has(LoadConfigBundleAttribute::LoadSystem) ? nullptr : this);
+    if (! cached) {
+        flatten_configbundle_hierarchy(tree, flags.has(LoadConfigBundleAttribute::LoadSystem) ? nullptr : this);
+        bundle.sections = config_bundle_sections(tree);
+        if (cacheable)
+            ConfigBundleCache::save(path, bundle_data, bundle.sections);
+    }
 
     // 2) Parse the property_tree, extract the active preset names and the profiles, save them into local config files.
     // Parse the obsolete preset names, to be deleted when upgrading from the old configuration structure.
@@ -1421,76 +1646,76 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_configbundle(
     size_t                   presets_loaded = 0;
     size_t                   ph_printers_loaded = 0;
 
-    for (const auto &section : tree) {
+    for (const ConfigBundleSection &section : bundle.sections) {
         PresetCollection         *presets = nullptr;
         std::string               preset_name;
         PhysicalPrinterCollection *ph_printers = nullptr;
         std::string               ph_printer_name;
-        if (boost::starts_with(section.first, "print:")) {
+        if (boost::starts_with(section.name, "print:")) {
             presets = &this->prints;
-            preset_name = section.first.substr(6);
-        } else if (boost::starts_with(section.first, "filament:")) {
+            preset_name = section.name.substr(6);
+        } else if (boost::starts_with(section.name, "filament:")) {
             presets = &this->filaments;
-            preset_name = section.first.substr(9);
+            preset_name = section.name.substr(9);
             if (vendor_profile && vendor_profile->templates_profile) {
                 preset_name += " @Template";
             }
-        } else if (boost::starts_with(section.first, "sla_print:")) {
+        } else if (boost::starts_with(section.name, "sla_print:")) {
             presets = &this->sla_prints;
-            preset_name = section.first.substr(10);
-        } else if (boost::starts_with(section.first, "sla_material:")) {
+            preset_name = section.name.substr(10);
+        } else if (boost::starts_with(section.name, "sla_material:")) {
             presets = &this->sla_materials;
-            preset_name = section.first.substr(13);
-        } else if (boost::starts_with(section.first, "printer:")) {
+            preset_name = section.name.substr(13);
+        } else if (boost::starts_with(section.name, "printer:")) {
             presets = &this->printers;
-            preset_name = section.first.substr(8);
-        } else if (boost::starts_with(section.first, "physical_printer:")) {
+            preset_name = section.name.substr(8);
+        } else if (boost::starts_with(section.name, "physical_printer:")) {
             ph_printers = &this->physical_printers;
-            ph_printer_name = section.first.substr(17);
-        } else if (section.first == "presets") {
+            ph_printer_name = section.name.substr(17);
+        } else if (section.name == "presets") {
             // Load the names of the active presets.
-            for (auto &kvp : section.second) {
-                if (kvp.first == "print") {
-                    active_print = kvp.second.data();
-                } else if (boost::starts_with(kvp.first, "filament")) {
+            for (auto &kvp : section.options) {
+                if (kvp.key == "print") {
+                    active_print = kvp.value;
+                } else if (boost::starts_with(kvp.key, "filament")) {
                     int idx = 0;
-                    if (kvp.first == "filament" || sscanf(kvp.first.c_str(), "filament_%d", &idx) == 1) {
+                    if (kvp.key == "filament" || sscanf(kvp.key.c_str(), "filament_%d", &idx) == 1) {
                         if (int(active_filaments.size()) <= idx)
                             active_filaments.resize(idx + 1, std::string());
-                        active_filaments[idx] = kvp.second.data();
+                        active_filaments[idx] = kvp.value;
                     }
-                } else if (kvp.first == "sla_print") {
-                    active_sla_print = kvp.second.data();
-                } else if (kvp.first == "sla_material") {
-                    active_sla_material = kvp.second.data();
-                } else if (kvp.first == "printer") {
-                    active_printer = kvp.second.data();
-                } else if (kvp.first == "physical_printer") {
-                    active_physical_printer = kvp.second.data();
+                } else if (kvp.key == "sla_print") {
+                    active_sla_print = kvp.value;
+                } else if (kvp.key == "sla_material") {
+                    active_sla_material = kvp.value;
+                } else if (kvp.key == "printer") {
+                    active_printer = kvp.value;
+                } else if (kvp.key == "physical_printer") {
+                    active_physical_printer = kvp.value;
                 }
             }
-        } else if (section.first == "obsolete_presets") {
+        } else if (section.name == "obsolete_presets") {
             // Parse the names of obsolete presets. These presets will be deleted from user's
             // profile directory on installation of this vendor preset.
-            for (auto &kvp : section.second) {
+            for (auto &kvp : section.options) {
                 std::vector<std::string> *dst = nullptr;
-                if (kvp.first == "print")
+                if (kvp.key == "print")
                     dst = &this->obsolete_presets.prints;
-                else if (kvp.first == "filament")
+                else if (kvp.key == "filament")
                     dst = &this->obsolete_presets.filaments;
-                else if (kvp.first == "sla_print")
+                else if (kvp.key == "sla_print")
                     dst = &this->obsolete_presets.sla_prints;
-                else if (kvp.first == "sla_material")
+                else if (kvp.key == "sla_material")
                     dst = &this->obsolete_presets.sla_materials;
-                else if (kvp.first == "printer")
+                else if (kvp.key == "printer")
                     dst = &this->obsolete_presets.printers;
                 if (dst)
-                    unescape_strings_cstyle(kvp.second.data(), *dst);
+                    unescape_strings_cstyle(kvp.value, *dst);
             }
-        } else if (section.first == "settings") {
+        } else if (section.name == "settings") {
             // Load the settings.
-            for (auto &kvp : section.second) {
-                if (kvp.first == "autocenter") {
+            for (auto &kvp : section.options) {
+                if (kvp.key == "autocenter") {
                 }
             }
         } else
@@ -1505,17 +1730,17 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_configbundle(
             try {
                 auto parse_config_section = [&section, &alias_name, &renamed_from, &substitution_context, &path](DynamicPrintConfig &config) {
                     substitution_context.substitutions.clear();
-                    for (auto &kvp : section.second) {
-                    	if (kvp.first == "alias")
-                    		alias_name = kvp.second.data();
-                    	else if (kvp.first == "renamed_from") {
-                    		if (! unescape_strings_cstyle(kvp.second.data(), renamed_from)) {
+                    for (auto &kvp : section.options) {
+                    	if (kvp.key == "alias")
+                    		alias_name = kvp.value;
+                    	else if (kvp.key == "renamed_from") {
+                    		if (! unescape_strings_cstyle(kvp.value, renamed_from)) {
     			                BOOST_LOG_TRIVIAL(error) << "Error in a Vendor Config Bundle \"" << path << "\": The preset \"" << 
-    			                    section.first << "\" contains invalid \"renamed_from\" key, which is being ignored.";
+    			                    section.name << "\" contains invalid \"renamed_from\" key, which is being ignored.";
                        		}
                     	}
                         // Throws on parsing error. For system presets, no substituion is being done, but an exception is thrown.
-                        config.set_deserialize(kvp.first, kvp.second.data(), substitution_context);
+                        config.set_deserialize(kvp.key, kvp.value, substitution_context);
                     }
                 };
                 if (presets == &this->printers) {
@@ -1531,27 +1756,27 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_configbundle(
                     parse_config_section(config);
                 }
             } catch (const ConfigurationError &e) {
-                throw ConfigurationError(format("Invalid configuration bundle \"%1%\", section [%2%]: ", path, section.first) + e.what());
+                throw ConfigurationError(format("Invalid configuration bundle \"%1%\", section [%2%]: ", path, section.name) + e.what());
             }
             Preset::normalize(config);
             // Report configuration fields, which are misplaced into a wrong group.
             std::string incorrect_keys = Preset::remove_invalid_keys(config, *default_config);
             if (! incorrect_keys.empty())
                 BOOST_LOG_TRIVIAL(error) << "Error in a Vendor Config Bundle \"" << path << "\": The printer preset \"" << 
-                    section.first << "\" contains the following incorrect keys: " << incorrect_keys << ", which were removed";
+                    section.name << "\" contains the following incorrect keys: " << incorrect_keys << ", which were removed";
             if (flags.has(LoadConfigBundleAttribute::LoadSystem) && presets == &printers) {
                 // Filter out printer presets, which are not mentioned in the vendor profile.
                 // These presets are considered not installed.
                 auto printer_model   = config.opt_string("printer_model");
                 if (printer_model.empty()) {
                     BOOST_LOG_TRIVIAL(error) << "Error in a Vendor Config Bundle \"" << path << "\": The printer preset \"" << 
-                        section.first << "\" defines no printer model, it will be ignored.";
+                        section.name << "\" defines no printer model, it will be ignored.";
                     continue;
                 }
                 auto printer_variant = config.opt_string("printer_variant");
                 if (printer_variant.empty()) {
                     BOOST_LOG_TRIVIAL(error) << "Error in a Vendor Config Bundle \"" << path << "\": The printer preset \"" << 
-                        section.first << "\" defines no printer variant, it will be ignored.";
+                        section.name << "\" defines no printer variant, it will be ignored.";
                     continue;
                 }
                 auto it_model = std::find_if(vendor_profile->models.cbegin(), vendor_profile->models.cend(),
@@ -1559,19 +1784,19 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_configbundle(
                 );
                 if (it_model == vendor_profile->models.end()) {
                     BOOST_LOG_TRIVIAL(error) << "Error in a Vendor Config Bundle \"" << path << "\": The printer preset \"" << 
-                        section.first << "\" defines invalid printer model \"" << printer_model << "\", it will be ignored.";
+                        section.name << "\" defines invalid printer model \"" << printer_model << "\", it will be ignored.";
                     continue;
                 }
                 auto it_variant = it_model->variant(printer_variant);
                 if (it_variant == nullptr) {
                     BOOST_LOG_TRIVIAL(error) << "Error in a Vendor Config Bundle \"" << path << "\": The printer preset \"" << 
-                        section.first << "\" defines invalid printer variant \"" << printer_variant << "\", it will be ignored.";
+                        section.name << "\" defines invalid printer variant \"" << printer_variant << "\", it will be ignored.";
                     continue;
                 }
-                const Preset *preset_existing = presets->find_preset(section.first, false);
+                const Preset *preset_existing = presets->find_preset(section.name, false);
                 if (preset_existing != nullptr) {
                     BOOST_LOG_TRIVIAL(error) << "Error in a Vendor Config Bundle \"" << path << "\": The printer preset \"" << 
-                        section.first << "\" has already been loaded from another Confing Bundle.";
+                        section.name << "\" has already been loaded from another Confing Bundle.";
                     continue;
                 }
             } else if (! flags.has(LoadConfigBundleAttribute::LoadSystem)) {
@@ -1640,22 +1865,22 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_configbundle(
 
             substitution_context.substitutions.clear();
             try {
-                for (auto& kvp : section.second)
-                    config.set_deserialize(kvp.first, kvp.second.data(), substitution_context);
+                for (auto& kvp : section.options)
+                    config.set_deserialize(kvp.key, kvp.value, substitution_context);
             } catch (const ConfigurationError &e) {
-                throw ConfigurationError(format("Invalid configuration bundle \"%1%\", section [%2%]: ", path, section.first) + e.what());
+                throw ConfigurationError(format("Invalid configuration bundle \"%1%\", section [%2%]: ", path, section.name) + e.what());
             }
 
             // Report configuration fields, which are misplaced into a wrong group.
             std::string incorrect_keys = Preset::remove_invalid_keys(config, default_config);
             if (!incorrect_keys.empty())
                 BOOST_LOG_TRIVIAL(error) << "Error in a Vendor Config Bundle \"" << path << "\": The physical printer \"" <<
-                section.first << "\" contains the following incorrect keys: " << incorrect_keys << ", which were removed";
+                section.name << "\" contains the following incorrect keys: " << incorrect_keys << ", which were removed";
 
             const PhysicalPrinter* ph_printer_existing = ph_printers->find_printer(ph_printer_name, false);
             if (ph_printer_existing != nullptr) {
                 BOOST_LOG_TRIVIAL(error) << "Error in a Vendor Config Bundle \"" << path << "\": The physical printer \"" <<
-                    section.first << "\" has already been loaded from another Confing Bundle.";
+                    section.name << "\" has already been loaded from another Confing Bundle.";
                 continue;
             }
 
@@ -121,6 +121,9 @@ public:
         // Load a system config bundle.
         LoadSystem,
         LoadVendorOnly,
+        // Load a system config bundle from its binary cache in data_dir()/vendor/cache and store the cache there if it is not valid.
+        // Only used for the installed vendor bundles, see load_system_presets().
+        CacheSystem,
     };
     using LoadConfigBundleAttributes = enum_bitmask<LoadConfigBundleAttribute>;
     // Load the config bundle based on the flags.
@@ -237,6 +237,9 @@ public:
     // This transformation is used to calculate VolumeExtents.
     Transform3d                                 trafo_bboxes;
     std::vector<ObjectID>                       cached_volume_ids;
+    // Timestamps of the object, volume and layer range configs and the extruder setup the regions were last generated
+    // or verified with by Print::apply(), see print_object_regions_fingerprint().
+    std::vector<uint64_t>                       inputs_fingerprint;
 
     std::optional<GeneratedSupportPoints> generated_support_points;
 
@@ -246,6 +249,7 @@ public:
         all_regions.clear();
         layer_ranges.clear();
         cached_volume_ids.clear();
+        inputs_fingerprint.clear();
     }
 
 private:
@@ -243,12 +243,15 @@ static t_config_option_keys print_config_diffs(
 // Prepare for storing of the full print config into new_full_config to be exported into the G-code and to be used by the PlaceholderParser.
 static t_config_option_keys full_print_config_diffs(const DynamicPrintConfig &current_full_config, const DynamicPrintConfig &new_full_config)
 {
+    // Both configs are sorted by the option keys, merge them in a single pass.
     t_config_option_keys full_config_diff;
-    for (const t_config_option_key &opt_key : new_full_config.keys()) {
-        const ConfigOption *opt_old = current_full_config.option(opt_key);
-        const ConfigOption *opt_new = new_full_config.option(opt_key);
-        if (opt_old == nullptr || *opt_new != *opt_old)
-            full_config_diff.emplace_back(opt_key);
+    auto it_old = current_full_config.cbegin();
+    for (auto it_new = new_full_config.cbegin(); it_new != new_full_config.cend(); ++ it_new) {
+        while (it_old != current_full_config.cend() && it_old->first < it_new->first)
+            ++ it_old;
+        // Values shared by the two configs (the new config was copied from the current one) compare equal without comparing them.
+        if (it_old == current_full_config.cend() || it_old->first != it_new->first || it_old->second != it_new->second)
+            full_config_diff.emplace_back(it_new->first);
     }
     return full_config_diff;
 }
@@ -773,6 +776,29 @@ bool verify_update_print_object_regions(
     return true;
 }
 
+// Inputs of PrintObjectRegions, which are not tracked by Print::apply() through the IDs of ModelObject and ModelVolumes:
+// Timestamps of the object, volume, material and layer range configs and the extruder setup.
+// If the fingerprint matches the fingerprint stored with PrintObjectRegions and the default region config did not change,
+// then verify_update_print_object_regions() would not change the regions and it does not need to be called.
+// The fingerprint is cheap to calculate, while verifying the regions composes and compares a PrintRegionConfig for each region.
+static std::vector<uint64_t> print_object_regions_fingerprint(const ModelObject &model_object, size_t num_extruders, const std::vector<unsigned int> &painting_extruders)
+{
+    std::vector<uint64_t> out;
+    out.reserve(3 + model_object.layer_config_ranges.size() + 3 * model_object.volumes.size());
+    out.emplace_back(num_extruders);
+    out.emplace_back(painting_extruders.size());
+    out.emplace_back(static_cast<const ModelConfig&>(model_object.config).timestamp());
+    for (const auto &range_and_config : model_object.layer_config_ranges)
+        out.emplace_back(range_and_config.second.timestamp());
+    for (const ModelVolume *volume : model_object.volumes) {
+        out.emplace_back(volume->id().id);
+        out.emplace_back(static_cast<const ModelConfig&>(volume->config).timestamp());
+        const ModelMaterial *material = volume->material_id().empty() ? nullptr : volume->material();
+        out.emplace_back(material ? static_cast<const ModelConfig&>(material->config).timestamp() : 0);
+    }
+    return out;
+}
+
 // Update caches of volume bounding boxes.
 void update_volume_bboxes(
     std::vector<PrintObjectRegions::LayerRangeRegions>  &layer_ranges,
@@ -1001,16 +1027,20 @@ Print::ApplyStatus Print::apply(const Model &model, DynamicPrintConfig new_full_
 
     // Grab the lock for the Print / PrintObject milestones.
 	std::scoped_lock<std::mutex> lock(this->state_mutex());
+    this->invalidated_steps_clear();
 
     // The following call may stop the background processing.
-    if (! print_diff.empty())
+    if (! print_diff.empty()) {
+        this->set_invalidation_reason("print config changed");
         update_apply_status(this->invalidate_state_by_config_options(new_full_config, print_diff));
+    }
 
     // Apply variables to placeholder parser. The placeholder parser is used by G-code export,
     // which should be stopped if print_diff is not empty.
     size_t num_extruders = m_config.nozzle_diameter.size();
     bool   num_extruders_changed = false;
     if (! full_config_diff.empty()) {
+        this->set_invalidation_reason("full config changed");
         update_apply_status(this->invalidate_step(psGCodeExport));
         m_placeholder_parser.clear_config();
         // Set the profile aliases for the PrintBase::output_filename()
@@ -1045,6 +1075,7 @@ Print::ApplyStatus Print::apply(const Model &model, DynamicPrintConfig new_full_
     if (model.id() != m_model.id()) {
         // Kill everything, initialize from scratch.
         // Stop background processing.
+        this->set_invalidation_reason("model replaced");
         this->call_cancel_callback();
         update_apply_status(this->invalidate_all_steps());
         for (PrintObject *object : m_objects) {
@@ -1059,6 +1090,7 @@ Print::ApplyStatus Print::apply(const Model &model, DynamicPrintConfig new_full_
 			model_object_status_db.add(*model_object, ModelObjectStatus::New);
     } else {
         if (m_model.custom_gcode_per_print_z != model.custom_gcode_per_print_z) {
+            this->set_invalidation_reason("custom G-codes per print Z changed");
             update_apply_status(num_extruders_changed || 
             	// Tool change G-codes are applied as color changes for a single extruder printer, no need to invalidate tool ordering.
             	//FIXME The tool ordering may be invalidated unnecessarily if the custom_gcode_per_print_z.mode is not applicable
@@ -1076,6 +1108,7 @@ Print::ApplyStatus Print::apply(const Model &model, DynamicPrintConfig new_full_
 				model_object_status_db.add(*model_object, ModelObjectStatus::Old);
         } else if (model_object_list_extended(m_model, model)) {
             // Add new objects. Their volumes and configs will be synchronized later.
+            this->set_invalidation_reason("objects added");
             update_apply_status(this->invalidate_step(psGCodeExport));
             for (const ModelObject *model_object : m_model.objects)
                 model_object_status_db.add(*model_object, ModelObjectStatus::Old);
@@ -1087,6 +1120,7 @@ Print::ApplyStatus Print::apply(const Model &model, DynamicPrintConfig new_full_
         } else {
             // Reorder the objects, add new objects.
             // First stop background processing before shuffling or deleting the PrintObjects in the object list.
+            this->set_invalidation_reason("objects reordered or deleted");
             this->call_cancel_callback();
             update_apply_status(this->invalidate_step(psGCodeExport));
             // Second create a new list of objects.
@@ -1169,6 +1203,7 @@ Print::ApplyStatus Print::apply(const Model &model, DynamicPrintConfig new_full_
         if (solid_or_modifier_differ || model_origin_translation_differ || layer_height_ranges_differ ||
             ! model_object.layer_height_profile.timestamp_matches(model_object_new.layer_height_profile)) {
             // The very first step (the slicing step) is invalidated. One may freely remove all associated PrintObjects.
+            this->set_invalidation_reason(solid_or_modifier_differ ? "object volumes or painting changed" : "object origin or layer heights changed");
             model_object_status.print_object_regions_status = 
                 model_object_status.print_object_regions == nullptr || model_origin_translation_differ || layer_height_ranges_differ ?
                 // Drop print_objects_regions.
@@ -1190,6 +1225,7 @@ Print::ApplyStatus Print::apply(const Model &model, DynamicPrintConfig new_full_
             model_object_status.print_object_regions_status = ModelObjectStatus::PrintObjectRegionsStatus::Valid;
             if (supports_differ || model_custom_supports_data_changed(model_object, model_object_new)) {
                 // First stop background processing before shuffling or deleting the ModelVolumes in the ModelObject's list.
+                this->set_invalidation_reason(supports_differ ? "support blockers or enforcers changed" : "painted supports changed");
                 if (supports_differ) {
                     this->call_cancel_callback();
                     update_apply_status(false);
@@ -1203,6 +1239,7 @@ Print::ApplyStatus Print::apply(const Model &model, DynamicPrintConfig new_full_
                     model_volume_list_update_supports(model_object, model_object_new);
                 }
             } else if (model_custom_seam_data_changed(model_object, model_object_new)) {
+                this->set_invalidation_reason("painted seams changed");
                 update_apply_status(this->invalidate_step(psGCodeExport));
             }
         }
@@ -1212,6 +1249,7 @@ Print::ApplyStatus Print::apply(const Model &model, DynamicPrintConfig new_full_
 			if (object_config_changed)
 				model_object.config.assign_config(model_object_new.config);
             if (! object_diff.empty() || object_config_changed || num_extruders_changed) {
+                this->set_invalidation_reason("object config changed");
                 PrintObjectConfig new_config = PrintObject::object_config_from_model_object(m_default_object_config, model_object, num_extruders);
                 for (const PrintObjectStatus &print_object_status : print_object_status_db.get_range(model_object)) {
                     t_config_option_keys diff = print_object_status.print_object->config().diff(new_config);
@@ -1233,6 +1271,7 @@ Print::ApplyStatus Print::apply(const Model &model, DynamicPrintConfig new_full_
             if (model_object.instances.size() != model_object_new.instances.size() || 
             	! std::equal(model_object.instances.begin(), model_object.instances.end(), model_object_new.instances.begin(), [](auto l, auto r){ return l->id() == r->id(); })) {
             	// G-code generator accesses model_object.instances to generate sequential print ordering matching the Plater object list.
+                this->set_invalidation_reason("instances added or removed");
             	update_apply_status(this->invalidate_step(psGCodeExport));
 	            model_object.clear_instances();
 	            model_object.instances.reserve(model_object_new.instances.size());
@@ -1260,6 +1299,7 @@ Print::ApplyStatus Print::apply(const Model &model, DynamicPrintConfig new_full_
 
     // 4) Generate PrintObjects from ModelObjects and their instances.
     {
+        this->set_invalidation_reason("instances moved, added or removed");
         PrintObjectPtrs print_objects_new;
         print_objects_new.reserve(std::max(m_objects.size(), m_model.objects.size()));
         bool new_objects = false;
@@ -1364,6 +1404,7 @@ Print::ApplyStatus Print::apply(const Model &model, DynamicPrintConfig new_full_
             painting_extruders.assign(num_extruders, 0);
             std::iota(painting_extruders.begin(), painting_extruders.end(), 1);
         }
+        std::vector<uint64_t> inputs_fingerprint = print_object_regions_fingerprint(model_object, num_extruders, painting_extruders);
         if (model_object_status.print_object_regions_status == ModelObjectStatus::PrintObjectRegionsStatus::Valid) {
             // Verify that the trafo for regions & volume bounding boxes thus for regions is still applicable.
             auto invalidate = [it_print_object, it_print_object_end, update_apply_status]() {
@@ -1371,11 +1412,15 @@ Print::ApplyStatus Print::apply(const Model &model, DynamicPrintConfig new_full_
                     if ((*it)->m_shared_regions != nullptr)
                         update_apply_status((*it)->invalidate_all_steps());
             };
+            this->set_invalidation_reason("region config changed");
             if (print_object_regions && ! trafos_differ_in_rotation_by_z_and_mirroring_by_xy_only(print_object_regions->trafo_bboxes, model_object_status.print_instances.front().trafo)) {
+                this->set_invalidation_reason("object rotated or scaled");
                 invalidate();
                 print_object_regions->clear();
                 model_object_status.print_object_regions_status = ModelObjectStatus::PrintObjectRegionsStatus::Invalid;
                 print_regions_reshuffled = true;
+            } else if (print_object_regions && region_diff.empty() && print_object_regions->inputs_fingerprint == inputs_fingerprint) {
+                // None of the configs the regions were derived from changed, the regions are valid.
             } else if (print_object_regions &&
                 verify_update_print_object_regions(
                     print_object.model_object()->volumes,
@@ -1389,8 +1434,10 @@ Print::ApplyStatus Print::apply(const Model &model, DynamicPrintConfig new_full_
                                 update_apply_status((*it)->invalidate_state_by_config_options(old_config, new_config, diff_keys));
                     })) {
                 // Regions are valid, just keep them.
+                print_object_regions->inputs_fingerprint = std::move(inputs_fingerprint);
             } else {
                 // Regions were reshuffled.
+                this->set_invalidation_reason("regions split or merged");
                 invalidate();
                 // At least reuse layer ranges and bounding boxes of ModelVolumes.
                 model_object_status.print_object_regions_status = ModelObjectStatus::PrintObjectRegionsStatus::PartiallyValid;
@@ -1409,6 +1456,7 @@ Print::ApplyStatus Print::apply(const Model &model, DynamicPrintConfig new_full_
                 num_extruders,
                 print_object.is_mm_painted() ? 0.f : float(print_object.config().xy_size_compensation.value),
                 painting_extruders);
+            print_object_regions->inputs_fingerprint = std::move(inputs_fingerprint);
         }
         for (auto it = it_print_object; it != it_print_object_end; ++it)
             if ((*it)->m_shared_regions) {
@@ -1448,6 +1496,7 @@ Print::ApplyStatus Print::apply(const Model &model, DynamicPrintConfig new_full_
 
     if (apply_status == APPLY_STATUS_CHANGED || apply_status == APPLY_STATUS_INVALIDATED)
         this->cleanup();
+    this->set_invalidation_reason(nullptr);
 
 #ifdef _DEBUG
     check_model_ids_equal(m_model, model);
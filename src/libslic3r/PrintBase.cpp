@@ -111,6 +111,14 @@ void PrintBase::status_update_warnings(int step, PrintStateBase::WarningLevel /*
         printf("%s warning: %s\n",  print_object ? "print_object" : "print", message.c_str());
 }
 
+void PrintBase::log_invalidated_steps(ObjectID object_id, uint64_t steps_mask)
+{
+    assert(this->invalidated_steps_logged());
+    for (int step = 0; steps_mask != 0; ++ step, steps_mask >>= 1)
+        if (steps_mask & 1)
+            m_invalidated_steps.push_back({ object_id, step, m_invalidation_reason });
+}
+
 std::mutex& PrintObjectBase::state_mutex(PrintBase *print)
 { 
 	return print->state_mutex();
@@ -126,4 +134,14 @@ void PrintObjectBase::status_update_warnings(PrintBase *print, int step, PrintSt
     print->status_update_warnings(step, warning_level, message, this);
 }
 
+bool PrintObjectBase::invalidated_steps_logged(const PrintBase *print)
+{
+    return print->invalidated_steps_logged();
+}
+
+void PrintObjectBase::log_invalidated_steps(PrintBase *print, uint64_t steps_mask) const
+{
+    print->log_invalidated_steps(this->id(), steps_mask);
+}
+
 } // namespace Slic3r
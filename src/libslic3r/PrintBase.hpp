@@ -296,6 +296,17 @@ public:
         return invalidated;
     }
 
+    // Bitmask of the milestones, which are Started or Done, thus which would be invalidated by invalidate(),
+    // invalidate_multiple() or invalidate_all(). Bit i is set for StepType(i).
+    uint64_t started_or_done_mask_unguarded() const {
+        static_assert(COUNT <= 64, "PrintState::started_or_done_mask_unguarded(): Too many steps to fit a bit mask.");
+        uint64_t mask = 0;
+        for (size_t i = 0; i < COUNT; ++ i)
+            if (m_state[i].state == State::Started || m_state[i].state == State::Done)
+                mask |= uint64_t(1) << i;
+        return mask;
+    }
+
     // If the milestone is Canceled or Invalidated, return true and turn the state of the milestone to Fresh.
     // The caller is responsible for releasing the data of the milestone that is no more valid.
     bool query_reset_dirty_unguarded(StepType step) {
@@ -376,6 +387,9 @@ protected:
 	// The UI will be notified by calling a status callback registered on print.
 	// If no status callback is registered, the message is printed to console.
 	void 				   				status_update_warnings(PrintBase *print, int step, PrintStateBase::WarningLevel warning_level, const std::string &message);
+	// Record milestones of this PrintObjectBase invalidated by print->apply(), see PrintBase::invalidated_steps().
+	static bool                         invalidated_steps_logged(const PrintBase *print);
+	void                                log_invalidated_steps(PrintBase *print, uint64_t steps_mask) const;
 
     ModelObject                  *m_model_object;
 };
@@ -436,6 +450,22 @@ public:
     virtual ApplyStatus     apply(const Model &model, DynamicPrintConfig config) = 0;
     const Model&            model() const { return m_model; }
 
+    // Milestone of a Print or of a PrintObject invalidated by the last apply() call.
+    struct InvalidatedStep {
+        // ID of the PrintObject owning the milestone, or ID of the Print for a Print milestone.
+        ObjectID            object_id;
+        // PrintObjectStep / SLAPrintObjectStep for a PrintObject milestone, PrintStep / SLAPrintStep for a Print milestone.
+        int                 step;
+        // Change of the Model or of the configuration, which invalidated the milestone. Static string, not translated.
+        const char         *reason;
+    };
+    // Enable or disable recording of the milestones invalidated by apply(). Recording is disabled by default.
+    // Only the FFF Print::apply() provides the reasons of invalidation, thus only the FFF Print records the milestones.
+    void                    set_log_invalidated_steps(bool enable) { m_log_invalidated_steps = enable; m_invalidated_steps.clear(); }
+    // Milestones invalidated by the last apply() call, in the order they were invalidated.
+    // Empty if recording was not enabled by set_log_invalidated_steps().
+    const std::vector<InvalidatedStep>& invalidated_steps() const { return m_invalidated_steps; }
+
     struct TaskParams {
 		TaskParams() : single_model_object(0), single_model_instance_only(false), to_object_step(-1), to_print_step(-1) {}
         // If non-empty, limit the processing to this ModelObject.
@@ -543,6 +573,15 @@ protected:
 	// If no status callback is registered, the message is printed to console.
     void 				   status_update_warnings(int step, PrintStateBase::WarningLevel warning_level, const std::string &message, const PrintObjectBase* print_object = nullptr);
 
+    // To be called by apply(): Start a new log of invalidated milestones.
+    void                   invalidated_steps_clear() { m_invalidated_steps.clear(); }
+    // To be called by apply(): Reason to be recorded with the milestones invalidated from now on.
+    // Milestones are only recorded while a reason is set, thus the reason shall be reset to nullptr before apply() returns.
+    void                   set_invalidation_reason(const char *reason) { m_invalidation_reason = reason; }
+    bool                   invalidated_steps_logged() const { return m_log_invalidated_steps && m_invalidation_reason != nullptr; }
+    // Record milestones of the Print (object_id == this->id()) or of a PrintObject invalidated by apply(). Bit i of steps_mask is set for step i.
+    void                   log_invalidated_steps(ObjectID object_id, uint64_t steps_mask);
+
     // If the background processing stop was requested, throw CanceledException.
     // To be called by the worker thread and its sub-threads (mostly launched on the TBB thread pool) regularly.
     void                   throw_if_canceled() const { if (m_cancel_status.load(std::memory_order_acquire)) throw CanceledException(); }
@@ -572,6 +611,11 @@ private:
     // while the data influencing the stage is modified.
     mutable std::mutex                      m_state_mutex;
 
+    // Log of milestones invalidated by apply(), see set_log_invalidated_steps().
+    bool                                    m_log_invalidated_steps { false };
+    const char                             *m_invalidation_reason { nullptr };
+    std::vector<InvalidatedStep>            m_invalidated_steps;
+
     friend PrintTryCancel;
 };
 
@@ -597,14 +641,14 @@ protected:
         return status.first;
 	}
     bool            invalidate_step(PrintStepEnum step)
-		{ return m_state.invalidate(step, this->cancel_callback()); }
+		{ return this->log_invalidated([this, step](){ return m_state.invalidate(step, this->cancel_callback()); }); }
     template<typename StepTypeIterator>
     bool            invalidate_steps(StepTypeIterator step_begin, StepTypeIterator step_end) 
-        { return m_state.invalidate_multiple(step_begin, step_end, this->cancel_callback()); }
+        { return this->log_invalidated([this, step_begin, step_end](){ return m_state.invalidate_multiple(step_begin, step_end, this->cancel_callback()); }); }
     bool            invalidate_steps(std::initializer_list<PrintStepEnum> il) 
-        { return m_state.invalidate_multiple(il.begin(), il.end(), this->cancel_callback()); }
+        { return this->log_invalidated([this, il](){ return m_state.invalidate_multiple(il.begin(), il.end(), this->cancel_callback()); }); }
     bool            invalidate_all_steps() 
-        { return m_state.invalidate_all(this->cancel_callback()); }
+        { return this->log_invalidated([this](){ return m_state.invalidate_all(this->cancel_callback()); }); }
 
 	bool            is_step_started_unguarded(PrintStepEnum step) const { return m_state.is_started_unguarded(step); }
 	bool            is_step_done_unguarded(PrintStepEnum step) const { return m_state.is_done_unguarded(step); }
@@ -726,6 +770,18 @@ protected:
     }
 
 private:
+    // Call invalidate(), record the milestones it invalidated if requested by PrintBase::set_log_invalidated_steps().
+    template<typename InvalidateFn>
+    bool            log_invalidated(InvalidateFn invalidate) {
+        if (! this->invalidated_steps_logged())
+            return invalidate();
+        uint64_t valid_before = m_state.started_or_done_mask_unguarded();
+        bool     invalidated  = invalidate();
+        if (invalidated)
+            this->log_invalidated_steps(this->id(), valid_before & ~ m_state.started_or_done_mask_unguarded());
+        return invalidated;
+    }
+
     PrintState<PrintStepEnum, COUNT>    m_state;
 };
 
@@ -772,14 +828,14 @@ protected:
 	}
 
     bool            invalidate_step(PrintObjectStepEnum step)
-        { return m_state.invalidate(step, PrintObjectBase::cancel_callback(m_print)); }
+        { return this->log_invalidated([this, step](){ return m_state.invalidate(step, PrintObjectBase::cancel_callback(m_print)); }); }
     template<typename StepTypeIterator>
     bool            invalidate_steps(StepTypeIterator step_begin, StepTypeIterator step_end) 
-        { return m_state.invalidate_multiple(step_begin, step_end, PrintObjectBase::cancel_callback(m_print)); }
+        { return this->log_invalidated([this, step_begin, step_end](){ return m_state.invalidate_multiple(step_begin, step_end, PrintObjectBase::cancel_callback(m_print)); }); }
     bool            invalidate_steps(std::initializer_list<PrintObjectStepEnum> il) 
-        { return m_state.invalidate_multiple(il.begin(), il.end(), PrintObjectBase::cancel_callback(m_print)); }
+        { return this->log_invalidated([this, il](){ return m_state.invalidate_multiple(il.begin(), il.end(), PrintObjectBase::cancel_callback(m_print)); }); }
     bool            invalidate_all_steps() 
-        { return m_state.invalidate_all(PrintObjectBase::cancel_callback(m_print)); }
+        { return this->log_invalidated([this](){ return m_state.invalidate_all(PrintObjectBase::cancel_callback(m_print)); }); }
 
     bool            is_step_started_unguarded(PrintObjectStepEnum step) const { return m_state.is_started_unguarded(step); }
     bool            is_step_done_unguarded(PrintObjectStepEnum step) const { return m_state.is_done_unguarded(step); }
@@ -810,6 +866,18 @@ protected:
     PrintType                                *m_print;
 
 private:
+    // Call invalidate(), record the milestones it invalidated if requested by PrintBase::set_log_invalidated_steps().
+    template<typename InvalidateFn>
+    bool            log_invalidated(InvalidateFn invalidate) {
+        if (! PrintObjectBase::invalidated_steps_logged(m_print))
+            return invalidate();
+        uint64_t valid_before = m_state.started_or_done_mask_unguarded();
+        bool     invalidated  = invalidate();
+        if (invalidated)
+            this->log_invalidated_steps(m_print, valid_before & ~ m_state.started_or_done_mask_unguarded());
+        return invalidated;
+    }
+
     PrintState<PrintObjectStepEnum, COUNT>    m_state;
 };
 
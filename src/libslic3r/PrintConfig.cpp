@@ -3045,6 +3045,20 @@ void PrintConfigDef::init_fff_params()
     def->mode = comAdvanced;
     def->set_default_value(new ConfigOptionFloat(0.8));
 
+    def = this->add("support_tree_cache_memory_limit", coPercent);
+    def->label = L("Cache memory limit");
+    def->category = L("Support material");
+    // TRN PrintSettings: "Organic supports" > "Cache memory limit"
+    def->tooltip = L("Limit of the memory used to cache the areas the organic supports have to avoid, in percent of the physical memory. "
+                     "The areas exceeding the limit are compressed or dropped and calculated again when needed, "
+                     "which lowers the memory consumption of large objects at the cost of a longer processing time. "
+                     "Set zero to disable the limit.");
+    def->sidetext = L("%");
+    def->min = 0;
+    def->max = 100;
+    def->mode = comExpert;
+    def->set_default_value(new ConfigOptionPercent(50));
+
     def = this->add("support_tree_branch_diameter", coFloat);
     def->label = L("Branch Diameter");
     def->category = L("Support material");
@@ -4276,6 +4290,20 @@ void PrintConfigDef::init_sla_params()
     def->mode = comExpert;
     def->set_default_value(new ConfigOptionFloat(2.0));
 
+    def = this->add("hollowing_memory_limit", coPercent);
+    def->label = L("Memory limit");
+    def->category = L("Hollowing");
+    def->tooltip  = L(
+        "Upper limit for the memory used by the hollowing of an object, in percent "
+        "of the physical memory. The accuracy is lowered for big objects to stay "
+        "within the limit, but never below the resolution needed by the minimal "
+        "wall thickness. Set to zero to disable the limit.");
+    def->sidetext = L("%");
+    def->min = 0;
+    def->max = 100;
+    def->mode = comExpert;
+    def->set_default_value(new ConfigOptionPercent(25));
+
     def = this->add("material_print_speed", coEnum);
     def->label = L("Print speed");
     def->tooltip = L(
@@ -210,6 +210,9 @@ public:
         Base::m_buf[row * Base::resolution().width_px + col].get(px);
         return px;
     }
+
+    // The pixels of a row, width_px values stored continuously
+    const uint8_t *row(size_t row) const { return Base::m_rbuf.row_ptr(int(row)); }
     
     void clear() { Base::clear(Colors<TColor>::Black); }
 };
@@ -38,6 +38,8 @@ struct Interior {
     double thickness = 0.;
     double full_narrowb = 2.;
 
+    size_t peak_grid_memory = 0;
+
     void reset_accessor() const  // This resets the accessor and its cache
     // Not a thread safe call!
     {
@@ -71,6 +73,11 @@ VoxelGrid &get_grid(Interior &interior)
     return *interior.gridptr;
 }
 
+size_t get_peak_grid_memory(const Interior &interior)
+{
+    return interior.peak_grid_memory;
+}
+
 InteriorPtr generate_interior(const VoxelGrid       &vgrid,
                               const HollowingConfig &hc,
                               const JobController   &ctl)
@@ -82,19 +89,35 @@ InteriorPtr generate_interior(const VoxelGrid       &vgrid,
     float  out_range = 1.f / voxsc; // world units
     auto   narrowb  = 1.f;  // voxel units (voxel count)
 
+    // Grids alive at the same time are counted together
+    size_t peak_memory = 0;
+    auto track_memory = [&peak_memory](std::initializer_list<const VoxelGrid *> grids) {
+        size_t mem = 0;
+        for (const VoxelGrid *g : grids)
+            if (g)
+                mem += get_memory_usage(*g);
+
+        peak_memory = std::max(peak_memory, mem);
+    };
+
     if (ctl.stopcondition()) return {};
     else ctl.statuscb(0, _u8L("Hollowing"));
 
     auto gridptr = dilate_grid(vgrid, out_range, in_range);
+    track_memory({&vgrid, gridptr.get()});
 
     if (ctl.stopcondition()) return {};
     else ctl.statuscb(30, _u8L("Hollowing"));
 
     double iso_surface = D;
     if (D > EPSILON) {
-        gridptr = redistance_grid(*gridptr, -(offset + D), narrowb, narrowb);
+        auto redistanced = redistance_grid(*gridptr, -(offset + D), narrowb, narrowb);
+        track_memory({&vgrid, gridptr.get(), redistanced.get()});
 
-        gridptr = dilate_grid(*gridptr, 1.1 * std::ceil(iso_surface), 0.f);
+        // Release the dilated grid before the next dilation
+        gridptr.reset();
+        gridptr = dilate_grid(*redistanced, 1.1 * std::ceil(iso_surface), 0.f);
+        track_memory({&vgrid, redistanced.get(), gridptr.get()});
 
         out_range = iso_surface;
         in_range  = narrowb / voxsc;
@@ -117,6 +140,7 @@ InteriorPtr generate_interior(const VoxelGrid       &vgrid,
     interior->iso_surface = iso_surface;
     interior->thickness   = offset;
     interior->full_narrowb = (out_range + in_range) / 2.;
+    interior->peak_grid_memory = peak_memory;
 
     return interior;
 }
@@ -745,9 +769,16 @@ DrainHoles transformed_drainhole_points(const ModelObject &mo,
     return pts;
 }
 
-double get_voxel_scale(double mesh_volume, const HollowingConfig &hc)
+// The lowest voxel scale which still samples the wall with enough voxels
+static double min_voxel_scale(const HollowingConfig &hc)
 {
     static constexpr double MIN_SAMPLES_IN_WALL = 3.5;
+
+    return std::max(MIN_SAMPLES_IN_WALL / hc.min_thickness, 1.);
+}
+
+double get_voxel_scale(double mesh_volume, const HollowingConfig &hc)
+{
     static constexpr double MAX_OVERSAMPL = 8.;
     static constexpr double UNIT_VOLUME   = 500000; // empiric
 
@@ -764,7 +795,7 @@ double get_voxel_scale(double mesh_volume, const HollowingConfig &hc)
     // the maximum is lowered if the model volume very big.
 
     double sc_divider    = std::max(1.0, (mesh_volume / UNIT_VOLUME));
-    double min_oversampl = std::max(MIN_SAMPLES_IN_WALL / hc.min_thickness, 1.);
+    double min_oversampl = min_voxel_scale(hc);
     double max_oversampl_scaled = std::max(min_oversampl, MAX_OVERSAMPL / sc_divider);
     auto   voxel_scale          = min_oversampl + (max_oversampl_scaled - min_oversampl) * hc.quality;
 
@@ -775,6 +806,56 @@ double get_voxel_scale(double mesh_volume, const HollowingConfig &hc)
     return voxel_scale;
 }
 
+double estimate_grid_memory(double mesh_area, double voxel_scale, const HollowingConfig &hc)
+{
+    // Float value of a voxel and the share of the partially filled leaf nodes
+    static constexpr double BYTES_PER_VOXEL = 8.;
+
+    // The input grid has a band of 3 voxels on both sides of the surface, the
+    // dilated grid has 1 voxel outside. Inside, the dilated grid reaches
+    // through the wall and the closing distance.
+    double band = 3. + 3. + 1. + 1.1 * (hc.min_thickness + hc.closing_distance) * voxel_scale;
+
+    return mesh_area * voxel_scale * voxel_scale * band * BYTES_PER_VOXEL;
+}
+
+double get_voxel_scale(double mesh_volume, double mesh_area, const HollowingConfig &hc)
+{
+    double voxel_scale = get_voxel_scale(mesh_volume, hc);
+    double max_memory  = double(hc.max_grid_memory);
+
+    if (hc.max_grid_memory == 0 || estimate_grid_memory(mesh_area, voxel_scale, hc) <= max_memory)
+        return voxel_scale;
+
+    // Below this scale the wall would not be sampled densely enough, the limit
+    // is exceeded rather than producing a broken interior.
+    double min_oversampl = min_voxel_scale(hc);
+    if (estimate_grid_memory(mesh_area, min_oversampl, hc) > max_memory) {
+        BOOST_LOG_TRIVIAL(error) << "Hollowing: the grids need "
+                                 << estimate_grid_memory(mesh_area, min_oversampl, hc) / (1024 * 1024)
+                                 << " MB even at the minimum voxel scale " << min_oversampl
+                                 << ", which exceeds the limit of "
+                                 << hc.max_grid_memory / (1024 * 1024) << " MB";
+        return min_oversampl;
+    }
+
+    // The estimate grows with the voxel scale
+    double lo = min_oversampl, hi = voxel_scale;
+    for (int i = 0; i < 30; ++i) {
+        double mid = (lo + hi) / 2.;
+        if (estimate_grid_memory(mesh_area, mid, hc) <= max_memory)
+            lo = mid;
+        else
+            hi = mid;
+    }
+
+    BOOST_LOG_TRIVIAL(warning) << "Hollowing: voxel scale lowered from " << voxel_scale
+                               << " to " << lo << " to fit the grids into "
+                               << hc.max_grid_memory / (1024 * 1024) << " MB";
+
+    return lo;
+}
+
 // The same as its_compactify_vertices, but returns a new mesh, doesn't touch
 // the original
 static indexed_triangle_set
@@ -23,6 +23,12 @@ struct HollowingConfig
     double quality          = 0.5;
     double closing_distance = 0.5;
     bool enabled = true;
+
+    // Upper limit for the memory of the voxel grids in bytes. The voxel scale
+    // is lowered for big models to stay within, but not below the scale needed
+    // to sample the minimal wall thickness. Zero means no limit. Set from the
+    // hollowing_memory_limit option by the SLA print.
+    size_t max_grid_memory = 0;
 };
 
 enum HollowingFlags { hfRemoveInsideTriangles = 0x1 };
@@ -39,6 +45,10 @@ const indexed_triangle_set &get_mesh(const Interior &interior);
 const VoxelGrid & get_grid(const Interior &interior);
 VoxelGrid &get_grid(Interior &interior);
 
+// The highest memory occupied by the voxel grids while the interior was
+// generated, in bytes.
+size_t get_peak_grid_memory(const Interior &interior);
+
 struct DrainHole
 {
     Vec3f pos;
@@ -83,6 +93,16 @@ constexpr float HoleStickOutLength = 1.f;
 
 double get_voxel_scale(double mesh_volume, const HollowingConfig &hc);
 
+// Estimated peak memory of the voxel grids in bytes when hollowing a mesh with
+// the given surface area at the given voxel scale. The grids hold a narrow band
+// of voxels around the surface, thus the estimate grows with the area and the
+// wall thickness, not with the volume.
+double estimate_grid_memory(double mesh_area, double voxel_scale, const HollowingConfig &hc);
+
+// The voxel scale of get_voxel_scale(mesh_volume, hc), lowered if needed to keep
+// the estimated memory within hc.max_grid_memory.
+double get_voxel_scale(double mesh_volume, double mesh_area, const HollowingConfig &hc);
+
 InteriorPtr generate_interior(const VoxelGrid &mesh,
                               const HollowingConfig &  = {},
                               const JobController &ctl = {});
@@ -91,7 +111,7 @@ inline InteriorPtr generate_interior(const indexed_triangle_set &mesh,
                                      const HollowingConfig &hc = {},
                                      const JobController &ctl = {})
 {
-    auto voxel_scale = get_voxel_scale(its_volume(mesh), hc);
+    auto voxel_scale = get_voxel_scale(its_volume(mesh), its_area(mesh), hc);
     auto statusfn = [&ctl](int){ return ctl.stopcondition && ctl.stopcondition(); };
     auto grid = mesh_to_grid(mesh, MeshToGridParams{}
                                               .voxel_scale(voxel_scale)
@@ -130,13 +150,35 @@ template<class Cont> double csgmesh_positive_maxvolume(const Cont &csg)
     return mesh_vol;
 }
 
+template<class Cont> double csgmesh_positive_area(const Cont &csg)
+{
+    double mesh_area = 0;
+
+    bool skip = false;
+    for (const auto &m : csg) {
+        auto op = csg::get_operation(m);
+        auto stackop = csg::get_stack_operation(m);
+        if (stackop == csg::CSGStackOp::Push && op != csg::CSGType::Union)
+            skip = true;
+
+        if (!skip && csg::get_mesh(m) && op == csg::CSGType::Union)
+            mesh_area += its_area(*(csg::get_mesh(m)));
+
+        if (stackop == csg::CSGStackOp::Pop)
+            skip = false;
+    }
+
+    return mesh_area;
+}
+
 template<class It>
 InteriorPtr generate_interior(const Range<It>       &csgparts,
                               const HollowingConfig &hc  = {},
                               const JobController   &ctl = {})
 {
-    double mesh_vol = csgmesh_positive_maxvolume(csgparts);
-    double voxsc    = get_voxel_scale(mesh_vol, hc);
+    double mesh_vol  = csgmesh_positive_maxvolume(csgparts);
+    double mesh_area = csgmesh_positive_area(csgparts);
+    double voxsc     = get_voxel_scale(mesh_vol, mesh_area, hc);
 
     auto params = csg::VoxelizeParams{}
                       .voxel_scale(voxsc)
@@ -7,6 +7,7 @@
 #include <libslic3r/BoostAdapter.hpp>
 //#include <libslic3r/SLA/Contour3D.hpp>
 #include <libslic3r/TriangleMeshSlicer.hpp>
+#include <libslic3r/Execution/ExecutionTBB.hpp>
 
 #include "ConcaveHull.hpp"
 
@@ -25,6 +26,8 @@
 #include "I18N.hpp"
 #include <boost/log/trivial.hpp>
 
+#include <numeric>
+
 
 namespace Slic3r { namespace sla {
 
@@ -147,6 +150,80 @@ static inline double get_merge_distance(const PadConfig &c)
     return 2. * (1.8 * c.wall_thickness_mm) + c.max_merge_dist_mm;
 }
 
+// The pad parts of footprints farther from each other than this never touch.
+// The footprints may be joined by the concave hull up to the merge distance,
+// by the waffle style closing up to four times the waffle offset, and the
+// object gap and the 2 mm wide hull connectors widen them further.
+static inline double get_cluster_distance(const PadConfig &c)
+{
+    double gap = c.embed_object.enabled ? c.embed_object.object_gap_mm : 0.;
+    return std::max(get_merge_distance(c),
+                    4. * unscaled(get_waffle_offset(c)) + 2. * (gap + 1.));
+}
+
+// Groups of the shapes with the given bounding boxes. The bounding boxes of
+// the whole groups are farther from each other than dist. The shapes of a group
+// are sorted and the groups are ordered by their first shape.
+std::vector<std::vector<size_t>> cluster_by_proximity(const std::vector<BoundingBox> &bbs,
+                                                      coord_t dist)
+{
+    std::vector<size_t> parent(bbs.size());
+    std::iota(parent.begin(), parent.end(), size_t(0));
+    auto find = [&parent](size_t i) {
+        while (parent[i] != i)
+            i = parent[i] = parent[parent[i]];
+        return i;
+    };
+
+    // Merge the groups until their inflated bounding boxes are disjoint.
+    std::vector<BoundingBox> group_bbs = bbs;
+    for (bool merged = true; merged;) {
+        merged = false;
+
+        BoxIndex index;
+        for (size_t i = 0; i < group_bbs.size(); ++i)
+            if (find(i) == i && group_bbs[i].defined) {
+                BoundingBox bb = group_bbs[i];
+                bb.offset(dist / 2.);
+                index.insert(bb, unsigned(i));
+            }
+
+        for (size_t i = 0; i < group_bbs.size(); ++i) {
+            if (parent[i] != i || !group_bbs[i].defined)
+                continue;
+
+            BoundingBox bb = group_bbs[i];
+            bb.offset(dist / 2.);
+            for (const BoxIndexEl &el : index.query(bb, BoxIndex::qtIntersects)) {
+                size_t a = find(i), b = find(el.second);
+                if (a != b) {
+                    parent[std::max(a, b)] = std::min(a, b);
+                    merged = true;
+                }
+            }
+        }
+
+        if (merged) {
+            group_bbs.assign(bbs.size(), BoundingBox{});
+            for (size_t i = 0; i < bbs.size(); ++i)
+                group_bbs[find(i)].merge(bbs[i]);
+        }
+    }
+
+    std::vector<std::vector<size_t>> ret;
+    std::vector<size_t> group_ids(bbs.size());
+    for (size_t i = 0; i < bbs.size(); ++i) {
+        size_t root = find(i);
+        if (root == i) {
+            group_ids[i] = ret.size();
+            ret.emplace_back();
+        }
+        ret[group_ids[root]].emplace_back(i);
+    }
+
+    return ret;
+}
+
 // Part of the pad configuration that is used for 3D geometry generation
 struct PadConfig3D {
     double thickness, height, wing_height, slope;
@@ -389,28 +466,36 @@ indexed_triangle_set create_outer_pad_geometry(const ExPolygons & skeleton,
                                                const PadConfig3D &cfg,
                                                ThrowOnCancel      thr)
 {
-    indexed_triangle_set ret;
+    std::vector<indexed_triangle_set> parts(skeleton.size());
 
-    for (const ExPolygon &pad_part : skeleton) {
-        ExPolygon top_poly{pad_part};
-        ExPolygon bottom_poly =
-            offset_contour_only(pad_part, -scaled(cfg.bottom_offset()));
+    execution::for_each(ex_tbb, size_t(0), skeleton.size(),
+        [&skeleton, &cfg, &thr, &parts](size_t i) {
+            const ExPolygon &pad_part = skeleton[i];
+            indexed_triangle_set &ret = parts[i];
 
-        if (bottom_poly.empty()) continue;
-        thr();
-        
-        double z_min = -cfg.height, z_max = 0;
-        its_merge(ret, walls(top_poly.contour, bottom_poly.contour, z_max, z_min));
+            ExPolygon top_poly{pad_part};
+            ExPolygon bottom_poly =
+                offset_contour_only(pad_part, -scaled(cfg.bottom_offset()));
 
-        if (cfg.wing_height > 0. && add_cavity(ret, top_poly, cfg, thr))
-            z_max = -cfg.wing_height;
+            if (bottom_poly.empty()) return;
+            thr();
 
-        for (auto &h : bottom_poly.holes)
-            its_merge(ret, straight_walls(h, z_max, z_min));
-        
-        its_merge(ret, triangulate_expolygon_3d(bottom_poly, z_min, NORMALS_DOWN));
-        its_merge(ret, triangulate_expolygon_3d(top_poly, NORMALS_UP));
-    }
+            double z_min = -cfg.height, z_max = 0;
+            its_merge(ret, walls(top_poly.contour, bottom_poly.contour, z_max, z_min));
+
+            if (cfg.wing_height > 0. && add_cavity(ret, top_poly, cfg, thr))
+                z_max = -cfg.wing_height;
+
+            for (auto &h : bottom_poly.holes)
+                its_merge(ret, straight_walls(h, z_max, z_min));
+
+            its_merge(ret, triangulate_expolygon_3d(bottom_poly, z_min, NORMALS_DOWN));
+            its_merge(ret, triangulate_expolygon_3d(top_poly, NORMALS_UP));
+        }, 1 /* granularity */);
+
+    indexed_triangle_set ret;
+    for (indexed_triangle_set &part : parts)
+        its_merge(ret, std::move(part));
 
     return ret;
 }
@@ -419,19 +504,27 @@ indexed_triangle_set create_inner_pad_geometry(const ExPolygons & skeleton,
                                                const PadConfig3D &cfg,
                                                ThrowOnCancel      thr)
 {
-    indexed_triangle_set ret;
+    std::vector<indexed_triangle_set> parts(skeleton.size());
 
     double z_max = 0., z_min = -cfg.height;
-    for (const ExPolygon &pad_part : skeleton) {
-        thr();
-        its_merge(ret, straight_walls(pad_part.contour, z_max, z_min));
+    execution::for_each(ex_tbb, size_t(0), skeleton.size(),
+        [&skeleton, &thr, &parts, z_max, z_min](size_t i) {
+            const ExPolygon &pad_part = skeleton[i];
+            indexed_triangle_set &ret = parts[i];
 
-        for (auto &h : pad_part.holes)
-            its_merge(ret, straight_walls(h, z_max, z_min));
-    
-        its_merge(ret, triangulate_expolygon_3d(pad_part, z_min, NORMALS_DOWN));
-        its_merge(ret, triangulate_expolygon_3d(pad_part, z_max, NORMALS_UP));
-    }
+            thr();
+            its_merge(ret, straight_walls(pad_part.contour, z_max, z_min));
+
+            for (auto &h : pad_part.holes)
+                its_merge(ret, straight_walls(h, z_max, z_min));
+
+            its_merge(ret, triangulate_expolygon_3d(pad_part, z_min, NORMALS_DOWN));
+            its_merge(ret, triangulate_expolygon_3d(pad_part, z_max, NORMALS_UP));
+        }, 1 /* granularity */);
+
+    indexed_triangle_set ret;
+    for (indexed_triangle_set &part : parts)
+        its_merge(ret, std::move(part));
 
     return ret;
 }
@@ -454,10 +547,10 @@ indexed_triangle_set create_pad_geometry(const PadSkeleton &skelet,
     return pg;
 }
 
-indexed_triangle_set create_pad_geometry(const ExPolygons &supp_bp,
-                                         const ExPolygons &model_bp,
-                                         const PadConfig & cfg,
-                                         ThrowOnCancel     thr)
+PadSkeleton create_pad_skeleton(const ExPolygons &supp_bp,
+                                const ExPolygons &model_bp,
+                                const PadConfig & cfg,
+                                ThrowOnCancel     thr)
 {
     PadSkeleton skelet;
 
@@ -469,6 +562,45 @@ indexed_triangle_set create_pad_geometry(const ExPolygons &supp_bp,
     } else
         skelet = BelowPadSkeleton(supp_bp, model_bp, cfg, thr);
 
+    return skelet;
+}
+
+indexed_triangle_set create_pad_geometry(const ExPolygons &supp_bp,
+                                         const ExPolygons &model_bp,
+                                         const PadConfig & cfg,
+                                         ThrowOnCancel     thr)
+{
+    // The footprints are split into clusters far enough from each other for
+    // their pad parts not to touch. The skeletons of the clusters are
+    // created in parallel, each with clipper operations on its own
+    // footprints only.
+    auto bbs = reserve_vector<BoundingBox>(supp_bp.size() + model_bp.size());
+    for (auto &ep : supp_bp) bbs.emplace_back(get_extents(ep.contour));
+    for (auto &ep : model_bp) bbs.emplace_back(get_extents(ep.contour));
+
+    std::vector<std::vector<size_t>> clusters =
+        cluster_by_proximity(bbs, scaled(get_cluster_distance(cfg)));
+
+    std::vector<PadSkeleton> skeletons(clusters.size());
+    execution::for_each(ex_tbb, size_t(0), clusters.size(),
+        [&supp_bp, &model_bp, &cfg, &thr, &clusters, &skeletons](size_t i) {
+            ExPolygons supp, model;
+            for (size_t idx : clusters[i]) {
+                if (idx < supp_bp.size())
+                    supp.emplace_back(supp_bp[idx]);
+                else
+                    model.emplace_back(model_bp[idx - supp_bp.size()]);
+            }
+
+            skeletons[i] = create_pad_skeleton(supp, model, cfg, thr);
+        }, 1 /* granularity */);
+
+    PadSkeleton skelet;
+    for (PadSkeleton &s : skeletons) {
+        append(skelet.outer, std::move(s.outer));
+        append(skelet.inner, std::move(s.inner));
+    }
+
     return create_pad_geometry(skelet, cfg, thr);
 }
 
@@ -494,12 +626,32 @@ void pad_blueprint(const indexed_triangle_set &mesh,
             for(ExPolygon& ep : exss) tmp.emplace_back(std::move(ep));
         }
 
-    ExPolygons utmp = union_ex(tmp);
+    // Only the footprints with overlapping bounding boxes need to be united,
+    // the groups of them are united in parallel.
+    auto bbs = reserve_vector<BoundingBox>(tmp.size());
+    for (const ExPolygon &e : tmp) bbs.emplace_back(get_extents(e.contour));
 
-    for(auto& o : utmp) {
-        auto&& smp = o.simplify(scaled<double>(0.1));
-        output.insert(output.end(), smp.begin(), smp.end());
-    }
+    std::vector<std::vector<size_t>> clusters = cluster_by_proximity(bbs, 0);
+
+    std::vector<ExPolygons> utmp(clusters.size());
+    execution::for_each(ex_tbb, size_t(0), clusters.size(),
+        [&tmp, &clusters, &utmp, &thrfn](size_t i) {
+            thrfn();
+
+            ExPolygons cluster;
+            cluster.reserve(clusters[i].size());
+            for (size_t idx : clusters[i])
+                cluster.emplace_back(std::move(tmp[idx]));
+
+            for (auto &o : union_ex(cluster)) {
+                auto &&smp = o.simplify(scaled<double>(0.1));
+                utmp[i].insert(utmp[i].end(), smp.begin(), smp.end());
+            }
+        }, 1 /* granularity */);
+
+    for (ExPolygons &u : utmp)
+        output.insert(output.end(), std::make_move_iterator(u.begin()),
+                      std::make_move_iterator(u.end()));
 }
 
 void pad_blueprint(const indexed_triangle_set &mesh,
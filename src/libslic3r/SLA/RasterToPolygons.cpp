@@ -24,6 +24,9 @@ template<> struct _RasterTraits<Slic3r::sla::RasterGrayscaleAA> {
     // Number of rows and cols of the raster
     static size_t rows(const Rst &rst) { return rst.resolution().height_px; }
     static size_t cols(const Rst &rst) { return rst.resolution().width_px; }
+
+    // The pixels of a row, stored continuously
+    static const uint8_t *row(const Rst &rst, size_t row) { return rst.row(row); }
 };
 
 } // namespace Slic3r::marchsq
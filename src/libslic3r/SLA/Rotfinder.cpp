@@ -2,14 +2,16 @@
 ///|/
 ///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
 ///|/
+#include <algorithm>
+#include <atomic>
 #include <limits>
+#include <numeric>
 
 #include <libslic3r/SLA/Rotfinder.hpp>
 
 #include <libslic3r/Execution/ExecutionTBB.hpp>
 #include <libslic3r/Execution/ExecutionSeq.hpp>
 
-#include <libslic3r/Optimize/BruteforceOptimizer.hpp>
 #include <libslic3r/Optimize/NLoptOptimizer.hpp>
 
 #include "libslic3r/SLAPrint.hpp"
@@ -36,14 +38,6 @@ std::array<Vec3f, 3> get_triangle_vertices(const TriangleMesh &mesh,
             mesh.its.vertices[face(2)]};
 }
 
-std::array<Vec3f, 3> get_transformed_triangle(const TriangleMesh &mesh,
-                                              const Transform3f & tr,
-                                              size_t              faceidx)
-{
-    const auto &tri = get_triangle_vertices(mesh, faceidx);
-    return {tr * tri[0], tr * tri[1], tr * tri[2]};
-}
-
 template<class T> Vec<3, T> normal(const std::array<Vec<3, T>, 3> &tri)
 {
     Vec<3, T> U = tri[1] - tri[0];
@@ -51,17 +45,6 @@ template<class T> Vec<3, T> normal(const std::array<Vec<3, T>, 3> &tri)
     return U.cross(V).normalized();
 }
 
-template<class T, class AccessFn>
-T sum_score(AccessFn &&accessfn, size_t facecount, size_t Nthreads)
-{
-    T  initv         = 0.;
-    auto   mergefn   = [](T a, T b) { return a + b; };
-    size_t grainsize = facecount / Nthreads;
-    size_t from = 0, to = facecount;
-
-    return execution::reduce(ex_tbb, from, to, initv, mergefn, accessfn, grainsize);
-}
-
 // Get area and normal of a triangle
 struct Facestats {
     Vec3f  normal;
@@ -77,106 +60,212 @@ struct Facestats {
     }
 };
 
-// Try to guess the number of support points needed to support a mesh
-double get_misalginment_score(const TriangleMesh &mesh, const Transform3f &tr)
-{
-    if (mesh.its.vertices.empty()) return NaNd;
+// Face normals binned on the Gaussian sphere. The bins are the cells of a cube
+// map around the sphere. The scores below depend only on the normals and the
+// areas of the faces, so a rotation can be scored over the non-empty bins
+// instead of over all the faces of the mesh. Each bin keeps the sums of the
+// weighted normals of its faces.
+class NormalHistogram {
+public:
+    static constexpr int BinsPerSide = 32;
+
+    struct Bin {
+        Vec3d  area_normal      = Vec3d::Zero(); // sum of area * normal
+        Vec3d  sqrt_area_normal = Vec3d::Zero(); // sum of sqrt(area) * normal
+        double sqrt_area        = 0.;            // sum of sqrt(area)
+    };
 
-    auto accessfn = [&mesh, &tr](size_t fi) {
-        Facestats fc{get_transformed_triangle(mesh, tr, fi)};
+    explicit NormalHistogram(const TriangleMesh &mesh)
+        : m_facecount{mesh.its.indices.size()}
+    {
+        std::vector<Bin> bins(6 * BinsPerSide * BinsPerSide);
+        for (size_t fi = 0; fi < m_facecount; ++fi) {
+            Facestats fc{get_triangle_vertices(mesh, fi)};
+            if (fc.area <= 0.)
+                continue;
+
+            Vec3d  n  = fc.normal.cast<double>();
+            double sa = std::sqrt(fc.area);
+            Bin   &bin = bins[bin_index(n)];
+            bin.area_normal      += fc.area * n;
+            bin.sqrt_area_normal += sa * n;
+            bin.sqrt_area        += sa;
+        }
 
-        float score = fc.area
-                      * (std::abs(fc.normal.dot(Vec3f::UnitX()))
-                         + std::abs(fc.normal.dot(Vec3f::UnitY()))
-                         + std::abs(fc.normal.dot(Vec3f::UnitZ())));
+        for (const Bin &bin : bins)
+            if (bin.sqrt_area > 0.)
+                m_bins.emplace_back(bin);
+    }
 
-        // We should score against the alignment with the reference planes
-        return scaled<int_fast64_t>(score);
-    };
+    const std::vector<Bin> &bins() const { return m_bins; }
+
+    // The number of faces of the mesh, including the degenerate ones
+    size_t facecount() const { return m_facecount; }
+
+private:
+    static size_t bin_index(const Vec3d &n)
+    {
+        int axis;
+        n.cwiseAbs().maxCoeff(&axis);
+        double d = std::abs(n(axis));
+
+        auto cell = [d](double c) {
+            return std::clamp(int((c / d + 1.) * BinsPerSide / 2), 0, BinsPerSide - 1);
+        };
+
+        size_t side = 2 * axis + (n(axis) < 0.);
+        return (side * BinsPerSide + cell(n((axis + 1) % 3))) * BinsPerSide +
+               cell(n((axis + 2) % 3));
+    }
 
-    size_t facecount = mesh.its.indices.size();
-    size_t Nthreads  = std::thread::hardware_concurrency();
-    double S = unscaled(sum_score<int_fast64_t>(accessfn, facecount, Nthreads));
+    std::vector<Bin> m_bins;
+    size_t           m_facecount = 0;
+};
+
+// Try to guess the number of support points needed to support a mesh
+double get_misalginment_score(const NormalHistogram &normals, const Transform3f &tr)
+{
+    if (normals.facecount() == 0) return NaNd;
+
+    // The score is linear in the normals that share the signs of their
+    // coordinates, the faces of a bin are summed up exactly unless the bin
+    // crosses one of the reference planes.
+    Matrix3d R = tr.linear().cast<double>();
+    double   S = 0.;
+    for (const NormalHistogram::Bin &bin : normals.bins()) {
+        // We should score against the alignment with the reference planes
+        S += (R * bin.area_normal).cwiseAbs().sum();
+    }
 
-    return S / facecount;
+    return S / normals.facecount();
 }
 
-// The score function for a particular face
-inline double get_supportedness_score(const Facestats &fc)
+// The score function for a face with a particular normal and unit area
+inline double get_supportedness_score(const Vec3f &normal)
 {
     // Simply get the angle (acos of dot product) between the face normal and
     // the DOWN vector.
-    float cosphi = fc.normal.dot(DOWN);
+    float cosphi = std::clamp(normal.dot(DOWN), -1.f, 1.f);
     float phi = 1.f - std::acos(cosphi) / float(PI);
 
     // Make the huge slopes more significant than the smaller slopes
     phi = phi * phi * phi;
 
+    return POINTS_PER_UNIT_AREA * phi;
+}
+
+// The score function for a particular face
+inline double get_supportedness_score(const Facestats &fc)
+{
     // Multiply with the square root of face area of the current face,
     // the area is less important as it grows.
     // This makes many smaller overhangs a bigger impact.
-    return std::sqrt(fc.area) * POINTS_PER_UNIT_AREA * phi;
+    return std::sqrt(fc.area) * get_supportedness_score(fc.normal);
 }
 
-// Try to guess the number of support points needed to support a mesh
-double get_supportedness_score(const TriangleMesh &mesh, const Transform3f &tr)
+// Sum of the scores of all the faces, the faces of a bin are scored with
+// the mean of their normals.
+double sum_supportedness_score(const NormalHistogram &normals, const Transform3f &tr)
 {
-    if (mesh.its.vertices.empty()) return NaNd;
+    Matrix3d R = tr.linear().cast<double>();
+    double   S = 0.;
+    for (const NormalHistogram::Bin &bin : normals.bins()) {
+        Vec3f n = (R * bin.sqrt_area_normal).normalized().cast<float>();
+        S += bin.sqrt_area * get_supportedness_score(n);
+    }
 
-    auto accessfn = [&mesh, &tr](size_t fi) {
-        Facestats fc{get_transformed_triangle(mesh, tr, fi)};
-        return scaled<int_fast64_t>(get_supportedness_score(fc));
-    };
+    return S;
+}
 
-    size_t facecount = mesh.its.indices.size();
-    size_t Nthreads  = std::thread::hardware_concurrency();
-    double S = unscaled(sum_score<int_fast64_t>(accessfn, facecount, Nthreads));
+// Try to guess the number of support points needed to support a mesh
+double get_supportedness_score(const NormalHistogram &normals, const Transform3f &tr)
+{
+    if (normals.facecount() == 0) return NaNd;
 
-    return S / facecount;
+    return sum_supportedness_score(normals, tr) / normals.facecount();
 }
 
-// Find transformed mesh ground level without copy and with parallel reduce.
-float find_ground_level(const TriangleMesh &mesh,
-                         const Transform3f & tr,
-                         size_t              threads)
+// Vertex z coordinate after the rotation
+inline float rotated_z(const Transform3f &tr, const Vec3f &v)
 {
-    size_t vsize = mesh.its.vertices.size();
+    return tr.linear().row(Z).dot(v) + tr.translation().z();
+}
+
+// The faces which may touch the print bed, grouped by their first vertex.
+// Only the faces of the vertices close to the ground level are visited when
+// scoring a rotation. The ground level itself is found on the convex hull.
+struct FloorStats {
+    const TriangleMesh    &mesh;
+    const TriangleMesh    &chull;
+    std::vector<Facestats> faces;
+    std::vector<size_t>    vertex_face_offsets;
+    std::vector<size_t>    vertex_faces;
+
+    FloorStats(const TriangleMesh &m, const TriangleMesh &ch)
+        : mesh{m}, chull{ch}, vertex_face_offsets(m.its.vertices.size() + 1, 0)
+    {
+        const auto &indices = mesh.its.indices;
+        faces.reserve(indices.size());
+        for (size_t fi = 0; fi < indices.size(); ++fi) {
+            faces.emplace_back(get_triangle_vertices(mesh, fi));
+            ++vertex_face_offsets[indices[fi](0) + 1];
+        }
 
-    auto minfn = [](float a, float b) { return std::min(a, b); };
+        std::partial_sum(vertex_face_offsets.begin(), vertex_face_offsets.end(),
+                         vertex_face_offsets.begin());
 
-    auto accessfn = [&mesh, &tr] (size_t vi) {
-        return (tr * mesh.its.vertices[vi]).z();
-    };
+        vertex_faces.resize(indices.size());
+        std::vector<size_t> pos(vertex_face_offsets.begin(), vertex_face_offsets.end() - 1);
+        for (size_t fi = 0; fi < indices.size(); ++fi)
+            vertex_faces[pos[indices[fi](0)]++] = fi;
+    }
+};
 
+// Find transformed mesh ground level without copy.
+float find_ground_level(const TriangleMesh &chull, const Transform3f &tr)
+{
     auto zmin = std::numeric_limits<float>::max();
-    size_t granularity = vsize / threads;
-    return execution::reduce(ex_tbb, size_t(0), vsize, zmin, minfn, accessfn, granularity);
+    for (const Vec3f &v : chull.its.vertices)
+        zmin = std::min(zmin, rotated_z(tr, v));
+
+    return zmin;
 }
 
-double get_supportedness_onfloor_score(const TriangleMesh &mesh,
-                                       const Transform3f  &tr)
+double get_supportedness_onfloor_score(const NormalHistogram &normals,
+                                       const FloorStats      &floor,
+                                       const Transform3f     &tr)
 {
-    if (mesh.its.vertices.empty()) return NaNd;
+    if (normals.facecount() == 0) return NaNd;
 
-    size_t Nthreads = std::thread::hardware_concurrency();
-
-    float zmin = find_ground_level(mesh, tr, Nthreads);
+    float zmin = find_ground_level(floor.chull, tr);
     float zlvl = zmin + 0.1f; // Set up a slight tolerance from z level
 
-    auto accessfn = [&mesh, &tr, zlvl](size_t fi) {
-        std::array<Vec3f, 3> tri = get_transformed_triangle(mesh, tr, fi);
-        Facestats fc{tri};
-
-        if (tri[0].z() <= zlvl && tri[1].z() <= zlvl && tri[2].z() <= zlvl)
-            return -2 * fc.area * POINTS_PER_UNIT_AREA;
-
-        return get_supportedness_score(fc);
-    };
-
-    size_t facecount = mesh.its.indices.size();
-    double S = unscaled(sum_score<int_fast64_t>(accessfn, facecount, Nthreads));
+    const auto &vertices = floor.mesh.its.vertices;
+    std::vector<char> on_floor(vertices.size());
+    for (size_t vi = 0; vi < vertices.size(); ++vi)
+        on_floor[vi] = rotated_z(tr, vertices[vi]) <= zlvl;
+
+    // The faces lying on the floor score negatively instead of their
+    // supportedness score included in the sum of all the faces.
+    double S = sum_supportedness_score(normals, tr);
+    for (size_t vi = 0; vi < vertices.size(); ++vi) {
+        if (!on_floor[vi])
+            continue;
+
+        for (size_t i = floor.vertex_face_offsets[vi];
+             i < floor.vertex_face_offsets[vi + 1]; ++i) {
+            size_t      fi   = floor.vertex_faces[i];
+            const auto &face = floor.mesh.its.indices[fi];
+            if (on_floor[face(1)] && on_floor[face(2)]) {
+                const Facestats &fc = floor.faces[fi];
+                Facestats rotated   = fc;
+                rotated.normal      = tr.linear() * fc.normal;
+                S -= get_supportedness_score(rotated) + 2 * fc.area * POINTS_PER_UNIT_AREA;
+            }
+        }
+    }
 
-    return S / facecount;
+    return S / normals.facecount();
 }
 
 using XYRotation = std::array<double, 2>;
@@ -206,9 +295,8 @@ inline bool is_on_floor(const SLAPrintObjectConfig &cfg)
 }
 
 // collect the rotations for each face of the convex hull
-std::vector<XYRotation> get_chull_rotations(const TriangleMesh &mesh, size_t max_count)
+std::vector<XYRotation> get_chull_rotations(TriangleMesh &chull, size_t max_count)
 {
-    TriangleMesh chull = mesh.convex_hull_3d();
     double chull2d_area = chull.convex_hull().area();
     double area_threshold = chull2d_area / (scaled<double>(1e3) * scaled(1.));
 
@@ -284,6 +372,25 @@ std::array<double, N> find_min_score(Fn &&fn, It from, It to, StopCond &&stopfn)
     return ret;
 }
 
+// The grid of rotations around the X and Y axes sampled by
+// opt::AlgBruteForce, in the same order. Scoring the rotations with
+// find_min_score() gives the same result as the optimizer, but the
+// rotations are scored in parallel.
+std::vector<XYRotation> get_grid_rotations(size_t max_tries)
+{
+    size_t gridsize = std::sqrt(max_tries); // 2D grid has gridsize^2 calls
+    if (gridsize < 2)
+        return {};
+
+    double step = 2. * PI / (gridsize - 1);
+    auto   ret  = reserve_vector<XYRotation>(gridsize * gridsize);
+    for (size_t y = 0; y < gridsize; ++y)
+        for (size_t x = 0; x < gridsize; ++x)
+            ret.push_back({-PI + x * step, -PI + y * step});
+
+    return ret;
+}
+
 } // namespace
 
 
@@ -292,7 +399,9 @@ template<unsigned MAX_ITER>
 struct RotfinderBoilerplate {
     static constexpr unsigned MAX_TRIES = MAX_ITER;
 
-    int status = 0, prev_status = 0;
+    std::atomic<int> status = 0;
+    int prev_status = 0;
+    execution::BlockingMutex<ExecutionTBB> status_mutex;
     TriangleMesh mesh;
     unsigned max_tries;
     const RotOptimizeParams &params;
@@ -317,17 +426,20 @@ struct RotfinderBoilerplate {
         , params{p}
     {}
 
+    // Called by the evaluations of the rotations, which run in parallel.
     void statusfn() {
-        int s = status * 100 / max_tries;
-        if (s != prev_status) {
+        int s = status++ * 100 / std::max(max_tries, 1u);
+        std::lock_guard lk{status_mutex};
+        if (s > prev_status) {
             params.statuscb()(s);
             prev_status = s;
         }
-
-        ++status;
     }
 
-    bool stopcond() { return ! params.statuscb()(-1); }
+    bool stopcond() {
+        std::lock_guard lk{status_mutex};
+        return ! params.statuscb()(-1);
+    }
 };
 
 Vec2d find_best_misalignment_rotation(const ModelObject &      mo,
@@ -335,27 +447,23 @@ Vec2d find_best_misalignment_rotation(const ModelObject &      mo,
 {
     RotfinderBoilerplate<1000> bp{mo, params};
 
-    // Preparing the optimizer.
-    size_t gridsize = std::sqrt(bp.max_tries);
-    opt::Optimizer<opt::AlgBruteForce> solver(
-        opt::StopCriteria{}.max_iterations(bp.max_tries)
-                           .stop_condition([&bp] { return bp.stopcond(); }),
-        gridsize
-    );
+    NormalHistogram normals{bp.mesh};
 
     // We are searching rotations around only two axes x, y. Thus the
     // problem becomes a 2 dimensional optimization task.
-    // We can specify the bounds for a dimension in the following way:
-    auto bounds = opt::bounds({ {-PI, PI}, {-PI, PI} });
+    std::vector<XYRotation> inputs = get_grid_rotations(bp.max_tries);
 
-    auto result = solver.to_max().optimize(
-        [&bp] (const XYRotation &rot)
-        {
-            bp.statusfn();
-            return get_misalginment_score(bp.mesh, to_transform3f(rot));
-        }, opt::initvals({0., 0.}), bounds);
+    // The best alignment has the highest score.
+    auto objfn = [&bp, &normals](const XYRotation &rot) {
+        bp.statusfn();
+        return -get_misalginment_score(normals, to_transform3f(rot));
+    };
+
+    XYRotation rot = find_min_score<2>(objfn, inputs.begin(), inputs.end(), [&bp] {
+        return bp.stopcond();
+    });
 
-    return {result.optimum[0], result.optimum[1]};
+    return {rot[0], rot[1]};
 }
 
 Vec2d find_least_supports_rotation(const ModelObject &      mo,
@@ -369,21 +477,26 @@ Vec2d find_least_supports_rotation(const ModelObject &      mo,
 
     pocfg.apply(mo.config.get());
 
+    NormalHistogram normals{bp.mesh};
+
     XYRotation rot;
 
     // Different search methods have to be used depending on the model elevation
     if (is_on_floor(pocfg)) {
 
-        std::vector<XYRotation> inputs = get_chull_rotations(bp.mesh, bp.max_tries);
+        TriangleMesh chull = bp.mesh.convex_hull_3d();
+        FloorStats   floor{bp.mesh, chull};
+
+        std::vector<XYRotation> inputs = get_chull_rotations(chull, bp.max_tries);
         bp.max_tries = inputs.size();
 
         // If the model can be placed on the bed directly, we only need to
         // check the 3D convex hull face rotations.
 
-        auto objfn = [&bp](const XYRotation &rot) {
+        auto objfn = [&bp, &normals, &floor](const XYRotation &rot) {
             bp.statusfn();
             Transform3f tr = to_transform3f(rot);
-            return get_supportedness_onfloor_score(bp.mesh, tr);
+            return get_supportedness_onfloor_score(normals, floor, tr);
         };
 
         rot = find_min_score<2>(objfn, inputs.begin(), inputs.end(), [&bp] {
@@ -391,48 +504,40 @@ Vec2d find_least_supports_rotation(const ModelObject &      mo,
         });
 
     } else {
-        // Preparing the optimizer.
-        size_t gridsize = std::sqrt(bp.max_tries); // 2D grid has gridsize^2 calls
-        opt::Optimizer<opt::AlgBruteForce> solver(
-            opt::StopCriteria{}.max_iterations(bp.max_tries)
-                               .stop_condition([&bp] { return bp.stopcond(); }),
-            gridsize
-        );
-
         // We are searching rotations around only two axes x, y. Thus the
         // problem becomes a 2 dimensional optimization task.
-        // We can specify the bounds for a dimension in the following way:
-        auto bounds = opt::bounds({ {-PI, PI}, {-PI, PI} });
-
-        auto result = solver.to_min().optimize(
-            [&bp] (const XYRotation &rot)
-            {
-                bp.statusfn();
-                return get_supportedness_score(bp.mesh, to_transform3f(rot));
-            }, opt::initvals({0., 0.}), bounds);
-
-        // Save the result
-        rot = result.optimum;
+        std::vector<XYRotation> inputs = get_grid_rotations(bp.max_tries);
+
+        auto objfn = [&bp, &normals](const XYRotation &rot) {
+            bp.statusfn();
+            return get_supportedness_score(normals, to_transform3f(rot));
+        };
+
+        rot = find_min_score<2>(objfn, inputs.begin(), inputs.end(), [&bp] {
+            return bp.stopcond();
+        });
     }
 
     return {rot[0], rot[1]};
 }
 
-inline BoundingBoxf3 bounding_box_with_tr(const indexed_triangle_set &its,
-                                          const Transform3f &tr)
+// Height of the convex hull after the rotation, only the z coordinates of the
+// hull vertices are needed.
+inline float z_height_with_tr(const indexed_triangle_set &chull,
+                              const Transform3f &tr)
 {
-    if (its.vertices.empty())
-        return {};
-
-    Vec3f bmin = tr * its.vertices.front(), bmax = tr * its.vertices.front();
-
-    for (const Vec3f &p : its.vertices) {
-        Vec3f pp = tr * p;
-        bmin = pp.cwiseMin(bmin);
-        bmax = pp.cwiseMax(bmax);
+    if (chull.vertices.empty())
+        return 0.f;
+
+    float zmin = std::numeric_limits<float>::max();
+    float zmax = std::numeric_limits<float>::lowest();
+    for (const Vec3f &p : chull.vertices) {
+        float z = rotated_z(tr, p);
+        zmin = std::min(zmin, z);
+        zmax = std::max(zmax, z);
     }
 
-    return {bmin.cast<double>(), bmax.cast<double>()};
+    return zmax - zmin;
 }
 
 Vec2d find_min_z_height_rotation(const ModelObject &mo,
@@ -454,7 +559,7 @@ Vec2d find_min_z_height_rotation(const ModelObject &mo,
     for (size_t fi = 0; fi < chull.its.indices.size(); ++fi) {
         Facestats fc{get_triangle_vertices(chull, fi)};
 
-        auto q = Eigen::Quaternionf{}.FromTwoVectors(fc.normal, DOWN);
+        auto q = Eigen::Quaternionf{}.FromTwoVectors(fc.normal, sla::DOWN.cast<float>());
         XYRotation rot = from_transform3f(Transform3f::Identity() * q);
 
         auto it = std::lower_bound(inputs.begin(), inputs.end(), rot, rotcmp);
@@ -469,7 +574,7 @@ Vec2d find_min_z_height_rotation(const ModelObject &mo,
     auto objfn = [&bp, &chull](const XYRotation &rot) {
         bp.statusfn();
         Transform3f tr = to_transform3f(rot);
-        return bounding_box_with_tr(chull.its, tr).size().z();
+        return z_height_with_tr(chull.its, tr);
     };
 
     XYRotation rot = find_min_score<2>(objfn, inputs.begin(), inputs.end(), [&bp] {
@@ -479,4 +584,52 @@ Vec2d find_min_z_height_rotation(const ModelObject &mo,
     return {rot[0], rot[1]};
 }
 
+std::vector<Vec2d> find_rotations(const std::vector<const ModelObject *> &objects,
+                                  const RotOptimizeFn                   &findfn,
+                                  const RotOptimizeParams               &params)
+{
+    std::vector<Vec2d> ret(objects.size(), Vec2d::Zero());
+    if (objects.empty())
+        return ret;
+
+    // Progress of each object and the overall progress reported so far.
+    std::vector<int> progress(objects.size(), 0);
+    int progress_sum = 0, status = 0;
+    execution::BlockingMutex<ExecutionTBB> status_mutex;
+
+    auto set_progress = [&](size_t idx, int s) {
+        std::lock_guard lk{status_mutex};
+        if (s >= 0 && s > progress[idx]) {
+            progress_sum += s - progress[idx];
+            progress[idx] = s;
+            int st = progress_sum / int(objects.size());
+            if (st > status) {
+                status = st;
+                return params.statuscb()(st);
+            }
+        }
+
+        return params.statuscb()(-1);
+    };
+
+    execution::for_each(ex_tbb, size_t(0), objects.size(),
+        [&objects, &findfn, &params, &ret, &set_progress](size_t idx) {
+            if (!objects[idx]) {
+                set_progress(idx, 100);
+                return;
+            }
+
+            if (!set_progress(idx, -1))
+                return;
+
+            RotOptimizeParams p = params;
+            p.statucb([&set_progress, idx](int s) { return set_progress(idx, s); });
+
+            ret[idx] = findfn(*objects[idx], p);
+            set_progress(idx, 100);
+        }, 1 /* granularity */);
+
+    return ret;
+}
+
 }} // namespace Slic3r::sla
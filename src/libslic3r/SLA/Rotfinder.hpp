@@ -7,6 +7,7 @@
 
 #include <functional>
 #include <array>
+#include <vector>
 
 #include <libslic3r/Point.hpp>
 
@@ -70,6 +71,20 @@ Vec2d find_least_supports_rotation(const ModelObject &modelobj,
 Vec2d find_min_z_height_rotation(const ModelObject &mo,
                                  const RotOptimizeParams &params = {});
 
+using RotOptimizeFn = std::function<Vec2d(const ModelObject &, const RotOptimizeParams &)>;
+
+/**
+  * Find the rotations of a batch of objects with one of the functions above.
+  * The objects are processed in parallel. The status callback of the params
+  * receives the progress of the whole batch, it may be called from any thread
+  * but never concurrently. The rotation of a null object is zero.
+  *
+  * @return Returns the rotations around the x and y axes for each object
+  */
+std::vector<Vec2d> find_rotations(const std::vector<const ModelObject *> &objects,
+                                  const RotOptimizeFn &findfn,
+                                  const RotOptimizeParams &params = {});
+
 } // namespace sla
 } // namespace Slic3r
 
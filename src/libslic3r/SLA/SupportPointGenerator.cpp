@@ -16,9 +16,13 @@
 #include "MinAreaBoundingBox.hpp"
 #include "libslic3r.h"
 
+#include <atomic>
 #include <iostream>
+#include <numeric>
 #include <random>
 
+#include <boost/functional/hash.hpp>
+
 namespace Slic3r {
 namespace sla {
 
@@ -67,6 +71,19 @@ SupportPointGenerator::SupportPointGenerator(
     execute(slices, heights);
 }
 
+SupportPointGenerator::SupportPointGenerator(
+        const AABBMesh &emesh,
+        Layers &        layers,
+        const Config &  config,
+        std::function<void(void)> throw_on_cancel,
+        std::function<void(int)>  statusfn)
+    : SupportPointGenerator(emesh, config, throw_on_cancel, statusfn)
+{
+    std::random_device rd;
+    m_rng.seed(rd());
+    execute(layers);
+}
+
 SupportPointGenerator::SupportPointGenerator(
         const AABBMesh &emesh,
         const SupportPointGenerator::Config &config,
@@ -82,7 +99,13 @@ SupportPointGenerator::SupportPointGenerator(
 void SupportPointGenerator::execute(const std::vector<ExPolygons> &slices,
                                     const std::vector<float> &     heights)
 {
-    process(slices, heights);
+    Layers layers = make_layers(slices, heights, m_throw_on_cancel);
+    execute(layers);
+}
+
+void SupportPointGenerator::execute(Layers &layers)
+{
+    process(layers);
     project_onto_mesh(m_output);
 }
 
@@ -115,7 +138,7 @@ void SupportPointGenerator::project_onto_mesh(std::vector<sla::SupportPoint>& po
     }, gransize);
 }
 
-static std::vector<SupportPointGenerator::MyLayer> make_layers(
+SupportPointGenerator::Layers SupportPointGenerator::make_layers(
     const std::vector<ExPolygons>& slices, const std::vector<float>& heights,
     std::function<void(void)> throw_on_cancel)
 {
@@ -225,77 +248,197 @@ static std::vector<SupportPointGenerator::MyLayer> make_layers(
     return layers;
 }
 
-void SupportPointGenerator::process(const std::vector<ExPolygons>& slices, const std::vector<float>& heights)
+size_t SupportPointGenerator::slices_hash(const std::vector<ExPolygons> &slices,
+                                          const std::vector<float> &     heights)
 {
-#ifdef SLA_SUPPORTPOINTGEN_DEBUG
-    std::vector<std::pair<ExPolygon, coord_t>> islands;
-#endif /* SLA_SUPPORTPOINTGEN_DEBUG */
+    size_t seed = slices.size();
+    for (float h : heights)
+        boost::hash_combine(seed, h);
+
+    for (const ExPolygons &expolys : slices) {
+        boost::hash_combine(seed, expolys.size());
+        for (const ExPolygon &expoly : expolys)
+            for (size_t i = 0; i <= expoly.holes.size(); ++ i) {
+                const Polygon &poly = i == 0 ? expoly.contour : expoly.holes[i - 1];
+                boost::hash_combine(seed, poly.size());
+                for (const Point &p : poly.points) {
+                    boost::hash_combine(seed, p.x());
+                    boost::hash_combine(seed, p.y());
+                }
+            }
+    }
 
-    std::vector<SupportPointGenerator::MyLayer> layers = make_layers(slices, heights, m_throw_on_cancel);
+    return seed;
+}
 
-    PointGrid3D point_grid;
-    point_grid.cell_size = Vec3f(10.f, 10.f, 10.f);
+float SupportPointGenerator::max_point_spacing() const
+{
+    //FIXME why?
+    const float density_horizontal = m_config.tear_pressure() / m_config.support_force();
+    return std::max(m_config.minimal_distance, 1.f / (5.f * density_horizontal));
+}
 
-    double increment = 100.0 / layers.size();
-    double status    = 0;
+std::vector<SupportPointGenerator::IslandChain>
+SupportPointGenerator::make_island_chains(Layers &layers) const
+{
+    std::vector<Structure*> islands;
+    std::vector<size_t>     layer_offsets;
+    layer_offsets.reserve(layers.size());
+    for (MyLayer &layer : layers) {
+        layer_offsets.emplace_back(islands.size());
+        for (Structure &s : layer.islands)
+            islands.emplace_back(&s);
+    }
 
-    for (unsigned int layer_id = 0; layer_id < layers.size(); ++ layer_id) {
-        SupportPointGenerator::MyLayer *layer_top     = &layers[layer_id];
-        SupportPointGenerator::MyLayer *layer_bottom  = (layer_id > 0) ? &layers[layer_id - 1] : nullptr;
-        std::vector<float>        support_force_bottom;
-        if (layer_bottom != nullptr) {
-            support_force_bottom.assign(layer_bottom->islands.size(), 0.f);
-            for (size_t i = 0; i < layer_bottom->islands.size(); ++ i)
-                support_force_bottom[i] = layer_bottom->islands[i].supports_force_total();
+    std::vector<size_t> parent(islands.size());
+    std::iota(parent.begin(), parent.end(), size_t(0));
+    auto find = [&parent](size_t i) {
+        while (parent[i] != i)
+            i = parent[i] = parent[parent[i]];
+        return i;
+    };
+    // The smaller index becomes the root, the roots are the first islands
+    // of the chains in the order of the layers.
+    auto unite = [&parent, &find](size_t i, size_t j) {
+        i = find(i);
+        j = find(j);
+        if (i != j)
+            parent[std::max(i, j)] = std::min(i, j);
+    };
+
+    // Islands linked by their overlaps.
+    for (size_t layer_id = 1; layer_id < layers.size(); ++ layer_id) {
+        const MyLayer &below = layers[layer_id - 1];
+        for (size_t i = 0; i < layers[layer_id].islands.size(); ++ i)
+            for (const Structure::Link &link : layers[layer_id].islands[i].islands_below)
+                unite(layer_offsets[layer_id] + i,
+                      layer_offsets[layer_id - 1] + size_t(link.island - below.islands.data()));
+    }
+
+    // Groups of linked islands whose points could collide. A point never
+    // leaves its island and the points collide only if they are closer than
+    // max_point_spacing(), so it is enough to inflate the bounding boxes.
+    std::vector<size_t> roots;
+    std::vector<BoundingBox> bboxes(islands.size());
+    for (size_t i = 0; i < islands.size(); ++ i) {
+        size_t root = find(i);
+        if (root == i)
+            roots.emplace_back(i);
+        bboxes[root].merge(islands[i]->bbox);
+    }
+
+    coord_t spacing = scaled(max_point_spacing()) + 1;
+    for (size_t root : roots)
+        bboxes[root].offset(spacing);
+
+    std::sort(roots.begin(), roots.end(), [&bboxes](size_t a, size_t b) {
+        return bboxes[a].min.x() < bboxes[b].min.x();
+    });
+    for (size_t i = 0; i < roots.size(); ++ i) {
+        const BoundingBox &bb = bboxes[roots[i]];
+        for (size_t j = i + 1; j < roots.size() && bboxes[roots[j]].min.x() <= bb.max.x(); ++ j)
+            if (bb.overlap(bboxes[roots[j]]))
+                unite(roots[i], roots[j]);
+    }
+
+    std::vector<IslandChain> chains;
+    std::vector<size_t>      chain_ids(islands.size());
+    for (size_t i = 0; i < islands.size(); ++ i) {
+        size_t root = find(i);
+        if (root == i) {
+            chain_ids[i] = chains.size();
+            chains.emplace_back();
         }
-        for (Structure &top : layer_top->islands)
-            for (Structure::Link &bottom_link : top.islands_below) {
-                Structure &bottom = *bottom_link.island;
-                //float centroids_dist = (bottom.centroid - top.centroid).norm();
-                // Penalization resulting from centroid offset:
-//                  bottom.supports_force *= std::min(1.f, 1.f - std::min(1.f, (1600.f * layer_height) * centroids_dist * centroids_dist / bottom.area));
-                float &support_force = support_force_bottom[&bottom - layer_bottom->islands.data()];
-//FIXME this condition does not reflect a bifurcation into a one large island and one tiny island well, it incorrectly resets the support force to zero.
-// One should rather work with the overlap area vs overhang area.
-//                support_force *= std::min(1.f, 1.f - std::min(1.f, 0.1f * centroids_dist * centroids_dist / bottom.area));
+        chains[chain_ids[root]].islands.emplace_back(islands[i]);
+    }
+
+    return chains;
+}
+
+void SupportPointGenerator::process_chain(IslandChain &chain) const
+{
+    chain.grid.cell_size = Vec3f(10.f, 10.f, 10.f);
+
+    // The layers may be left over from a previous run.
+    for (Structure *s : chain.islands) {
+        s->supports_force_this_layer = 0.f;
+        s->supports_force_inherited  = 0.f;
+    }
+
+    size_t below_begin = 0, begin = 0;
+    while (begin < chain.islands.size()) {
+        const MyLayer *layer = chain.islands[begin]->layer;
+        size_t end = begin;
+        while (end < chain.islands.size() && chain.islands[end]->layer == layer)
+            ++ end;
+
+        // Let's assign proper support force to each of the islands linked with
+        // the islands of the layer below. Only the islands right below this
+        // layer have any links above.
+        for (size_t i = below_begin; i < begin; ++ i) {
+            Structure &below = *chain.islands[i];
+            float below_support_force = below.supports_force_total();
+            float above_overlap_area  = 0.f;
+            for (const Structure::Link &above_link : below.islands_above) {
+                //FIXME this condition does not reflect a bifurcation into a one large island and one tiny island well, it incorrectly resets the support force to zero.
+                // One should rather work with the overlap area vs overhang area.
                 // Penalization resulting from increasing polygon area:
-                support_force *= std::min(1.f, 20.f * bottom.area / top.area);
-            }
-        // Let's assign proper support force to each of them:
-        if (layer_id > 0) {
-            for (Structure &below : layer_bottom->islands) {
-                float below_support_force = support_force_bottom[&below - layer_bottom->islands.data()];
-                float above_overlap_area = 0.f;
-                for (Structure::Link &above_link : below.islands_above)
-                    above_overlap_area += above_link.overlap_area;
-                for (Structure::Link &above_link : below.islands_above)
-                    above_link.island->supports_force_inherited += below_support_force * above_link.overlap_area / above_overlap_area;
+                below_support_force *= std::min(1.f, 20.f * below.area / above_link.island->area);
+                above_overlap_area  += above_link.overlap_area;
             }
+            for (const Structure::Link &above_link : below.islands_above)
+                above_link.island->supports_force_inherited += below_support_force * above_link.overlap_area / above_overlap_area;
         }
+
         // Now iterate over all polygons and append new points if needed.
-        for (Structure &s : layer_top->islands) {
+        for (size_t i = begin; i < end; ++ i) {
+            Structure &s = *chain.islands[i];
             // Penalization resulting from large diff from the last layer:
             s.supports_force_inherited /= std::max(1.f, 0.17f * (s.overhangs_area) / s.area);
 
-            add_support_points(s, point_grid);
+            add_support_points(s, chain);
         }
 
         m_throw_on_cancel();
 
-        status += increment;
-        m_statusfn(int(std::round(status)));
-
-#ifdef SLA_SUPPORTPOINTGEN_DEBUG
-        /*std::string layer_num_str = std::string((i<10 ? "0" : "")) + std::string((i<100 ? "0" : "")) + std::to_string(i);
-        output_expolygons(expolys_top, "top" + layer_num_str + ".svg");
-        output_expolygons(diff, "diff" + layer_num_str + ".svg");
-        if (!islands.empty())
-            output_expolygons(islands, "islands" + layer_num_str + ".svg");*/
-#endif /* SLA_SUPPORTPOINTGEN_DEBUG */
+        below_begin = begin;
+        begin       = end;
     }
 }
 
-void SupportPointGenerator::add_support_points(SupportPointGenerator::Structure &s, SupportPointGenerator::PointGrid3D &grid3d)
+void SupportPointGenerator::process(Layers &layers)
+{
+    std::vector<IslandChain> chains = make_island_chains(layers);
+
+    // Each chain has its own generator seeded in the order of the chains, the
+    // result does not depend on the order in which the chains are processed.
+    for (IslandChain &chain : chains)
+        chain.rng.seed(m_rng());
+
+    size_t num_islands = 0;
+    for (const IslandChain &chain : chains)
+        num_islands += chain.islands.size();
+
+    std::atomic<size_t> num_done{0};
+    int status = 0;
+    execution::SpinningMutex<ExecutionTBB> status_mutex;
+
+    execution::for_each(ex_tbb, size_t(0), chains.size(),
+        [this, &chains, num_islands, &num_done, &status, &status_mutex](size_t chain_id) {
+            IslandChain &chain = chains[chain_id];
+            process_chain(chain);
+
+            int st = int(std::round(100. * (num_done += chain.islands.size()) / num_islands));
+            std::lock_guard lk{status_mutex};
+            if (st > status)
+                m_statusfn(status = st);
+        }, 1 /* gransize */);
+
+    for (IslandChain &chain : chains)
+        append(m_output, std::move(chain.output));
+}
+
+void SupportPointGenerator::add_support_points(SupportPointGenerator::Structure &s, IslandChain &chain) const
 {
     // Select each type of surface (overrhang, dangling, slope), derive the support
     // force deficit for it and call uniformly conver with the right params
@@ -306,12 +449,12 @@ void SupportPointGenerator::add_support_points(SupportPointGenerator::Structure
     if (s.islands_below.empty()) {
         // completely new island - needs support no doubt
         // deficit is full, there is nothing below that would hold this island
-        uniformly_cover({ *s.polygon }, s, s.area * tp, grid3d, IslandCoverageFlags(icfIsNew | icfWithBoundary) );
+        uniformly_cover({ *s.polygon }, s, s.area * tp, chain, IslandCoverageFlags(icfIsNew | icfWithBoundary) );
         return;
     }
 
     if (! s.overhangs.empty()) {
-        uniformly_cover(s.overhangs, s, s.overhangs_area * tp, grid3d);
+        uniformly_cover(s.overhangs, s, s.overhangs_area * tp, chain);
     }
 
     auto areafn = [](double sum, auto &p) { return sum + p.area() * SCALING_FACTOR * SCALING_FACTOR; };
@@ -322,13 +465,13 @@ void SupportPointGenerator::add_support_points(SupportPointGenerator::Structure
         // What we now have in polygons needs support, regardless of what the forces are, so we can add them.
 
         double a = std::accumulate(s.dangling_areas.begin(), s.dangling_areas.end(), 0., areafn);
-        uniformly_cover(s.dangling_areas, s, a * tp - a * current * s.area, grid3d, icfWithBoundary);
+        uniformly_cover(s.dangling_areas, s, a * tp - a * current * s.area, chain, icfWithBoundary);
     }
 
     current = s.supports_force_total();
     if (! s.overhangs_slopes.empty()) {
         double a = std::accumulate(s.overhangs_slopes.begin(), s.overhangs_slopes.end(), 0., areafn);
-        uniformly_cover(s.overhangs_slopes, s, a * tp - a * current / s.area, grid3d, icfWithBoundary);
+        uniformly_cover(s.overhangs_slopes, s, a * tp - a * current / s.area, chain, icfWithBoundary);
     }
 }
 
@@ -543,7 +686,7 @@ static inline std::vector<Vec2f> poisson_disk_from_samples(const std::vector<Vec
 }
 
 
-void SupportPointGenerator::uniformly_cover(const ExPolygons& islands, Structure& structure, float deficit, PointGrid3D &grid3d, IslandCoverageFlags flags)
+void SupportPointGenerator::uniformly_cover(const ExPolygons& islands, Structure& structure, float deficit, IslandChain &chain, IslandCoverageFlags flags) const
 {
     //int num_of_points = std::max(1, (int)((island.area()*pow(SCALING_FACTOR, 2) * m_config.tear_pressure)/m_config.support_force));
 
@@ -567,9 +710,7 @@ void SupportPointGenerator::uniformly_cover(const ExPolygons& islands, Structure
     // Number of newly added points.
     const size_t poisson_samples_target = size_t(ceil(support_force_deficit / m_config.support_force()));
 
-    const float density_horizontal = m_config.tear_pressure() / m_config.support_force();
-    //FIXME why?
-    float poisson_radius		= std::max(m_config.minimal_distance, 1.f / (5.f * density_horizontal));
+    float poisson_radius		= max_point_spacing();
 //    const float poisson_radius     = 1.f / (15.f * density_horizontal);
     const float samples_per_mm2 = 30.f / (float(M_PI) * poisson_radius * poisson_radius);
     // Minimum distance between samples, in 3D space.
@@ -581,14 +722,14 @@ void SupportPointGenerator::uniformly_cover(const ExPolygons& islands, Structure
     std::vector<Vec2f> raw_samples =
         flags & icfWithBoundary ?
             sample_expolygon_with_boundary(islands, samples_per_mm2,
-                                           5.f / poisson_radius, m_rng) :
-            sample_expolygon(islands, samples_per_mm2, m_rng);
+                                           5.f / poisson_radius, chain.rng) :
+            sample_expolygon(islands, samples_per_mm2, chain.rng);
 
     std::vector<Vec2f>  poisson_samples;
     for (size_t iter = 0; iter < 4; ++ iter) {
         poisson_samples = poisson_disk_from_samples(raw_samples, poisson_radius,
-            [&structure, &grid3d, min_spacing](const Vec2f &pos) {
-                return grid3d.collides_with(pos, structure.layer->print_z, min_spacing);
+            [&structure, &chain, min_spacing](const Vec2f &pos) {
+                return chain.grid.collides_with(pos, structure.layer->print_z, min_spacing);
             });
         if (poisson_samples.size() >= poisson_samples_target || m_config.minimal_distance > poisson_radius-EPSILON)
             break;
@@ -614,13 +755,13 @@ void SupportPointGenerator::uniformly_cover(const ExPolygons& islands, Structure
 
 //    assert(! poisson_samples.empty());
     if (poisson_samples_target < poisson_samples.size()) {
-        std::shuffle(poisson_samples.begin(), poisson_samples.end(), m_rng);
+        std::shuffle(poisson_samples.begin(), poisson_samples.end(), chain.rng);
         poisson_samples.erase(poisson_samples.begin() + poisson_samples_target, poisson_samples.end());
     }
     for (const Vec2f &pt : poisson_samples) {
-        m_output.emplace_back(float(pt(0)), float(pt(1)), structure.zlevel, m_config.head_diameter/2.f, flags & icfIsNew);
+        chain.output.emplace_back(float(pt(0)), float(pt(1)), structure.zlevel, m_config.head_diameter/2.f, flags & icfIsNew);
         structure.supports_force_this_layer += m_config.support_force();
-        grid3d.insert(pt, &structure);
+        chain.grid.insert(pt, &structure);
     }
 }
 
@@ -35,13 +35,18 @@ public:
     SupportPointGenerator(const AABBMesh& emesh, const std::vector<ExPolygons>& slices,
                     const std::vector<float>& heights, const Config& config, std::function<void(void)> throw_on_cancel, std::function<void(int)> statusfn);
     
+    struct MyLayer;
+    using Layers = std::vector<MyLayer>;
+
+    // Places the points onto the layers made by make_layers(), which can be
+    // reused for another run with a different config.
+    SupportPointGenerator(const AABBMesh& emesh, Layers &layers, const Config& config, std::function<void(void)> throw_on_cancel, std::function<void(int)> statusfn);
+
     SupportPointGenerator(const AABBMesh& emesh, const Config& config, std::function<void(void)> throw_on_cancel, std::function<void(int)> statusfn);
     
     const std::vector<SupportPoint>& output() const { return m_output; }
     std::vector<SupportPoint>& output() { return m_output; }
     
-    struct MyLayer;
-    
     struct Structure {
         Structure(MyLayer &layer, const ExPolygon& poly, const BoundingBox &bbox, const Vec2f &centroid, float area, float h) :
             layer(&layer), polygon(&poly), bbox(bbox), centroid(centroid), area(area), zlevel(h)
@@ -193,8 +198,25 @@ public:
         }
     };
     
+    // Islands of the slices linked with the overlapping islands of the
+    // adjacent layers. The layers depend only on the slices, not on the config,
+    // so the points can be placed onto the same layers again after the config
+    // changes. The islands refer to the slices, which have to outlive them.
+    static Layers make_layers(const std::vector<ExPolygons> &slices,
+                              const std::vector<float> &     heights,
+                              std::function<void(void)>      throw_on_cancel);
+
+    // Hash of the slices and their heights, to tell whether layers made of
+    // other slices may be reused.
+    static size_t slices_hash(const std::vector<ExPolygons> &slices,
+                              const std::vector<float> &     heights);
+
     void execute(const std::vector<ExPolygons> &slices,
                  const std::vector<float> &     heights);
+
+    // The support forces stored in the layers are recalculated, the same
+    // layers must not be used by two generators at once.
+    void execute(Layers &layers);
     
     void seed(std::mt19937::result_type s) { m_rng.seed(s); }
 private:
@@ -202,16 +224,33 @@ private:
     
     SupportPointGenerator::Config m_config;
     
-    void process(const std::vector<ExPolygons>& slices, const std::vector<float>& heights);
+    void process(Layers &layers);
+
+    // Largest distance of two points that may collide.
+    float max_point_spacing() const;
 
 public:
     enum IslandCoverageFlags : uint8_t { icfNone = 0x0, icfIsNew = 0x1, icfWithBoundary = 0x2 };
 
 private:
 
-    void uniformly_cover(const ExPolygons& islands, Structure& structure, float deficit, PointGrid3D &grid3d, IslandCoverageFlags flags = icfNone);
+    // Islands connected by their overlaps, along with the islands too close
+    // to them. Points placed onto different chains can not collide, thus the
+    // chains are covered in parallel, each with its own grid and generator.
+    struct IslandChain {
+        std::vector<Structure*>   islands; // ordered by layers
+        PointGrid3D               grid;
+        std::mt19937              rng;
+        std::vector<SupportPoint> output;
+    };
+
+    std::vector<IslandChain> make_island_chains(Layers &layers) const;
+
+    void process_chain(IslandChain &chain) const;
+
+    void uniformly_cover(const ExPolygons& islands, Structure& structure, float deficit, IslandChain &chain, IslandCoverageFlags flags = icfNone) const;
 
-    void add_support_points(Structure& structure, PointGrid3D &grid3d);
+    void add_support_points(Structure& structure, IslandChain &chain) const;
 
     void project_onto_mesh(std::vector<SupportPoint>& points) const;
 
@@ -11,6 +11,7 @@
 #include <libslic3r/SLA/SupportTree.hpp>
 #include <libslic3r/SLA/SpatIndex.hpp>
 #include <libslic3r/SLA/SupportTreeBuilder.hpp>
+#include <libslic3r/SLA/SupportTreeSlicer.hpp>
 #include <libslic3r/SLA/DefaultSupportTree.hpp>
 #include <libslic3r/SLA/BranchingTreeSLA.hpp>
 
@@ -27,10 +28,14 @@
 namespace Slic3r { namespace sla {
 
 indexed_triangle_set create_support_tree(const SupportableMesh &sm,
-                                         const JobController   &ctl)
+                                         const JobController   &ctl,
+                                         SupportTreePrimitives *primitives)
 {
     auto builder = make_unique<SupportTreeBuilder>(ctl);
 
+    if (primitives)
+        *primitives = {};
+
     if (sm.cfg.enabled) {
         Benchmark bench;
         bench.start();
@@ -56,6 +61,9 @@ indexed_triangle_set create_support_tree(const SupportableMesh &sm,
                                 << bench.getElapsedSec()
                                 << " seconds";
 
+        if (primitives)
+            *primitives = builder->primitives();
+
         builder->merge_and_cleanup();   // clean metadata, leave only the meshes.
     }
 
@@ -90,7 +98,7 @@ indexed_triangle_set create_pad(const SupportableMesh      &sm,
     pad_blueprint(support_mesh, sup_contours, heights, ctl.cancelfn);
 
     indexed_triangle_set out;
-    create_pad(sup_contours, model_contours, out, sm.pad_cfg);
+    create_pad(sup_contours, model_contours, out, sm.pad_cfg, ctl.cancelfn);
 
     Vec3f offs{.0f, .0f, gndlvl};
     for (auto &p : out.vertices) p += offs;
@@ -100,33 +108,26 @@ indexed_triangle_set create_pad(const SupportableMesh      &sm,
     return out;
 }
 
-std::vector<ExPolygons> slice(const indexed_triangle_set &sup_mesh,
-                              const indexed_triangle_set &pad_mesh,
-                              const std::vector<float>   &grid,
-                              float                       cr,
-                              const JobController        &ctl)
+// Slices of the pad up to its top, to be merged with the slices of the tree.
+static std::vector<ExPolygons> slice_pad(const indexed_triangle_set &pad_mesh,
+                                         const std::vector<float>   &grid,
+                                         float                       cr,
+                                         const JobController        &ctl)
 {
-    using Slices = std::vector<ExPolygons>;
-
-    auto slices = reserve_vector<Slices>(2);
+    auto bb     = bounding_box(pad_mesh);
+    auto maxzit = std::upper_bound(grid.begin(), grid.end(), bb.max.z());
 
-    if (!sup_mesh.empty()) {
-        slices.emplace_back();
-        slices.back() = slice_mesh_ex(sup_mesh, grid, cr, ctl.cancelfn);
-    }
-
-    if (!pad_mesh.empty()) {
-        slices.emplace_back();
-
-        auto bb     = bounding_box(pad_mesh);
-        auto maxzit = std::upper_bound(grid.begin(), grid.end(), bb.max.z());
+    auto cap     = grid.end() - maxzit;
+    auto padgrid = reserve_vector<float>(size_t(cap > 0 ? cap : 0));
+    std::copy(grid.begin(), maxzit, std::back_inserter(padgrid));
 
-        auto cap     = grid.end() - maxzit;
-        auto padgrid = reserve_vector<float>(size_t(cap > 0 ? cap : 0));
-        std::copy(grid.begin(), maxzit, std::back_inserter(padgrid));
+    return slice_mesh_ex(pad_mesh, padgrid, cr, ctl.cancelfn);
+}
 
-        slices.back() = slice_mesh_ex(pad_mesh, padgrid, cr, ctl.cancelfn);
-    }
+static std::vector<ExPolygons> merge_slices(std::vector<std::vector<ExPolygons>> &&slices,
+                                            const std::vector<float>             &grid)
+{
+    using Slices = std::vector<ExPolygons>;
 
     size_t len = grid.size();
     for (const Slices &slv : slices)
@@ -145,7 +146,45 @@ std::vector<ExPolygons> slice(const indexed_triangle_set &sup_mesh,
         }
     }
 
-    return mrg;
+    return std::move(mrg);
+}
+
+std::vector<ExPolygons> slice(const indexed_triangle_set &sup_mesh,
+                              const indexed_triangle_set &pad_mesh,
+                              const std::vector<float>   &grid,
+                              float                       cr,
+                              const JobController        &ctl)
+{
+    using Slices = std::vector<ExPolygons>;
+
+    auto slices = reserve_vector<Slices>(2);
+
+    if (!sup_mesh.empty())
+        slices.emplace_back(slice_mesh_ex(sup_mesh, grid, cr, ctl.cancelfn));
+
+    if (!pad_mesh.empty())
+        slices.emplace_back(slice_pad(pad_mesh, grid, cr, ctl));
+
+    return merge_slices(std::move(slices), grid);
+}
+
+std::vector<ExPolygons> slice(const SupportTreePrimitives &support_tree,
+                              const indexed_triangle_set  &pad_mesh,
+                              const std::vector<float>    &grid,
+                              float                        cr,
+                              const JobController         &ctl)
+{
+    using Slices = std::vector<ExPolygons>;
+
+    auto slices = reserve_vector<Slices>(2);
+
+    if (!support_tree.empty())
+        slices.emplace_back(slice_support_tree(support_tree, grid, cr, ctl));
+
+    if (!pad_mesh.empty())
+        slices.emplace_back(slice_pad(pad_mesh, grid, cr, ctl));
+
+    return merge_slices(std::move(slices), grid);
 }
 
 }} // namespace Slic3r::sla
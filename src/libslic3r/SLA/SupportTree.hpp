@@ -128,6 +128,13 @@ struct SupportableMesh
         : emesh{trmsh}, pts{sp}, cfg{c}
     {}
 
+    // The index of a shared mesh is reused from AABBMeshCache.
+    explicit SupportableMesh(std::shared_ptr<const indexed_triangle_set> trmsh,
+                             const SupportPoints                        &sp,
+                             const SupportTreeConfig                    &c)
+        : emesh{std::move(trmsh)}, pts{sp}, cfg{c}
+    {}
+
 //    explicit SupportableMesh(const AABBMesh          &em,
 //                             const SupportPoints     &sp,
 //                             const SupportTreeConfig &c)
@@ -144,8 +151,13 @@ inline double ground_level(const SupportableMesh &sm)
     return lvl;
 }
 
+struct SupportTreePrimitives;
+
+// If primitives is not null, the parts of the generated tree are copied there,
+// so that the tree may be sliced without slicing its mesh.
 indexed_triangle_set create_support_tree(const SupportableMesh &mesh,
-                                         const JobController   &ctl);
+                                         const JobController   &ctl,
+                                         SupportTreePrimitives *primitives = nullptr);
 
 indexed_triangle_set create_pad(const SupportableMesh      &model_mesh,
                                 const indexed_triangle_set &support_mesh,
@@ -157,6 +169,13 @@ std::vector<ExPolygons> slice(const indexed_triangle_set &support_mesh,
                               float                       closing_radius,
                               const JobController        &ctl);
 
+// Same as above, but the support tree is sliced directly from its primitives.
+std::vector<ExPolygons> slice(const SupportTreePrimitives &support_tree,
+                              const indexed_triangle_set  &pad_mesh,
+                              const std::vector<float>    &grid,
+                              float                        closing_radius,
+                              const JobController         &ctl);
+
 } // namespace sla
 } // namespace Slic3r
 
@@ -84,6 +84,25 @@ void SupportTreeBuilder::add_pillar_base(long pid, double baseheight, double rad
     m_meshcache_valid = false;
 }
 
+SupportTreePrimitives SupportTreeBuilder::primitives() const
+{
+    std::lock_guard<Mutex> lk(m_mutex);
+
+    SupportTreePrimitives ret;
+    ret.heads.reserve(m_heads.size());
+    std::copy_if(m_heads.begin(), m_heads.end(), std::back_inserter(ret.heads),
+                 [](const Head &h) { return h.is_valid(); });
+    ret.pillars     = m_pillars;
+    ret.junctions   = m_junctions;
+    ret.bridges     = m_bridges;
+    ret.bridges.insert(ret.bridges.end(), m_crossbridges.begin(), m_crossbridges.end());
+    ret.diffbridges = m_diffbridges;
+    ret.pedestals   = m_pedestals;
+    ret.anchors     = m_anchors;
+
+    return ret;
+}
+
 const indexed_triangle_set &SupportTreeBuilder::merged_mesh(size_t steps) const
 {
     if (m_meshcache_valid) return m_meshcache;
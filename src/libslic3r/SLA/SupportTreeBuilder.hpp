@@ -206,6 +206,26 @@ struct DiffBridge: public Bridge {
     {}
 };
 
+// The logical parts of a finished support tree. A copy of them is kept along
+// with the support mesh, so that the tree can be sliced directly without
+// slicing its mesh (see SupportTreeSlicer.hpp).
+struct SupportTreePrimitives {
+    std::vector<Head>       heads;       // only the valid ones
+    std::vector<Pillar>     pillars;
+    std::vector<Junction>   junctions;
+    std::vector<Bridge>     bridges;     // including the cross bridges
+    std::vector<DiffBridge> diffbridges;
+    std::vector<Pedestal>   pedestals;
+    std::vector<Anchor>     anchors;
+
+    bool empty() const
+    {
+        return heads.empty() && pillars.empty() && junctions.empty() &&
+               bridges.empty() && diffbridges.empty() && pedestals.empty() &&
+               anchors.empty();
+    }
+};
+
 // This class will hold the support tree parts (not meshes, but logical parts)
 // with some additional bookkeeping as well. Various parts of the support
 // geometry are stored separately and are merged when the caller queries the
@@ -418,6 +438,9 @@ public:
         return m_pillars[size_t(id)];
     }
 
+    // Copy of the parts of the tree, to be called before merge_and_cleanup().
+    SupportTreePrimitives primitives() const;
+
     // WITHOUT THE PAD!!!
     const indexed_triangle_set &merged_mesh(size_t steps = 45) const;
     
@@ -0,0 +1,270 @@
+#include <libslic3r/SLA/SupportTreeSlicer.hpp>
+
+#include <libslic3r/ClipperUtils.hpp>
+#include <libslic3r/Geometry/ConvexHull.hpp>
+#include <libslic3r/Execution/ExecutionTBB.hpp>
+
+namespace Slic3r { namespace sla {
+
+namespace {
+
+Polygon circle(const Vec3d &center, double r, size_t steps)
+{
+    Polygon ret = make_circle_num_segments(scaled(r), steps);
+    ret.translate(scaled(center.x()), scaled(center.y()));
+
+    return ret;
+}
+
+void slice_sphere(const Vec3d &c, double r, double z, size_t steps, Polygons &out)
+{
+    double dz = z - c.z();
+    if (r > 0. && std::abs(dz) < r)
+        out.emplace_back(circle(c, std::sqrt(r * r - dz * dz), steps));
+}
+
+// Truncated cone with flat bases, radius r0 at p0 and r1 at p1. Tilted cones
+// are discretized the same way as the meshes of SupportTreeMesher: the section
+// is the convex hull of the crossings of the polyhedron edges with the plane.
+void slice_cone(const Vec3d &p0, double r0, const Vec3d &p1, double r1,
+                double z, size_t steps, Polygons &out)
+{
+    Vec3d  axis = p1 - p0;
+    double len  = axis.norm();
+    r0 = std::max(r0, 0.);
+    r1 = std::max(r1, 0.);
+    if (len < EPSILON || (r0 <= 0. && r1 <= 0.))
+        return;
+
+    axis /= len;
+
+    // Vertical extent of a base circle with unit radius.
+    double base_dz = std::sqrt(std::max(0., 1. - axis.z() * axis.z()));
+    if (z <= std::min(p0.z() - r0 * base_dz, p1.z() - r1 * base_dz) ||
+        z >= std::max(p0.z() + r0 * base_dz, p1.z() + r1 * base_dz))
+        return;
+
+    if (base_dz < EPSILON) {
+        // Vertical axis (pillars, pedestals), the section is a circle.
+        double t = (z - p0.z()) / (p1.z() - p0.z());
+        double r = r0 + t * (r1 - r0);
+        if (r > 0.)
+            out.emplace_back(circle(p0 + t * (p1 - p0), r, steps));
+        return;
+    }
+
+    Vec3d u = axis.cross(Vec3d::UnitZ()).normalized();
+    Vec3d v = axis.cross(u);
+
+    Points pts;
+    pts.reserve(2 * steps);
+    auto add_crossing = [z, &pts](const Vec3d &a, const Vec3d &b) {
+        if ((a.z() < z) != (b.z() < z)) {
+            Vec3d p = a + (z - a.z()) / (b.z() - a.z()) * (b - a);
+            pts.emplace_back(scaled(p.x()), scaled(p.y()));
+        }
+    };
+
+    double a = 2. * PI / steps;
+    Vec3d  prev0, prev1;
+    for (size_t i = 0; i <= steps; ++i) {
+        double phi = (i % steps) * a;
+        Vec3d  d   = std::cos(phi) * u + std::sin(phi) * v;
+        Vec3d  q0  = p0 + r0 * d, q1 = p1 + r1 * d;
+        if (i > 0) {
+            add_crossing(prev0, q0);
+            add_crossing(prev1, q1);
+        }
+        if (i < steps)
+            add_crossing(q0, q1);
+        prev0 = q0;
+        prev1 = q1;
+    }
+
+    if (pts.size() >= 3) {
+        Polygon hull = Geometry::convex_hull(std::move(pts));
+        if (hull.size() >= 3)
+            out.emplace_back(std::move(hull));
+    }
+}
+
+// A pinhead is the union of the back sphere, the pin sphere and the cone
+// tangent to both of them (see pinhead() in SupportTreeMesher.cpp).
+struct Pinhead {
+    Vec3d  back_center, pin_center;
+    double r_back, r_pin;
+    double tangent; // cosine of the cone half-angle, NaN if there is no cone
+
+    explicit Pinhead(const Head &h)
+        : back_center{h.junction_point()}
+        , pin_center{h.pos + (h.r_pin_mm - h.penetration_mm) * h.dir}
+        , r_back{h.r_back_mm}
+        , r_pin{h.r_pin_mm}
+        , tangent{(h.r_back_mm - h.r_pin_mm) / (h.r_back_mm + h.r_pin_mm + h.width_mm)}
+    {}
+
+    bool is_valid() const { return std::abs(tangent) <= 1.; }
+};
+
+std::pair<double, double> z_extent(const Head &h)
+{
+    Pinhead ph{h};
+    return {std::min(ph.back_center.z() - ph.r_back, ph.pin_center.z() - ph.r_pin),
+            std::max(ph.back_center.z() + ph.r_back, ph.pin_center.z() + ph.r_pin)};
+}
+
+std::pair<double, double> z_extent(const Pillar &p)
+{
+    return {p.endpt.z(), p.endpt.z() + p.height};
+}
+
+std::pair<double, double> z_extent(const Pedestal &p)
+{
+    return {p.pos.z(), p.pos.z() + p.height};
+}
+
+std::pair<double, double> z_extent(const Junction &j)
+{
+    return {j.pos.z() - j.r, j.pos.z() + j.r};
+}
+
+std::pair<double, double> z_extent(const Bridge &br)
+{
+    return {std::min(br.startp.z(), br.endp.z()) - br.r,
+            std::max(br.startp.z(), br.endp.z()) + br.r};
+}
+
+std::pair<double, double> z_extent(const DiffBridge &br)
+{
+    double r = std::max(br.r, br.end_r);
+    return {std::min(br.startp.z(), br.endp.z()) - r,
+            std::max(br.startp.z(), br.endp.z()) + r};
+}
+
+} // namespace
+
+Polygons get_slice(const Head &head, double z, size_t steps)
+{
+    Polygons out;
+
+    Pinhead ph{head};
+    if (! ph.is_valid())
+        return out;
+
+    slice_sphere(ph.back_center, ph.r_back, z, steps, out);
+    slice_sphere(ph.pin_center, ph.r_pin, z, steps, out);
+
+    Vec3d  axis = (ph.pin_center - ph.back_center).normalized();
+    double s    = std::sqrt(1. - ph.tangent * ph.tangent);
+    slice_cone(ph.back_center + ph.r_back * ph.tangent * axis, ph.r_back * s,
+               ph.pin_center + ph.r_pin * ph.tangent * axis, ph.r_pin * s,
+               z, steps, out);
+
+    return out;
+}
+
+Polygons get_slice(const Pillar &pillar, double z, size_t steps)
+{
+    Polygons out;
+    if (pillar.height > EPSILON)
+        slice_cone(pillar.endpt, pillar.r_end, pillar.startpoint(), pillar.r_start, z, steps, out);
+
+    return out;
+}
+
+Polygons get_slice(const Pedestal &pedestal, double z, size_t steps)
+{
+    Polygons out;
+    slice_cone(pedestal.pos, pedestal.r_bottom,
+               pedestal.pos + Vec3d{0., 0., pedestal.height}, pedestal.r_top,
+               z, steps, out);
+
+    return out;
+}
+
+Polygons get_slice(const Junction &junction, double z, size_t steps)
+{
+    Polygons out;
+    slice_sphere(junction.pos, junction.r, z, steps, out);
+
+    return out;
+}
+
+Polygons get_slice(const Bridge &bridge, double z, size_t steps)
+{
+    Polygons out;
+    slice_cone(bridge.startp, bridge.r, bridge.endp, bridge.r, z, steps, out);
+
+    return out;
+}
+
+Polygons get_slice(const DiffBridge &bridge, double z, size_t steps)
+{
+    Polygons out;
+    slice_cone(bridge.startp, bridge.r, bridge.endp, bridge.end_r, z, steps, out);
+
+    return out;
+}
+
+std::vector<ExPolygons> slice_support_tree(const SupportTreePrimitives &tree,
+                                           const std::vector<float>    &grid,
+                                           float                        closing_radius,
+                                           const JobController         &ctl,
+                                           size_t                       steps)
+{
+    enum PrimitiveType : uint32_t {
+        ptHead, ptPillar, ptPedestal, ptJunction, ptBridge, ptDiffBridge, ptAnchor
+    };
+    using PrimitiveRef = std::pair<PrimitiveType, uint32_t>;
+
+    // Sort the primitives into the layers they may intersect, so that
+    // the layers do not need to test every primitive of the tree.
+    std::vector<std::vector<PrimitiveRef>> layer_primitives(grid.size());
+    auto sort_into_layers = [&grid, &layer_primitives](PrimitiveType type, const auto &primitives) {
+        for (size_t idx = 0; idx < primitives.size(); ++idx) {
+            auto [zmin, zmax] = z_extent(primitives[idx]);
+            auto from = std::lower_bound(grid.begin(), grid.end(), float(zmin));
+            auto to   = std::upper_bound(from, grid.end(), float(zmax));
+            for (auto it = from; it != to; ++it)
+                layer_primitives[it - grid.begin()].emplace_back(type, uint32_t(idx));
+        }
+    };
+
+    sort_into_layers(ptHead, tree.heads);
+    sort_into_layers(ptPillar, tree.pillars);
+    sort_into_layers(ptPedestal, tree.pedestals);
+    sort_into_layers(ptJunction, tree.junctions);
+    sort_into_layers(ptBridge, tree.bridges);
+    sort_into_layers(ptDiffBridge, tree.diffbridges);
+    sort_into_layers(ptAnchor, tree.anchors);
+
+    std::vector<ExPolygons> slices(grid.size());
+
+    execution::for_each(ex_tbb, size_t(0), grid.size(),
+        [&tree, &grid, closing_radius, &ctl, steps, &layer_primitives, &slices](size_t layer_id) {
+            ctl.cancelfn();
+
+            double   z = grid[layer_id];
+            Polygons loops;
+            for (auto [type, idx] : layer_primitives[layer_id]) {
+                switch (type) {
+                case ptHead:       append(loops, get_slice(tree.heads[idx], z, steps)); break;
+                case ptPillar:     append(loops, get_slice(tree.pillars[idx], z, steps)); break;
+                case ptPedestal:   append(loops, get_slice(tree.pedestals[idx], z, steps)); break;
+                case ptJunction:   append(loops, get_slice(tree.junctions[idx], z, steps)); break;
+                case ptBridge:     append(loops, get_slice(tree.bridges[idx], z, steps)); break;
+                case ptDiffBridge: append(loops, get_slice(tree.diffbridges[idx], z, steps)); break;
+                case ptAnchor:     append(loops, get_slice(tree.anchors[idx], z, steps)); break;
+                }
+            }
+
+            slices[layer_id] = closing_radius > 0.f ?
+                closing_ex(loops, scaled<float>(closing_radius)) :
+                union_ex(loops);
+        },
+        execution::max_concurrency(ex_tbb));
+
+    return slices;
+}
+
+}} // namespace Slic3r::sla
@@ -0,0 +1,36 @@
+#ifndef SLA_SUPPORTTREESLICER_HPP
+#define SLA_SUPPORTTREESLICER_HPP
+
+#include <libslic3r/SLA/SupportTreeBuilder.hpp>
+
+namespace Slic3r { namespace sla {
+
+// Slicing of the support tree directly from its primitives, without creating
+// and slicing the support mesh. Every primitive is a sphere or a (possibly
+// tilted) truncated cone, or for heads and anchors the union of two spheres
+// and the cone tangent to both of them. Their cross-sections with a horizontal
+// plane are computed analytically and unioned per layer. The circles are
+// discretized with the same number of steps that is used by the mesher in
+// SupportTreeMesher.hpp, thus the result matches the slices of the support
+// mesh up to the discretization of the mesh along the primitive axes.
+
+// Cross-section of a single primitive at height z, scaled, empty if the plane
+// misses the primitive.
+Polygons get_slice(const Head &head, double z, size_t steps = 45);
+Polygons get_slice(const Pillar &pillar, double z, size_t steps = 45);
+Polygons get_slice(const Pedestal &pedestal, double z, size_t steps = 45);
+Polygons get_slice(const Junction &junction, double z, size_t steps = 45);
+Polygons get_slice(const Bridge &bridge, double z, size_t steps = 45);
+Polygons get_slice(const DiffBridge &bridge, double z, size_t steps = 45);
+
+// Slices of the whole tree at the heights of the grid, layers are processed
+// in parallel. The closing radius is applied as with slice_mesh_ex().
+std::vector<ExPolygons> slice_support_tree(const SupportTreePrimitives &tree,
+                                           const std::vector<float>    &grid,
+                                           float                        closing_radius,
+                                           const JobController         &ctl,
+                                           size_t                       steps = 45);
+
+}} // namespace Slic3r::sla
+
+#endif // SLA_SUPPORTTREESLICER_HPP
@@ -12,6 +12,8 @@
 
 #include "PrintBase.hpp"
 #include "SLA/SupportTree.hpp"
+#include "SLA/SupportPointGenerator.hpp"
+#include "SLA/SupportTreeBuilder.hpp"
 #include "Point.hpp"
 #include "Format/SLAArchiveWriter.hpp"
 #include "GCode/ThumbnailData.hpp"
@@ -341,11 +343,17 @@ private:
 
     std::vector<float>                      m_model_height_levels;
 
+    // Islands of m_model_slices linked across the layers. Only the support
+    // point placement is repeated when the support point config changes.
+    std::unique_ptr<sla::SupportPointGenerator::Layers> m_support_point_layers;
+    size_t                                  m_support_point_layers_hash = 0;
+
     struct SupportData
     {
         sla::SupportableMesh    input; // the input
         std::vector<ExPolygons> support_slices;   // sliced supports
         TriangleMesh tree_mesh, pad_mesh, full_mesh; // cached artifacts
+        sla::SupportTreePrimitives tree_primitives; // the tree is sliced from these
         
         inline SupportData(const TriangleMesh &t)
             : input{t.its, {}, {}}
@@ -354,10 +362,14 @@ private:
         inline SupportData(const indexed_triangle_set &t)
             : input{t, {}, {}}
         {}
+
+        inline SupportData(std::shared_ptr<const indexed_triangle_set> t)
+            : input{std::move(t), {}, {}}
+        {}
         
         void create_support_tree(const sla::JobController &ctl)
         {
-            tree_mesh = TriangleMesh{sla::create_support_tree(input, ctl)};
+            tree_mesh = TriangleMesh{sla::create_support_tree(input, ctl, &tree_primitives)};
         }
 
         void create_pad(const sla::JobController &ctl)
@@ -28,6 +28,7 @@
 #include <libslic3r/QuadricEdgeCollapse.hpp>
 
 #include <libslic3r/ClipperUtils.hpp>
+#include <libslic3r/Utils.hpp>
 //#include <libslic3r/ShortEdgeCollapse.hpp>
 
 #include <boost/log/trivial.hpp>
@@ -169,6 +170,7 @@ void SLAPrint::Steps::generate_preview(SLAPrintObject &po, SLAPrintObjectStep st
     auto m = indexed_triangle_set{};
 
     bool handled   = false;
+    bool preview_reused = false;
 
     if (is_all_positive(r)) {
         m = csgmesh_merge_positive_parts(r);
@@ -209,10 +211,13 @@ void SLAPrint::Steps::generate_preview(SLAPrintObject &po, SLAPrintObjectStep st
             handled = true;
         } else if (step == slaposDrillHoles && is_pure_model) {
             if (po.m_model_object->sla_drain_holes.empty()) {
-                // Get the last printable preview
-                auto &meshp = po.get_mesh_to_print();
-                if (meshp)
-                    m = *(meshp);
+                // Get the last printable preview. The same mesh object is
+                // reused, so the index of the mesh built for the support
+                // generation is shared through AABBMeshCache.
+                if (auto meshp = po.get_mesh_to_print(); meshp) {
+                    po.m_preview_meshes[step] = meshp;
+                    preview_reused = true;
+                }
 
                 handled = true;
             } else if (can_hollow) {
@@ -270,8 +275,9 @@ void SLAPrint::Steps::generate_preview(SLAPrintObject &po, SLAPrintObjectStep st
         m = generate_preview_vdb(po, step);
     }
 
-    po.m_preview_meshes[step] =
-            std::make_shared<const indexed_triangle_set>(std::move(m));
+    if (!preview_reused)
+        po.m_preview_meshes[step] =
+                std::make_shared<const indexed_triangle_set>(std::move(m));
 
     for (size_t i = size_t(step) + 1; i < slaposCount; ++i)
     {
@@ -341,6 +347,8 @@ void SLAPrint::Steps::hollow_model(SLAPrintObject &po)
     double quality  = po.m_config.hollowing_quality.getFloat();
     double closing_d = po.m_config.hollowing_closing_distance.getFloat();
     sla::HollowingConfig hlwcfg{thickness, quality, closing_d};
+    double memory_limit = std::min(po.m_config.hollowing_memory_limit.value, 100.);
+    hlwcfg.max_grid_memory = memory_limit > 0. ? size_t(double(total_physical_memory()) * memory_limit / 100.) : 0;
     sla::JobController ctl;
     ctl.stopcondition = [this]() { return canceled(); };
     ctl.cancelfn = [this]() { throw_if_canceled(); };
@@ -351,6 +359,9 @@ void SLAPrint::Steps::hollow_model(SLAPrintObject &po)
     if (!interior || sla::get_mesh(*interior).empty())
         BOOST_LOG_TRIVIAL(warning) << "Hollowed interior is empty!";
     else {
+        BOOST_LOG_TRIVIAL(info) << "Hollowing: peak voxel grid memory "
+                                << sla::get_peak_grid_memory(*interior) / (1024 * 1024) << " MB";
+
         po.m_hollowing_data.reset(new SLAPrintObject::HollowingData());
         po.m_hollowing_data->interior = std::move(interior);
 
@@ -492,6 +503,7 @@ void SLAPrint::Steps::slice_model(SLAPrintObject &po)
         po.m_model_height_levels.emplace_back(it->slice_level());
 
     po.m_model_slices.clear();
+    po.m_support_point_layers.reset();
     MeshSlicingParamsEx params;
     params.closing_radius = float(po.config().slice_closing_radius.value);
     switch (po.config().slicing_mode.value) {
@@ -588,7 +600,7 @@ void SLAPrint::Steps::support_points(SLAPrintObject &po)
         auto &meshp = po.get_mesh_to_print();
         assert(meshp);
         po.m_supportdata =
-            std::make_unique<SLAPrintObject::SupportData>(*meshp);
+            std::make_unique<SLAPrintObject::SupportData>(meshp);
     }
 
     po.m_supportdata->input.zoffset = csgmesh_positive_bb(po.m_mesh_to_slice)
@@ -627,11 +639,22 @@ void SLAPrint::Steps::support_points(SLAPrintObject &po)
                 report_status(current, OBJ_STEP_LABELS(slaposSupportPoints));
         };
 
+        // The islands of the slices are kept for the next run, which may
+        // only differ in the config.
+        size_t slices_hash = sla::SupportPointGenerator::slices_hash(po.get_model_slices(), heights);
+        if (!po.m_support_point_layers || po.m_support_point_layers_hash != slices_hash) {
+            po.m_support_point_layers = std::make_unique<sla::SupportPointGenerator::Layers>(
+                sla::SupportPointGenerator::make_layers(po.get_model_slices(), heights,
+                                                        [this]() { throw_if_canceled(); }));
+            po.m_support_point_layers_hash = slices_hash;
+        } else
+            BOOST_LOG_TRIVIAL(debug) << "Reusing the islands of the slices for support points";
+
         // Construction of this object does the calculation.
         throw_if_canceled();
         sla::SupportPointGenerator auto_supports(
-            po.m_supportdata->input.emesh, po.get_model_slices(),
-            heights, config, [this]() { throw_if_canceled(); }, statuscb);
+            po.m_supportdata->input.emesh, *po.m_support_point_layers,
+            config, [this]() { throw_if_canceled(); }, statuscb);
 
         // Now let's extract the result.
         std::vector<sla::SupportPoint>& points = auto_supports.output();
@@ -735,7 +758,7 @@ void SLAPrint::Steps::generate_pad(SLAPrintObject &po) {
             auto &meshp = po.get_mesh_to_print();
             assert(meshp);
             po.m_supportdata =
-                std::make_unique<SLAPrintObject::SupportData>(*meshp);
+                std::make_unique<SLAPrintObject::SupportData>(meshp);
         }
 
         // Get the distilled pad configuration from the config
@@ -785,7 +808,7 @@ void SLAPrint::Steps::slice_supports(SLAPrintObject &po) {
         ctl.cancelfn = [this]() { throw_if_canceled(); };
 
         sd->support_slices =
-            sla::slice(sd->tree_mesh.its, sd->pad_mesh.its, heights,
+            sla::slice(sd->tree_primitives, sd->pad_mesh.its, heights,
                        float(po.config().slice_closing_radius.value), ctl);
     }
 
@@ -19,6 +19,61 @@
 
 namespace Slic3r {
 
+// The KD tree over end points of segments is not updated when the end points get connected, instead the closest point search
+// filters out the end points, which could not be connected anymore. With tens of thousands of segments most of the KD tree nodes
+// visited by the search become dead, making the chaining superlinear. KDTreePruning rebuilds the KD tree over the end points
+// still alive once the number of end points connected since the last rebuild reaches half of the end points indexed.
+class KDTreePruning
+{
+public:
+	explicit KDTreePruning(size_t num_end_points) : m_num_indexed(num_end_points) {}
+
+	// To be called when end points got connected.
+	void connected(size_t num_end_points) { m_num_connected += num_end_points; }
+
+	// Rebuild the KD tree over the end points, for which alive_fn(idx) returns true, if enough end points were connected
+	// since the last rebuild. alive_fn shall accept all the end points that the closest point search filter may accept.
+	template<typename KDTreeType, typename AliveFn>
+	void prune(KDTreeType &kdtree, size_t num_end_points, AliveFn alive_fn)
+	{
+		if (m_num_indexed >= min_end_points_to_prune && 2 * m_num_connected > m_num_indexed) {
+			m_num_connected = 0;
+			// m_indices are cleared by KDTreeIndirect::build(), their memory is reused by the next rebuild.
+			assert(m_indices.empty());
+			for (size_t idx = 0; idx < num_end_points; ++ idx)
+				if (alive_fn(idx))
+					m_indices.emplace_back(idx);
+			if (m_indices.empty())
+				// Nothing to search for anymore. Keep the KD tree as it is, the search filter will reject everything anyway.
+				return;
+			m_num_indexed = m_indices.size();
+			m_pruned      = true;
+			kdtree.build(m_indices);
+		}
+	}
+
+	// Index all the end points again, for example before falling back to chain_segments_closest_point().
+	template<typename KDTreeType>
+	void restore(KDTreeType &kdtree, size_t num_end_points)
+	{
+		if (m_pruned) {
+			kdtree.build(num_end_points);
+			m_num_indexed   = num_end_points;
+			m_num_connected = 0;
+			m_pruned        = false;
+		}
+	}
+
+private:
+	// Small KD trees are cheap to search, don't bother pruning them.
+	static constexpr size_t min_end_points_to_prune = 256;
+
+	size_t 				m_num_indexed;
+	size_t 				m_num_connected { 0 };
+	bool   				m_pruned { false };
+	std::vector<size_t> m_indices;
+};
+
 // Naive implementation of the Traveling Salesman Problem, it works by always taking the next closest neighbor.
 // This implementation will always produce valid result even if some segments cannot reverse.
 template<typename EndPointType, typename KDTreeType, typename CouldReverseFunc>
@@ -107,6 +162,7 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 	    // Construct the closest point KD tree over end points of segments.
 		auto coordinate_fn = [&end_points](size_t idx, size_t dimension) -> double { return end_points[idx].pos[dimension]; };
 		KDTreeIndirect<2, double, decltype(coordinate_fn)> kdtree(coordinate_fn, end_points.size());
+		KDTreePruning kdtree_pruning(end_points.size());
 
 		// Helper to detect loops in already connected paths.
 		// Unique chain IDs are assigned to paths. If paths are connected, end points will not have their chain IDs updated, but the chain IDs
@@ -301,6 +357,7 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 								equivalent_chain.merge(end_point1_other_chain_id, end_point2_other_chain_id));
 				end_point1.chain_id = chain_id;
 				end_point2.chain_id = chain_id;
+				kdtree_pruning.connected(2);
 				assert(validate_graph_and_queue());
 				if (iter == 0) {
 					// Last iteration. There shall be exactly one or two end points waiting to be connected.
@@ -322,6 +379,8 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 				end_point1.edge_out = nullptr;
 		    	// Update edge_out and distance.
 		    	size_t this_idx = &end_point1 - &end_points.front();
+				// Drop the connected end points from the KD tree if too many of them accumulated.
+				kdtree_pruning.prune(kdtree, end_points.size(), [&end_points](size_t idx) { return end_points[idx].chain_id == 0; });
 		    	// Find the closest point to this end_point, which lies on a different extrusion path (filtered by the filter lambda).
 				size_t next_idx = find_closest_point(kdtree, end_point1.pos, [&end_points, &equivalent_chain, this_idx](size_t idx) { 
 			    	assert(end_points[this_idx].edge_out == nullptr);
@@ -343,8 +402,6 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 #endif /* NDEBUG */
 				// Update position of this end point in the queue based on the distance calculated at the line above.
 				queue.update(end_point1.heap_idx);
-		    	//FIXME Remove the other end point from the KD tree.
-		    	// As the KD tree update is expensive, do it only after some larger number of points is removed from the queue.
 				assert(validate_graph_and_queue());
 	    	}
 		}
@@ -393,9 +450,11 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 					} while (first_point != nullptr);
 				}
 			}
-			if (failed)
+			if (failed) {
 				// As a last resort, try a dumb algorithm, which is not sensitive to edge reversal constraints.
+				kdtree_pruning.restore(kdtree, end_points.size());
 				out = chain_segments_closest_point<EndPoint, decltype(kdtree), CouldReverseFunc>(end_points, kdtree, could_reverse_func, (initial_point != nullptr) ? *initial_point : end_points.front());
+			}
 		} else {
 			assert(! failed);
 		}
@@ -526,6 +585,7 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 	    // Construct the closest point KD tree over end points of segments.
 		auto coordinate_fn = [&end_points](size_t idx, size_t dimension) -> double { return end_points[idx].pos[dimension]; };
 		KDTreeIndirect<2, double, decltype(coordinate_fn)> kdtree(coordinate_fn, end_points.size());
+		KDTreePruning kdtree_pruning(end_points.size());
 
 	    // Chained segments with their sum of connection lengths.
 	    // The chain supports flipping all the segments, connecting the segments at the opposite ends.
@@ -762,6 +822,8 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 		size_t num_iter = num_segments * 16;
 		for (size_t num_connections_to_end = num_segments - 1; num_iter > 0; -- num_iter) {
 			assert(validate_graph_and_queue());
+			// Drop the segments connected at both ends from the KD tree if too many of them accumulated.
+			kdtree_pruning.prune(kdtree, end_points.size(), [&end_points](size_t idx) { return end_points[idx].chain_id == 0 || end_points[idx ^ 1].chain_id == 0; });
 	    	// Take the first end point, for which the link points to the currently closest valid neighbor.
 	    	EndPoint *end_point1       = queue.top();
 	    	assert(end_point1 != first_point);
@@ -869,6 +931,7 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 					chain.begin->chain_id = 0;
 				if (chain.end != first_point)
 					chain.end->chain_id = 0;
+				kdtree_pruning.connected(2);
 				if (-- num_connections_to_end == 0) {
 					assert(validate_graph_and_queue());
 					// Last iteration. There shall be exactly one or two end points waiting to be connected.
@@ -922,8 +985,6 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 //					printf("Warning: taking shorter length than previously is suspicious\n");
 				}
 #endif /* NDEBUG */
-		    	//FIXME Remove the other end point from the KD tree.
-		    	// As the KD tree update is expensive, do it only after some larger number of points is removed from the queue.
 		    }
 			assert(validate_graph_and_queue());
 		}
@@ -972,9 +1033,11 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 					} while (first_point != nullptr);
 				}
 			}
-			if (failed)
+			if (failed) {
 				// As a last resort, try a dumb algorithm, which is not sensitive to edge reversal constraints.
+				kdtree_pruning.restore(kdtree, end_points.size());
 				out = chain_segments_closest_point<EndPoint, decltype(kdtree), CouldReverseFunc>(end_points, kdtree, could_reverse_func, (initial_point != nullptr) ? *initial_point : end_points.front());
+			}
 		} else {
 			assert(! failed);
 		}
@@ -1588,8 +1651,10 @@ static inline void do_crossover(const std::vector<FlipEdge> &edges_in, std::vect
 // Expected time complexity: O(min(n, 100) * (n * log n + k * n)
 // where n is the number of edges and k is the number of connection_lengths candidates after the first one
 // is found that improves the total cost.
+// The number of crossover costs evaluated is limited by max_evaluations to bound the running time with huge number of edges,
+// the improvements found until the budget is exhausted are kept. Counting evaluations keeps the result deterministic.
 //FIXME there are likley better heuristics to lower the time complexity.
-static inline void reorder_by_two_exchanges_with_segment_flipping(std::vector<FlipEdge> &edges)
+static inline void reorder_by_two_exchanges_with_segment_flipping(std::vector<FlipEdge> &edges, const size_t max_evaluations)
 {
 	if (edges.size() < 2)
 		return;
@@ -1599,6 +1664,7 @@ static inline void reorder_by_two_exchanges_with_segment_flipping(std::vector<Fl
 	std::vector<std::pair<double, size_t>>	connection_lengths(edges.size() - 1, std::pair<double, size_t>(0., 0));
 	std::vector<char>						connection_tried(edges.size(), false);
 	const size_t 							max_iterations = std::min(edges.size(), size_t(100));
+	size_t 									num_evaluations = 0;
 	for (size_t iter = 0; iter < max_iterations; ++ iter) {
 		// Initialize connection costs and connection lengths.
 		for (size_t i = 1; i < edges.size(); ++ i) {
@@ -1617,6 +1683,10 @@ static inline void reorder_by_two_exchanges_with_segment_flipping(std::vector<Fl
 		size_t crossover2_pos_final = std::numeric_limits<size_t>::max();
 		size_t crossover_flip_final = 0;
         for (const std::pair<double, size_t>& first_crossover_candidate : connection_lengths) {
+			if (num_evaluations >= max_evaluations)
+				// Out of budget.
+				break;
+			num_evaluations += connections.size();
             size_t longest_connection_idx = first_crossover_candidate.second;
 			connection_tried[longest_connection_idx] = true;
 			// Find the second crossover connection with the lowest total chain cost.
@@ -1918,7 +1988,8 @@ static inline void reorder_by_three_exchanges_with_segment_flipping2(std::vector
 // Flip the sequences of polylines to lower the total length of connecting lines.
 // Used by the infill generator if the infill is not connected with perimeter lines
 // and to order the brim lines.
-static inline void improve_ordering_by_two_exchanges_with_segment_flipping(Polylines &polylines, bool fixed_start)
+// The improvement is bounded by max_evaluations of crossover costs, see reorder_by_two_exchanges_with_segment_flipping().
+static inline void improve_ordering_by_two_exchanges_with_segment_flipping(Polylines &polylines, bool fixed_start, const size_t max_evaluations)
 {
 #ifndef NDEBUG
 	auto cost = [&polylines]() {
@@ -1941,7 +2012,7 @@ static inline void improve_ordering_by_two_exchanges_with_segment_flipping(Polyl
     std::transform(polylines.begin(), polylines.end(), std::back_inserter(edges), 
     	[&polylines](const Polyline &pl){ return FlipEdge(pl.first_point().cast<double>(), pl.last_point().cast<double>(), &pl - polylines.data()); });
 #if 1
-	reorder_by_two_exchanges_with_segment_flipping(edges);
+	reorder_by_two_exchanges_with_segment_flipping(edges, max_evaluations);
 #else
 	// reorder_by_three_exchanges_with_segment_flipping(edges);
 	reorder_by_three_exchanges_with_segment_flipping2(edges);
@@ -1989,7 +2060,10 @@ Polylines chain_polylines(Polylines &&polylines, const Point *start_near)
 				out.back().reverse();
 		}
 		if (out.size() > 1 && start_near == nullptr) {
-			improve_ordering_by_two_exchanges_with_segment_flipping(out, start_near != nullptr);
+			// A fraction of a second worth of crossover evaluations, which is only exhausted by thousands of polylines.
+			// The ordering produced by the greedy chaining above is already good, the improvement is not worth more.
+			static constexpr size_t max_crossover_evaluations = 250000;
+			improve_ordering_by_two_exchanges_with_segment_flipping(out, start_near != nullptr, max_crossover_evaluations);
 			//improve_ordering_by_segment_flipping(out, start_near != nullptr);
 		}
 	}
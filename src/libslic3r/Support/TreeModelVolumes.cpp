@@ -241,11 +241,41 @@ void TreeModelVolumes::precalculate(const PrintObject& print_object, const coord
     auto t_coll = std::chrono::high_resolution_clock::now();
 
     // Calculate the relevant avoidances in parallel as far as possible
-    {
+    auto calculate_avoidances = [this, &throw_on_cancel](const std::vector<RadiusLayerPair> &keys) {
         tbb::task_group task_group;
-        task_group.run([this, relevant_avoidance_radiis, throw_on_cancel]{ calculateAvoidance(relevant_avoidance_radiis, true, m_support_rests_on_model, throw_on_cancel); });
-        task_group.run([this, relevant_avoidance_radiis, throw_on_cancel]{ calculateWallRestrictions(relevant_avoidance_radiis, throw_on_cancel); });
+        task_group.run([this, &keys, throw_on_cancel]{ calculateAvoidance(keys, true, m_support_rests_on_model, throw_on_cancel); });
+        task_group.run([this, &keys, throw_on_cancel]{ calculateWallRestrictions(keys, throw_on_cancel); });
         task_group.wait();
+    };
+    if (m_memory_budget == 0)
+        calculate_avoidances(relevant_avoidance_radiis);
+    else {
+        // Avoidances and wall restrictions take most of the cache memory. Precalculate them in batches of radii starting with the smallest,
+        // which are requested most often by the tips, and stop once the memory budget is exhausted. The remaining radii are calculated
+        // on demand during pathing, where trim_caches() keeps the caches within the budget.
+        std::sort(relevant_avoidance_radiis.begin(), relevant_avoidance_radiis.end());
+        const size_t batch_size = std::max<size_t>(1, tbb::this_task_arena::max_concurrency() / 4);
+        size_t num_precalculated = 0;
+        while (num_precalculated < relevant_avoidance_radiis.size() && this->memory_usage() < m_memory_budget) {
+            std::vector<RadiusLayerPair> batch(relevant_avoidance_radiis.begin() + num_precalculated,
+                relevant_avoidance_radiis.begin() + std::min(num_precalculated + batch_size, relevant_avoidance_radiis.size()));
+            calculate_avoidances(batch);
+            num_precalculated += batch.size();
+            throw_on_cancel();
+            if (m_compress_caches)
+                // Compress the precalculated avoidances of the largest radii first, they are requested the least often.
+                for (size_t i = num_precalculated; i > 0 && this->memory_usage() >= m_memory_budget; -- i)
+                    for (RadiusLayerPolygonCache *cache : { &m_avoidance_cache, &m_avoidance_cache_slow, &m_avoidance_cache_to_model, &m_avoidance_cache_to_model_slow,
+                                                            &m_avoidance_cache_holefree, &m_avoidance_cache_holefree_to_model, &m_wall_restrictions_cache, &m_wall_restrictions_cache_min })
+                        cache->compress_radius(relevant_avoidance_radiis[i - 1].first);
+        }
+        if (num_precalculated < relevant_avoidance_radiis.size()) {
+            for (RadiusLayerPolygonCache *cache : { &m_avoidance_cache, &m_avoidance_cache_slow, &m_avoidance_cache_to_model, &m_avoidance_cache_to_model_slow,
+                                                    &m_avoidance_cache_holefree, &m_avoidance_cache_holefree_to_model, &m_wall_restrictions_cache, &m_wall_restrictions_cache_min })
+                cache->set_incomplete();
+            BOOST_LOG_TRIVIAL(info) << "Precalculated avoidances of " << num_precalculated << " out of " << relevant_avoidance_radiis.size() <<
+                " radii within the memory budget of " << m_memory_budget << " bytes, the rest will be calculated on demand.";
+        }
     }
     auto t_end = std::chrono::high_resolution_clock::now();
     auto dur_col = 0.001 * std::chrono::duration_cast<std::chrono::microseconds>(t_coll - t_start).count();
@@ -297,7 +327,7 @@ const Polygons& TreeModelVolumes::getCollision(const coord_t orig_radius, LayerI
     const coord_t radius = this->ceilRadius(orig_radius, min_xy_dist);
     if (std::optional<std::reference_wrapper<const Polygons>> result = m_collision_cache.getArea({ radius, layer_idx }); result)
         return (*result).get();
-    if (m_precalculated) {
+    if (m_precalculated && ! m_collision_cache.incomplete()) {
         BOOST_LOG_TRIVIAL(error_level_not_in_cache) << "Had to calculate collision at radius " << radius << " and layer " << layer_idx << ", but precalculate was called. Performance may suffer!";
         tree_supports_show_error("Not precalculated Collision requested."sv, false);
     }
@@ -320,7 +350,7 @@ const Polygons& TreeModelVolumes::getCollisionHolefree(coord_t radius, LayerInde
     assert(radius < m_increase_until_radius + m_current_min_xy_dist_delta);
     if (std::optional<std::reference_wrapper<const Polygons>> result = m_collision_cache_holefree.getArea({ radius, layer_idx }); result)
         return (*result).get();
-    if (m_precalculated) {
+    if (m_precalculated && ! m_collision_cache_holefree.incomplete()) {
         BOOST_LOG_TRIVIAL(error_level_not_in_cache) << "Had to calculate collision holefree at radius " << radius << " and layer " << layer_idx << ", but precalculate was called. Performance may suffer!";
         tree_supports_show_error("Not precalculated Holefree Collision requested."sv, false);
     }
@@ -343,7 +373,7 @@ const Polygons& TreeModelVolumes::getAvoidance(const coord_t orig_radius, LayerI
         result)
         return (*result).get();
 
-    if (m_precalculated) {
+    if (m_precalculated && ! this->avoidance_cache(type, to_model).incomplete()) {
         if (to_model) {
             BOOST_LOG_TRIVIAL(error_level_not_in_cache) << "Had to calculate Avoidance to model at radius " << radius << " and layer " << layer_idx << ", but precalculate was called. Performance may suffer!";
             tree_supports_show_error("Not precalculated Avoidance(to model) requested."sv, false);
@@ -362,7 +392,7 @@ const Polygons& TreeModelVolumes::getPlaceableAreas(const coord_t orig_radius, L
     const coord_t radius = ceilRadius(orig_radius);
     if (std::optional<std::reference_wrapper<const Polygons>> result = m_placeable_areas_cache.getArea({ radius, layer_idx }); result)
         return (*result).get();
-    if (m_precalculated) {
+    if (m_precalculated && ! m_placeable_areas_cache.incomplete()) {
         BOOST_LOG_TRIVIAL(error_level_not_in_cache) << "Had to calculate Placeable Areas at radius " << radius << " and layer " << layer_idx << ", but precalculate was called. Performance may suffer!";
         tree_supports_show_error(format("Not precalculated Placeable areas requested, radius %1%, layer %2%", radius, layer_idx), false);
     }
@@ -389,7 +419,7 @@ const Polygons& TreeModelVolumes::getWallRestriction(const coord_t orig_radius,
         (min_xy_dist ? m_wall_restrictions_cache_min : m_wall_restrictions_cache).getArea({ radius, layer_idx });
         result)
         return (*result).get();
-    if (m_precalculated) {
+    if (m_precalculated && ! (min_xy_dist ? m_wall_restrictions_cache_min : m_wall_restrictions_cache).incomplete()) {
         BOOST_LOG_TRIVIAL(error_level_not_in_cache) << "Had to calculate Wall restricions at radius " << radius << " and layer " << layer_idx << ", but precalculate was called. Performance may suffer!";
         tree_supports_show_error(
             min_xy_dist ? 
@@ -853,23 +883,358 @@ coord_t TreeModelVolumes::ceilRadius(const coord_t radius) const
     return out;
 }
 
-void TreeModelVolumes::RadiusLayerPolygonCache::allocate_layers(size_t num_layers)
+size_t TreeModelVolumes::memory_usage() const
+{
+    return m_collision_cache.memory() + m_collision_cache_holefree.memory() + m_avoidance_cache.memory() + m_avoidance_cache_slow.memory() +
+        m_avoidance_cache_to_model.memory() + m_avoidance_cache_to_model_slow.memory() + m_placeable_areas_cache.memory() +
+        m_avoidance_cache_holefree.memory() + m_avoidance_cache_holefree_to_model.memory() +
+        m_wall_restrictions_cache.memory() + m_wall_restrictions_cache_min.memory();
+}
+
+void TreeModelVolumes::trim_caches(LayerIndex layer_idx)
+{
+    if (m_memory_budget == 0)
+        return;
+
+    // Caches only used when propagating the influence areas, which may be recalculated on demand.
+    RadiusLayerPolygonCache* const evictable[] = {
+        &m_collision_cache_holefree, &m_avoidance_cache, &m_avoidance_cache_slow, &m_avoidance_cache_to_model, &m_avoidance_cache_to_model_slow,
+        &m_avoidance_cache_holefree, &m_avoidance_cache_holefree_to_model, &m_wall_restrictions_cache, &m_wall_restrictions_cache_min
+    };
+    RadiusLayerPolygonCache* const all[] = {
+        &m_collision_cache, &m_placeable_areas_cache,
+        &m_collision_cache_holefree, &m_avoidance_cache, &m_avoidance_cache_slow, &m_avoidance_cache_to_model, &m_avoidance_cache_to_model_slow,
+        &m_avoidance_cache_holefree, &m_avoidance_cache_holefree_to_model, &m_wall_restrictions_cache, &m_wall_restrictions_cache_min
+    };
+    for (RadiusLayerPolygonCache *cache : all)
+        cache->tick();
+
+    size_t memory = this->memory_usage();
+    if (memory <= m_memory_budget)
+        return;
+    const size_t memory_initial = memory;
+
+    // 1) Drop the avoidances and wall restrictions above the current layer, they will not be requested anymore.
+    for (RadiusLayerPolygonCache *cache : evictable)
+        if (cache != &m_collision_cache_holefree)
+            memory -= cache->evict_layers_from(layer_idx);
+
+    // 2) Compress the least recently used radii. Radii used since the last call are kept uncompressed.
+    if (m_compress_caches && memory > m_memory_budget) {
+        std::vector<std::pair<RadiusLayerPolygonCache*, RadiusLayerPolygonCache::RadiusUsage>> usage;
+        for (RadiusLayerPolygonCache *cache : all)
+            for (const RadiusLayerPolygonCache::RadiusUsage &u : cache->radius_usage())
+                if (u.memory_uncompressed > 0 && u.last_used + 1 < cache->current_tick())
+                    usage.emplace_back(cache, u);
+        std::stable_sort(usage.begin(), usage.end(), [](auto &l, auto &r){ return l.second.last_used < r.second.last_used; });
+        for (auto it = usage.begin(); it != usage.end() && memory > m_memory_budget; ++ it)
+            memory -= it->first->compress_radius(it->second.radius);
+    }
+
+    // 3) Drop the least recently used radii from all the caches, which may be recalculated on demand.
+    if (memory > m_memory_budget) {
+        std::map<coord_t, uint32_t> last_used;
+        for (RadiusLayerPolygonCache *cache : evictable)
+            for (const RadiusLayerPolygonCache::RadiusUsage &u : cache->radius_usage())
+                if (u.last_used + 1 < cache->current_tick())
+                    if (auto [it, inserted] = last_used.insert({ u.radius, u.last_used }); ! inserted)
+                        it->second = std::max(it->second, u.last_used);
+        std::vector<std::pair<coord_t, uint32_t>> radii(last_used.begin(), last_used.end());
+        std::stable_sort(radii.begin(), radii.end(), [](auto &l, auto &r){ return l.second < r.second; });
+        for (auto it = radii.begin(); it != radii.end() && memory > m_memory_budget; ++ it)
+            for (RadiusLayerPolygonCache *cache : evictable)
+                memory -= cache->evict_radius(it->first);
+    }
+
+    BOOST_LOG_TRIVIAL(debug) << "Tree support caches trimmed at layer " << layer_idx << " from " << memory_initial << " to " << memory << " bytes";
+}
+
+// Compression of polygons stored in RadiusLayerPolygonCache: zig-zag encoded deltas of point coordinates stored as variable length integers.
+static inline void append_varint(std::vector<uint8_t> &out, uint64_t v)
+{
+    for (; v >= 0x80; v >>= 7)
+        out.emplace_back(uint8_t(v | 0x80));
+    out.emplace_back(uint8_t(v));
+}
+
+static inline uint64_t read_varint(const uint8_t *&in)
+{
+    uint64_t v = 0;
+    for (int shift = 0;; shift += 7) {
+        uint8_t b = *in ++;
+        v |= uint64_t(b & 0x7f) << shift;
+        if ((b & 0x80) == 0)
+            return v;
+    }
+}
+
+static inline void append_varint_signed(std::vector<uint8_t> &out, int64_t v) { append_varint(out, (uint64_t(v) << 1) ^ uint64_t(v >> 63)); }
+static inline int64_t read_varint_signed(const uint8_t *&in) { uint64_t v = read_varint(in); return int64_t(v >> 1) ^ - int64_t(v & 1); }
+
+static std::vector<uint8_t> compress_polygons(const Polygons &polygons)
+{
+    std::vector<uint8_t> out;
+    append_varint(out, polygons.size());
+    for (const Polygon &polygon : polygons) {
+        append_varint(out, polygon.size());
+        Point prev = Point::Zero();
+        for (const Point &pt : polygon.points) {
+            append_varint_signed(out, int64_t(pt.x() - prev.x()));
+            append_varint_signed(out, int64_t(pt.y() - prev.y()));
+            prev = pt;
+        }
+    }
+    out.shrink_to_fit();
+    return out;
+}
+
+static Polygons decompress_polygons(const std::vector<uint8_t> &data)
 {
-    if (num_layers > m_data.size()) {
-        if (num_layers > m_data.capacity())
-            reserve_power_of_2(m_data, num_layers);
-        m_data.resize(num_layers, {});
+    const uint8_t *in = data.data();
+    Polygons out(read_varint(in));
+    for (Polygon &polygon : out) {
+        polygon.points.resize(read_varint(in));
+        Point prev = Point::Zero();
+        for (Point &pt : polygon.points) {
+            prev.x() += coord_t(read_varint_signed(in));
+            prev.y() += coord_t(read_varint_signed(in));
+            pt = prev;
+        }
+    }
+    assert(in == data.data() + data.size());
+    return out;
+}
+
+static inline size_t polygons_memory(const Polygons &polygons)
+{
+    size_t out = polygons.capacity() * sizeof(Polygon);
+    for (const Polygon &polygon : polygons)
+        out += polygon.points.capacity() * sizeof(Point);
+    return out;
+}
+
+void TreeModelVolumes::RadiusLayerPolygonCache::emplace(LayerIndex layer_idx, coord_t radius, Polygons &&polygons)
+{
+    assert(layer_idx >= 0);
+    Shard &s = this->shard(layer_idx);
+    {
+        std::lock_guard<std::mutex> guard(s.mutex);
+        size_t idx = size_t(layer_idx) / NumShards;
+        if (idx >= s.layers.size()) {
+            if (idx >= s.layers.capacity())
+                reserve_power_of_2(s.layers, idx + 1);
+            s.layers.resize(idx + 1, {});
+        }
+        if (auto [it, inserted] = s.layers[idx].try_emplace(radius); inserted) {
+            it->second.polygons = std::move(polygons);
+            it->second.memory   = polygons_memory(it->second.polygons);
+            RadiusStats &stats = s.radii[radius];
+            stats.last_used = this->current_tick();
+            stats.memory_uncompressed += it->second.memory;
+            ++ stats.num_entries;
+            m_data->memory += it->second.memory;
+        }
+    }
+    for (LayerIndex num_layers = m_data->num_layers.load(); num_layers <= layer_idx && ! m_data->num_layers.compare_exchange_weak(num_layers, layer_idx + 1);) ;
+    // A layer was filled above the layers dropped by evict_layers_from(), the next call has to visit it.
+    for (LayerIndex evicted_from = m_data->evicted_from.load(); evicted_from <= layer_idx && ! m_data->evicted_from.compare_exchange_weak(evicted_from, layer_idx + 1);) ;
+}
+
+const Polygons& TreeModelVolumes::RadiusLayerPolygonCache::access(Shard &shard, coord_t radius, Entry &entry) const
+{
+    auto it_stats = shard.radii.find(radius);
+    assert(it_stats != shard.radii.end());
+    it_stats->second.last_used = this->current_tick();
+    if (! entry.compressed.empty()) {
+        entry.polygons = decompress_polygons(entry.compressed);
+        entry.compressed = {};
+        size_t memory = polygons_memory(entry.polygons);
+        m_data->memory += memory;
+        m_data->memory -= entry.memory;
+        entry.memory = memory;
+        it_stats->second.memory_uncompressed += memory;
+    }
+    return entry.polygons;
+}
+
+size_t TreeModelVolumes::RadiusLayerPolygonCache::release(Shard &shard, coord_t radius, const Entry &entry) const
+{
+    auto it_stats = shard.radii.find(radius);
+    assert(it_stats != shard.radii.end());
+    if (entry.compressed.empty())
+        it_stats->second.memory_uncompressed -= entry.memory;
+    if (-- it_stats->second.num_entries == 0)
+        shard.radii.erase(it_stats);
+    return entry.memory;
+}
+
+std::optional<std::reference_wrapper<const Polygons>> TreeModelVolumes::RadiusLayerPolygonCache::getArea(const TreeModelVolumes::RadiusLayerPair &key) const
+{
+    if (key.second < 0)
+        return std::optional<std::reference_wrapper<const Polygons>>{};
+    Shard &s = this->shard(key.second);
+    std::lock_guard<std::mutex> guard(s.mutex);
+    LayerData *layer = this->layer_data(key.second);
+    if (layer == nullptr)
+        return std::optional<std::reference_wrapper<const Polygons>>{};
+    auto it = layer->find(key.first);
+    return it == layer->end() ?
+        std::optional<std::reference_wrapper<const Polygons>>{} : std::optional<std::reference_wrapper<const Polygons>>{ this->access(s, it->first, it->second) };
+}
+
+std::optional<std::pair<coord_t, std::reference_wrapper<const Polygons>>> TreeModelVolumes::RadiusLayerPolygonCache::get_lower_bound_area(const TreeModelVolumes::RadiusLayerPair &key) const
+{
+    if (key.second < 0)
+        return {};
+    Shard &s = this->shard(key.second);
+    std::lock_guard<std::mutex> guard(s.mutex);
+    LayerData *layer = this->layer_data(key.second);
+    if (layer == nullptr || layer->empty())
+        return {};
+    auto it = layer->lower_bound(key.first);
+    if (it == layer->end() || it->first != key.first) {
+        if (it == layer->begin())
+            return {};
+        -- it;
+    }
+    return std::make_pair(it->first, std::reference_wrapper<const Polygons>(this->access(s, it->first, it->second)));
+}
+
+LayerIndex TreeModelVolumes::RadiusLayerPolygonCache::getMaxCalculatedLayer(coord_t radius) const
+{
+    auto layer_idx = m_data->num_layers.load() - 1;
+    for (; layer_idx > 0; -- layer_idx) {
+        std::lock_guard<std::mutex> guard(this->shard(layer_idx).mutex);
+        if (const LayerData *layer = this->layer_data(layer_idx); layer && layer->find(radius) != layer->end())
+            break;
+    }
+    // The placeable on model areas do not exist on layer 0, as there can not be model below it. As such it may be possible that layer 1 is available, but layer 0 does not exist.
+    return layer_idx <= 0 ? -1 : layer_idx;
+}
+
+void TreeModelVolumes::RadiusLayerPolygonCache::clear()
+{
+    for (Shard &s : m_data->shards) {
+        std::lock_guard<std::mutex> guard(s.mutex);
+        s.layers.clear();
+        s.radii.clear();
+    }
+    m_data->num_layers   = 0;
+    m_data->memory       = 0;
+    m_data->evicted_from = std::numeric_limits<LayerIndex>::max();
+}
+
+void TreeModelVolumes::RadiusLayerPolygonCache::clear_all_but_radius0()
+{
+    for (Shard &s : m_data->shards) {
+        std::lock_guard<std::mutex> guard(s.mutex);
+        for (LayerData &l : s.layers) {
+            auto begin = l.begin();
+            auto end = l.end();
+            if (begin != end && ++ begin != end) {
+                for (auto it = begin; it != end; ++ it)
+                    m_data->memory -= this->release(s, it->first, it->second);
+                l.erase(begin, end);
+            }
+        }
+    }
+}
+
+std::vector<TreeModelVolumes::RadiusLayerPolygonCache::RadiusUsage> TreeModelVolumes::RadiusLayerPolygonCache::radius_usage() const
+{
+    std::map<coord_t, RadiusUsage> usage;
+    for (Shard &s : m_data->shards) {
+        std::lock_guard<std::mutex> guard(s.mutex);
+        for (const auto &[radius, stats] : s.radii) {
+            auto [it, inserted] = usage.insert({ radius, RadiusUsage{ radius, stats.last_used, 0 } });
+            it->second.last_used = std::max(it->second.last_used, stats.last_used);
+            it->second.memory_uncompressed += stats.memory_uncompressed;
+        }
+    }
+    std::vector<RadiusUsage> out;
+    out.reserve(usage.size());
+    for (const auto &u : usage)
+        out.emplace_back(u.second);
+    return out;
+}
+
+size_t TreeModelVolumes::RadiusLayerPolygonCache::evict_layers_from(LayerIndex layer_idx)
+{
+    layer_idx = std::max(layer_idx, 0);
+    // Layers starting with evicted_from are empty already.
+    const LayerIndex layer_end = std::min(m_data->evicted_from.load(), m_data->num_layers.load());
+    size_t released = 0;
+    for (LayerIndex i = layer_idx; i < layer_end; ++ i) {
+        Shard &s = this->shard(i);
+        std::lock_guard<std::mutex> guard(s.mutex);
+        if (LayerData *layer = this->layer_data(i); layer) {
+            for (const auto &radius_entry : *layer)
+                released += this->release(s, radius_entry.first, radius_entry.second);
+            layer->clear();
+        }
+    }
+    m_data->evicted_from = std::min(layer_idx, m_data->evicted_from.load());
+    m_data->memory -= released;
+    return released;
+}
+
+size_t TreeModelVolumes::RadiusLayerPolygonCache::evict_radius(coord_t radius)
+{
+    size_t released = 0;
+    for (Shard &s : m_data->shards) {
+        std::lock_guard<std::mutex> guard(s.mutex);
+        if (s.radii.find(radius) == s.radii.end())
+            continue;
+        for (LayerData &l : s.layers)
+            if (auto it = l.find(radius); it != l.end()) {
+                released += this->release(s, radius, it->second);
+                l.erase(it);
+            }
+    }
+    if (released > 0) {
+        m_data->memory -= released;
+        m_data->incomplete = true;
+    }
+    return released;
+}
+
+size_t TreeModelVolumes::RadiusLayerPolygonCache::compress_radius(coord_t radius)
+{
+    size_t released = 0;
+    for (Shard &s : m_data->shards) {
+        std::lock_guard<std::mutex> guard(s.mutex);
+        auto it_stats = s.radii.find(radius);
+        if (it_stats == s.radii.end() || it_stats->second.memory_uncompressed == 0)
+            continue;
+        for (LayerData &l : s.layers)
+            if (auto it = l.find(radius); it != l.end() && it->second.compressed.empty() && ! it->second.polygons.empty()) {
+                Entry &entry = it->second;
+                it_stats->second.memory_uncompressed -= entry.memory;
+                entry.compressed = compress_polygons(entry.polygons);
+                entry.polygons   = {};
+                size_t memory = entry.compressed.capacity();
+                if (memory < entry.memory)
+                    released += entry.memory - memory;
+                else
+                    // Compression is not expected to expand the data, account for it anyway.
+                    m_data->memory += memory - entry.memory;
+                entry.memory = memory;
+            }
     }
+    m_data->memory -= released;
+    return released;
 }
 
 // For debugging purposes, sorted by layer index, then by radius.
 std::vector<std::pair<TreeModelVolumes::RadiusLayerPair, std::reference_wrapper<const Polygons>>> TreeModelVolumes::RadiusLayerPolygonCache::sorted() const
 {
     std::vector<std::pair<RadiusLayerPair, std::reference_wrapper<const Polygons>>> out;
-    for (auto &layer : m_data) {
-        auto layer_idx = LayerIndex(&layer - m_data.data());
-        for (auto &radius_polygons : layer)
-            out.emplace_back(std::make_pair(radius_polygons.first, layer_idx), radius_polygons.second);
+    for (LayerIndex layer_idx = 0; layer_idx < m_data->num_layers.load(); ++ layer_idx) {
+        Shard &s = this->shard(layer_idx);
+        std::lock_guard<std::mutex> guard(s.mutex);
+        if (LayerData *layer = this->layer_data(layer_idx); layer)
+            for (auto &radius_entry : *layer)
+                out.emplace_back(std::make_pair(radius_entry.first, layer_idx), this->access(s, radius_entry.first, radius_entry.second));
     }
     assert(std::is_sorted(out.begin(), out.end(), [](auto &l, auto &r){ return l.first.second < r.first.second || (l.first.second == r.first.second) && l.first.first < r.first.first; }));
     return out;
@@ -13,6 +13,11 @@
 #ifndef slic3r_TreeModelVolumes_hpp
 #define slic3r_TreeModelVolumes_hpp
 
+#include <array>
+#include <atomic>
+#include <limits>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <unordered_map>
 
@@ -171,6 +176,29 @@ public:
             this->ceilRadius(radius + m_current_min_xy_dist_delta) - m_current_min_xy_dist_delta;
     }
 
+    /*!
+     * \brief Limit the memory occupied by the cached collisions, avoidances etc., see precalculate() and trim_caches().
+     * Has to be set before precalculate() is called.
+     * \param memory_budget Memory budget in bytes, zero for unlimited.
+     * \param compress Compress the least recently used radii before dropping them.
+     */
+    void set_memory_budget(size_t memory_budget, bool compress) { m_memory_budget = memory_budget; m_compress_caches = compress; }
+    /*!
+     * \brief Memory occupied by all the caches.
+     */
+    size_t memory_usage() const;
+    /*!
+     * \brief Release cached areas to fit the memory budget. Called by create_layer_pathing() once the influence areas were propagated
+     * from layer_idx, thus avoidances and wall restrictions starting with layer_idx will not be requested anymore.
+     *
+     * These are dropped first, then the least recently used radii are compressed and finally dropped from the avoidance, wall restriction
+     * and holefree collision caches, to be recalculated on demand. Collisions and placeable areas are never dropped, they are used after the pathing.
+     * Invalidates references returned by the getters, thus it must not be called while such a reference is held.
+     * The caches track the layers already dropped and the memory per radius, thus a call costs O(1) amortized when called for descending layers.
+     * \param layer_idx The lowest layer, that has already been processed.
+     */
+    void trim_caches(LayerIndex layer_idx);
+
 private:
     // Caching polygons for a range of layers.
     class LayerPolygonCache {
@@ -199,74 +227,83 @@ private:
      * \brief Convenience typedef for the keys to the caches
      */
     using RadiusLayerPair             = std::pair<coord_t, LayerIndex>;
+    // Cache of polygons indexed by radius and layer.
+    // Layers are distributed into shards guarded by their own mutexes, thus threads working on different layers rarely contend.
+    // Memory occupied by the cache is tracked, so that trim_caches() may compress or drop the cached polygons to fit a memory budget.
     class RadiusLayerPolygonCache {
+        struct Entry {
+            // Cached polygons, empty if compressed.
+            Polygons                polygons;
+            // Polygons compressed by compress(), empty if not compressed.
+            std::vector<uint8_t>    compressed;
+            // Memory occupied by this entry, as accounted in Data::memory.
+            size_t                  memory { 0 };
+        };
+        // Usage of a single radius over the layers of a single shard.
+        struct RadiusStats {
+            // Value of Data::tick at the last access.
+            uint32_t                last_used { 0 };
+            // Memory occupied by the uncompressed entries.
+            size_t                  memory_uncompressed { 0 };
+            size_t                  num_entries { 0 };
+        };
         // Map from radius to Polygons. Cache of one layer collision regions.
-        using LayerData = std::map<coord_t, Polygons>;
-        // Vector of layers, at each layer map of radius to Polygons.
         // Reference to Polygons returned shall be stable to insertion.
-        using Layers = std::vector<LayerData>;
+        using LayerData = std::map<coord_t, Entry>;
+        static constexpr const size_t NumShards = 32;
+        struct Shard {
+            // Layers with layer_idx % NumShards == shard index, indexed by layer_idx / NumShards.
+            std::vector<LayerData>  layers;
+            // Statistics of radii stored in this shard, maintained incrementally for trim_caches().
+            std::map<coord_t, RadiusStats> radii;
+            std::mutex              mutex;
+        };
+        struct Data {
+            std::array<Shard, NumShards>    shards;
+            // Number of layers allocated over all shards.
+            std::atomic<LayerIndex>         num_layers { 0 };
+            std::atomic<size_t>             memory { 0 };
+            // Incremented by trim_caches(), used to find the least recently used radii.
+            std::atomic<uint32_t>           tick { 0 };
+            // Layers starting with this one were dropped by evict_layers_from() and none was inserted since.
+            std::atomic<LayerIndex>         evicted_from { std::numeric_limits<LayerIndex>::max() };
+            // Some radius was evicted or not precalculated, thus its areas may be calculated on demand.
+            std::atomic<bool>               incomplete { false };
+        };
     public:
-        RadiusLayerPolygonCache() = default;
-        RadiusLayerPolygonCache(RadiusLayerPolygonCache &&rhs) : m_data(std::move(rhs.m_data)) {}
-        RadiusLayerPolygonCache& operator=(RadiusLayerPolygonCache &&rhs) { m_data = std::move(rhs.m_data); return *this; }
+        RadiusLayerPolygonCache() : m_data(std::make_unique<Data>()) {}
+        RadiusLayerPolygonCache(RadiusLayerPolygonCache &&rhs) = default;
+        RadiusLayerPolygonCache& operator=(RadiusLayerPolygonCache &&rhs) = default;
 
         RadiusLayerPolygonCache(const RadiusLayerPolygonCache&) = delete;
         RadiusLayerPolygonCache& operator=(const RadiusLayerPolygonCache&) = delete;
 
         void insert(std::vector<std::pair<RadiusLayerPair, Polygons>> &&in) {
-            std::lock_guard<std::mutex> guard(m_mutex);
             for (auto &d : in)
-                this->get_allocate_layer_data(d.first.second).emplace(d.first.first, std::move(d.second));
+                this->emplace(d.first.second, d.first.first, std::move(d.second));
         }
         // by layer
         void insert(std::vector<std::pair<coord_t, Polygons>> &&in, coord_t radius) {
-            std::lock_guard<std::mutex> guard(m_mutex);
             for (auto &d : in)
-                this->get_allocate_layer_data(d.first).emplace(radius, std::move(d.second));
+                this->emplace(d.first, radius, std::move(d.second));
         }
         void insert(std::vector<Polygons> &&in, coord_t first_layer_idx, coord_t radius) {
-            std::lock_guard<std::mutex> guard(m_mutex);
-            allocate_layers(first_layer_idx + in.size());
             for (auto &d : in)
-                m_data[first_layer_idx ++].emplace(radius, std::move(d));
+                this->emplace(first_layer_idx ++, radius, std::move(d));
         }
         void insert(LayerPolygonCache &&in, coord_t radius) {
-            std::lock_guard<std::mutex> guard(m_mutex);
             LayerIndex i = in.begin();
-            allocate_layers(i + LayerIndex(in.size()));
             for (auto &d : in.polygons_mutable())
-                m_data[i ++].emplace(radius, std::move(d));
+                this->emplace(i ++, radius, std::move(d));
         }
         /*!
          * \brief Checks a cache for a given RadiusLayerPair and returns it if it is found
          * \param key RadiusLayerPair of the requested areas. The radius will be calculated up to the provided layer.
          * \return A wrapped optional reference of the requested area (if it was found, an empty optional if nothing was found)
          */
-        std::optional<std::reference_wrapper<const Polygons>> getArea(const TreeModelVolumes::RadiusLayerPair &key) const {
-            std::lock_guard<std::mutex> guard(m_mutex);
-            if (key.second >= LayerIndex(m_data.size()))
-                return std::optional<std::reference_wrapper<const Polygons>>{};
-            const auto &layer = m_data[key.second];
-            auto it = layer.find(key.first);
-            return it == layer.end() ? 
-                std::optional<std::reference_wrapper<const Polygons>>{} : std::optional<std::reference_wrapper<const Polygons>>{ it->second };
-        }
+        std::optional<std::reference_wrapper<const Polygons>> getArea(const TreeModelVolumes::RadiusLayerPair &key) const;
         // Get a collision area at a given layer for a radius that is a lower or equial to the key radius.
-        std::optional<std::pair<coord_t, std::reference_wrapper<const Polygons>>> get_lower_bound_area(const TreeModelVolumes::RadiusLayerPair &key) const {
-            std::lock_guard<std::mutex> guard(m_mutex);
-            if (key.second >= LayerIndex(m_data.size()))
-                return {};
-            const auto &layer = m_data[key.second];
-            if (layer.empty())
-                return {};
-            auto it = layer.lower_bound(key.first);
-            if (it == layer.end() || it->first != key.first) {
-                if (it == layer.begin())
-                    return {};
-                -- it;
-            }
-            return std::make_pair(it->first, std::reference_wrapper<const Polygons>(it->second));
-        }
+        std::optional<std::pair<coord_t, std::reference_wrapper<const Polygons>>> get_lower_bound_area(const TreeModelVolumes::RadiusLayerPair &key) const;
         /*!
          * \brief Get the highest already calculated layer in the cache.
          * \param radius The radius for which the highest already calculated layer has to be found.
@@ -274,38 +311,56 @@ private:
          *
          * \return A wrapped optional reference of the requested area (if it was found, an empty optional if nothing was found)
          */
-        LayerIndex getMaxCalculatedLayer(coord_t radius) const {
-            std::lock_guard<std::mutex> guard(m_mutex);
-            auto layer_idx = LayerIndex(m_data.size()) - 1;
-            for (; layer_idx > 0; -- layer_idx)
-                if (const auto &layer = m_data[layer_idx]; layer.find(radius) != layer.end())
-                    break;
-            // The placeable on model areas do not exist on layer 0, as there can not be model below it. As such it may be possible that layer 1 is available, but layer 0 does not exist.
-            return layer_idx == 0 ? -1 : layer_idx;
-        }
+        LayerIndex getMaxCalculatedLayer(coord_t radius) const;
 
         // For debugging purposes, sorted by layer index, then by radius.
         [[nodiscard]] std::vector<std::pair<RadiusLayerPair, std::reference_wrapper<const Polygons>>> sorted() const;
 
-        void clear() { m_data.clear(); }
-        void clear_all_but_radius0() { 
-            for (LayerData &l : m_data) {
-                auto begin = l.begin();
-                auto end = l.end();
-                if (begin != end && ++ begin != end)
-                    l.erase(begin, end);
-            }
-        }
+        void clear();
+        void clear_all_but_radius0();
+
+        // Memory occupied by the cached polygons.
+        size_t memory() const { return m_data->memory.load(std::memory_order_relaxed); }
+        // Was any radius evicted by evict_radius() or skipped by precalculation, thus it may have to be calculated on demand?
+        bool   incomplete() const { return m_data->incomplete.load(std::memory_order_relaxed); }
+        void   set_incomplete() { m_data->incomplete = true; }
+        void   tick() { ++ m_data->tick; }
+        uint32_t current_tick() const { return m_data->tick.load(std::memory_order_relaxed); }
+
+        struct RadiusUsage {
+            coord_t  radius;
+            // Tick of the last access to any layer of this radius.
+            uint32_t last_used;
+            // Memory occupied by the uncompressed layers of this radius.
+            size_t   memory_uncompressed;
+        };
+        // Sorted by radius. Collected from the per shard statistics, independent of the number of layers.
+        std::vector<RadiusUsage> radius_usage() const;
+
+        // The following methods invalidate the references returned by getArea() and get_lower_bound_area().
+        // Drop all radii at layers starting with layer_idx. Only visits the layers not dropped by the previous call.
+        // Returns the amount of memory released.
+        size_t evict_layers_from(LayerIndex layer_idx);
+        // Drop all layers of a radius. Returns the amount of memory released.
+        size_t evict_radius(coord_t radius);
+        // Compress all layers of a radius, they are decompressed on demand. Returns the amount of memory released.
+        size_t compress_radius(coord_t radius);
 
     private:
-        LayerData&          get_allocate_layer_data(LayerIndex layer_idx) {
-            allocate_layers(layer_idx + 1);
-            return m_data[layer_idx];
+        Shard&              shard(LayerIndex layer_idx) const { return m_data->shards[size_t(layer_idx) % NumShards]; }
+        // Shard has to be locked.
+        LayerData*          layer_data(LayerIndex layer_idx) const {
+            Shard &s = this->shard(layer_idx);
+            size_t idx = size_t(layer_idx) / NumShards;
+            return idx < s.layers.size() ? &s.layers[idx] : nullptr;
         }
-        void                allocate_layers(size_t num_layers);
+        void                emplace(LayerIndex layer_idx, coord_t radius, Polygons &&polygons);
+        // Shard has to be locked. Decompresses the entry if needed.
+        const Polygons&     access(Shard &shard, coord_t radius, Entry &entry) const;
+        // Shard has to be locked. Removes the entry from the shard statistics, returns the memory occupied by the entry.
+        size_t              release(Shard &shard, coord_t radius, const Entry &entry) const;
 
-        Layers              m_data;
-        mutable std::mutex  m_mutex;
+        std::unique_ptr<Data> m_data;
     };
 
 
@@ -432,6 +487,14 @@ private:
     coord_t m_min_resolution;
 
     bool m_precalculated = false;
+    /*!
+     * \brief Memory budget of the caches in bytes, zero for unlimited. See trim_caches().
+     */
+    size_t m_memory_budget = 0;
+    /*!
+     * \brief Compress the least recently used radii before dropping them when running over m_memory_budget.
+     */
+    bool m_compress_caches = false;
     /*!
      * \brief The index to access the outline corresponding with the currently processing mesh
      */
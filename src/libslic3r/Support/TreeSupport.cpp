@@ -26,6 +26,7 @@
 #include "../Polygon.hpp"
 #include "../Polyline.hpp"
 #include "../MutablePolygon.hpp"
+#include "../Utils.hpp"
 
 #include <cassert>
 #include <chrono>
@@ -2408,7 +2409,7 @@ static void merge_influence_areas(
  *
  * \param move_bounds[in,out] All currently existing influence areas
  */
-static void create_layer_pathing(const TreeModelVolumes &volumes, const TreeSupportSettings &config, std::vector<SupportElements> &move_bounds, std::function<void()> throw_on_cancel)
+static void create_layer_pathing(TreeModelVolumes &volumes, const TreeSupportSettings &config, std::vector<SupportElements> &move_bounds, std::function<void()> throw_on_cancel)
 {
 #ifdef SLIC3R_TREESUPPORTS_PROGRESS
     const double data_size_inverse = 1 / double(move_bounds.size());
@@ -2499,6 +2500,8 @@ static void create_layer_pathing(const TreeModelVolumes &volumes, const TreeSupp
             progress_total += data_size_inverse * TREE_PROGRESS_AREA_CALC;
             Progress::messageProgress(Progress::Stage::SUPPORT, progress_total * m_progress_multiplier + m_progress_offset, TREE_PROGRESS_TOTAL);
     #endif
+            // Avoidances and wall restrictions of this layer and above will not be needed anymore.
+            volumes.trim_caches(layer_idx);
             throw_on_cancel();
         }
 
@@ -3450,6 +3453,10 @@ static void generate_support_areas(Print &print, const BuildVolume &build_volume
             m_progress_multiplier, m_progress_offset, 
 #endif // SLIC3R_TREESUPPORTS_PROGRESS
             /* additional_excluded_areas */{} };
+        // Keep the cached collisions and avoidances within the configured share of the physical memory,
+        // compress and drop the least recently used ones if needed.
+        if (double memory_limit = std::min(print_object.config().support_tree_cache_memory_limit.value, 100.); memory_limit > 0.)
+            volumes.set_memory_budget(size_t(double(total_physical_memory()) * memory_limit / 100.), true);
 
         //FIXME generating overhangs just for the furst mesh of the group.
         assert(processing.second.size() == 1);
@@ -1558,6 +1558,17 @@ float its_volume(const indexed_triangle_set &its)
     return volume;
 }
 
+float its_area(const indexed_triangle_set &its)
+{
+    double area = 0.;
+    for (size_t i = 0; i < its.indices.size(); ++ i) {
+        its_triangle triangle = its_triangle_vertices(its, i);
+        area += 0.5 * double((triangle[1] - triangle[0]).cross(triangle[2] - triangle[0]).norm());
+    }
+
+    return float(area);
+}
+
 float its_average_edge_length(const indexed_triangle_set &its)
 {
     if (its.indices.empty())
@@ -302,6 +302,7 @@ inline stl_normal its_unnormalized_normal(const indexed_triangle_set &its,
 }
 
 float its_volume(const indexed_triangle_set &its);
+float its_area(const indexed_triangle_set &its);
 float its_average_edge_length(const indexed_triangle_set &its);
 
 /// <summary>
@@ -7,6 +7,8 @@
 
 #include <boost/container/small_vector.hpp>
 
+#include <tbb/parallel_for.h>
+
 #ifndef NDEBUG
 //    #define EXPENSIVE_DEBUG_CHECKS
 #endif // NDEBUG
@@ -236,7 +238,21 @@ int TriangleSelector::select_unsplit_triangle(const Vec3f &hit, int facet_idx) c
 
 void TriangleSelector::select_patch(int facet_start, std::unique_ptr<Cursor> &&cursor, EnforcerBlockerType new_state, const Transform3d& trafo_no_translate, bool triangle_splitting, float highlight_by_angle_deg)
 {
-    assert(facet_start < m_orig_size_indices);
+    this->select_patch(std::vector<int>{ facet_start }, std::move(cursor), new_state, trafo_no_translate, triangle_splitting, highlight_by_angle_deg);
+}
+
+void TriangleSelector::select_stroke(const std::vector<int> &facets_start, std::vector<std::unique_ptr<Cursor>> &&cursors, EnforcerBlockerType new_state, const Transform3d &trafo_no_translate, bool triangle_splitting, float highlight_by_angle_deg)
+{
+    assert(! cursors.empty());
+    if (cursors.size() == 1)
+        this->select_patch(facets_start, std::move(cursors.front()), new_state, trafo_no_translate, triangle_splitting, highlight_by_angle_deg);
+    else
+        this->select_patch(facets_start, std::make_unique<StrokeCursor>(std::move(cursors)), new_state, trafo_no_translate, triangle_splitting, highlight_by_angle_deg);
+}
+
+void TriangleSelector::select_patch(const std::vector<int> &facets_start, std::unique_ptr<Cursor> &&cursor, EnforcerBlockerType new_state, const Transform3d& trafo_no_translate, bool triangle_splitting, float highlight_by_angle_deg)
+{
+    assert(std::all_of(facets_start.begin(), facets_start.end(), [this](int facet_start) { return facet_start < m_orig_size_indices; }));
 
     // Save current cursor center, squared radius and camera direction, so we don't
     // have to pass it around.
@@ -253,10 +269,10 @@ void TriangleSelector::select_patch(int facet_start, std::unique_ptr<Cursor> &&c
     const float highlight_angle_limit = cos(Geometry::deg2rad(highlight_by_angle_deg));
     Vec3f       vec_down              = (trafo_no_translate.inverse() * -Vec3d::UnitZ()).normalized().cast<float>();
 
-    // Now start with the facet the pointer points to and check all adjacent facets.
+    // Now start with the facets the pointer points to and check all adjacent facets.
     std::vector<int> facets_to_check;
-    facets_to_check.reserve(16);
-    facets_to_check.emplace_back(facet_start);
+    facets_to_check.reserve(std::max<size_t>(16, facets_start.size()));
+    facets_to_check.insert(facets_to_check.end(), facets_start.begin(), facets_start.end());
     // Keep track of facets of the original mesh we already processed.
     std::vector<bool> visited(m_orig_size_indices, false);
     // Breadth-first search around the hit point. facets_to_check may grow significantly large.
@@ -1609,12 +1625,62 @@ void TriangleSelector::deserialize(const std::pair<std::vector<std::pair<int, in
     if (needs_reset)
         reset(); // dump any current state
 
-    // Reserve number of triangles as if each triangle was saved with 4 bits.
-    // With MMU painting this estimate may be somehow low, but better than nothing.
-    m_triangles.reserve(std::max(m_mesh.its.indices.size(), data.second.size() / 4));
-    // Number of triangles is twice the number of vertices on a large manifold mesh of genus zero.
-    // Here the triangles count account for both the nodes and leaves, thus the following line may overestimate.
-    m_vertices.reserve(std::max(m_mesh.its.vertices.size(), m_triangles.size() / 2));
+    // Decode the bit stream in parallel into a byte per triangle of the division trees:
+    // bits 0-1 = number of split sides, bits 2-7 = special side of a split triangle or state of a leaf triangle.
+    // The division trees are decoded in chunks of consecutive source triangles, each chunk into its own vector.
+    // The triangles are split serially afterwards, as splitting a triangle shares the new vertices with its neighbors.
+    const size_t                      num_trees  = data.first.size();
+    const size_t                      chunk_size = 4096;
+    std::vector<std::vector<uint8_t>> chunk_codes((num_trees + chunk_size - 1) / chunk_size);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, chunk_codes.size()), [&data, &chunk_codes, chunk_size, num_trees](const tbb::blocked_range<size_t> &range) {
+        for (size_t chunk_idx = range.begin(); chunk_idx < range.end(); ++ chunk_idx) {
+            const size_t          tree_begin = chunk_idx * chunk_size;
+            const size_t          tree_end   = std::min(num_trees, tree_begin + chunk_size);
+            std::vector<uint8_t> &codes      = chunk_codes[chunk_idx];
+            // Each triangle is encoded by at least 4 bits. The bit offsets of the trees are only expected to increase,
+            // don't rely on it, as the data may come from a 3MF file.
+            const int bit_begin = data.first[tree_begin].second;
+            const int bit_end   = std::min(tree_end < num_trees ? data.first[tree_end].second : int(data.second.size()), int(data.second.size()));
+            if (bit_begin < bit_end)
+                codes.reserve(size_t(bit_end - bit_begin) / 4);
+            for (size_t tree_idx = tree_begin; tree_idx < tree_end; ++ tree_idx) {
+                int ibit = data.first[tree_idx].second;
+                assert(ibit < int(data.second.size()));
+                auto next_nibble = [&data, &ibit]() {
+                    int n = 0;
+                    for (int i = 0; i < 4; ++ i)
+                        n |= data.second[ibit ++] << i;
+                    return n;
+                };
+                // Number of triangles of this division tree, which were not decoded yet.
+                int num_pending = 1;
+                do {
+                    int code               = next_nibble();
+                    int num_of_split_sides = code & 0b11;
+                    if (num_of_split_sides == 0) {
+                        // Value of the second nibble was subtracted by 3, so it is added back.
+                        codes.emplace_back(uint8_t(((code & 0b1100) == 0b1100 ? next_nibble() + 3 : code >> 2) << 2));
+                        -- num_pending;
+                    } else {
+                        codes.emplace_back(uint8_t(code));
+                        num_pending += num_of_split_sides;
+                    }
+                } while (num_pending > 0);
+            }
+        }
+    });
+
+    // Reserve the exact number of triangles and an upper bound of the number of vertices to be created by splitting.
+    size_t num_new_triangles = 0;
+    size_t num_new_vertices  = 0;
+    for (const std::vector<uint8_t> &codes : chunk_codes)
+        for (uint8_t code : codes)
+            if (int num_of_split_sides = code & 0b11; num_of_split_sides > 0) {
+                num_new_triangles += num_of_split_sides + 1;
+                num_new_vertices  += num_of_split_sides;
+            }
+    m_triangles.reserve(std::max(m_triangles.size(), m_mesh.its.indices.size()) + num_new_triangles);
+    m_vertices.reserve(std::max(m_vertices.size(), m_mesh.its.vertices.size()) + num_new_vertices);
 
     // Vector to store all parents that have offsprings.
     struct ProcessingInfo {
@@ -1627,81 +1693,80 @@ void TriangleSelector::deserialize(const std::pair<std::vector<std::pair<int, in
     // kept outside of the loop to avoid re-allocating inside the loop.
     std::vector<ProcessingInfo> parents;
 
-    for (auto [triangle_id, ibit] : data.first) {
-        assert(triangle_id < int(m_triangles.size()));
-        assert(ibit < int(data.second.size()));
-        auto next_nibble = [&data, &ibit = ibit]() {
-            int n = 0;
-            for (int i = 0; i < 4; ++ i)
-                n |= data.second[ibit ++] << i;
-            return n;
-        };
+    for (size_t chunk_idx = 0; chunk_idx < chunk_codes.size(); ++ chunk_idx) {
+        const uint8_t *next_code = chunk_codes[chunk_idx].data();
+        const size_t   tree_end  = std::min(num_trees, (chunk_idx + 1) * chunk_size);
+        for (size_t tree_idx = chunk_idx * chunk_size; tree_idx < tree_end; ++ tree_idx) {
+            const int triangle_id = data.first[tree_idx].first;
+            assert(triangle_id < int(m_triangles.size()));
+
+            parents.clear();
+            while (true) {
+                // Read next triangle info.
+                int code = *next_code ++;
+                int num_of_split_sides = code & 0b11;
+                int num_of_children = num_of_split_sides == 0 ? 0 : num_of_split_sides + 1;
+                bool is_split = num_of_children != 0;
+                // Only valid if not is_split.
+                auto state = is_split ? EnforcerBlockerType::NONE : EnforcerBlockerType(code >> 2);
+                // Only valid if is_split.
+                int special_side = code >> 2;
+
+                // Take care of the first iteration separately, so handling of the others is simpler.
+                if (parents.empty()) {
+                    if (is_split) {
+                        // root is split, add it into list of parents and split it.
+                        // then go to the next.
+                        Vec3i neighbors = m_neighbors[triangle_id];
+                        parents.push_back({triangle_id, neighbors, 0, num_of_children});
+                        m_triangles[triangle_id].set_division(num_of_split_sides, special_side);
+                        perform_split(triangle_id, neighbors, EnforcerBlockerType::NONE);
+                        continue;
+                    } else {
+                        // root is not split. just set the state and that's it.
+                        m_triangles[triangle_id].set_state(state);
+                        break;
+                    }
+                }
 
-        parents.clear();
-        while (true) {
-            // Read next triangle info.
-            int code = next_nibble();
-            int num_of_split_sides = code & 0b11;
-            int num_of_children = num_of_split_sides == 0 ? 0 : num_of_split_sides + 1;
-            bool is_split = num_of_children != 0;
-            // Only valid if not is_split. Value of the second nibble was subtracted by 3, so it is added back.
-            auto state = is_split ? EnforcerBlockerType::NONE : EnforcerBlockerType((code & 0b1100) == 0b1100 ? next_nibble() + 3 : code >> 2);
-            // Only valid if is_split.
-            int special_side = code >> 2;
-
-            // Take care of the first iteration separately, so handling of the others is simpler.
-            if (parents.empty()) {
-                if (is_split) {
-                    // root is split, add it into list of parents and split it.
-                    // then go to the next.
-                    Vec3i neighbors = m_neighbors[triangle_id];
-                    parents.push_back({triangle_id, neighbors, 0, num_of_children});
-                    m_triangles[triangle_id].set_division(num_of_split_sides, special_side);
-                    perform_split(triangle_id, neighbors, EnforcerBlockerType::NONE);
-                    continue;
+                // This is not the first iteration. This triangle is a child of last seen parent.
+                assert(! parents.empty());
+                assert(parents.back().processed_children < parents.back().total_children);
+
+                if (ProcessingInfo& last = parents.back();  is_split) {
+                    // split the triangle and save it as parent of the next ones.
+                    const Triangle &tr = m_triangles[last.facet_id];
+                    int   child_idx = last.total_children - last.processed_children - 1;
+                    Vec3i neighbors = this->child_neighbors(tr, last.neighbors, child_idx);
+                    int this_idx = tr.children[child_idx];
+                    m_triangles[this_idx].set_division(num_of_split_sides, special_side);
+                    perform_split(this_idx, neighbors, EnforcerBlockerType::NONE);
+                    parents.push_back({this_idx, neighbors, 0, num_of_children});
                 } else {
-                    // root is not split. just set the state and that's it.
-                    m_triangles[triangle_id].set_state(state);
-                    break;
+                    // this triangle belongs to last split one
+                    int child_idx = last.total_children - last.processed_children - 1;
+                    m_triangles[m_triangles[last.facet_id].children[child_idx]].set_state(state);
+                    ++last.processed_children;
                 }
-            }
 
-            // This is not the first iteration. This triangle is a child of last seen parent.
-            assert(! parents.empty());
-            assert(parents.back().processed_children < parents.back().total_children);
-
-            if (ProcessingInfo& last = parents.back();  is_split) {
-                // split the triangle and save it as parent of the next ones.
-                const Triangle &tr = m_triangles[last.facet_id];
-                int   child_idx = last.total_children - last.processed_children - 1;
-                Vec3i neighbors = this->child_neighbors(tr, last.neighbors, child_idx);
-                int this_idx = tr.children[child_idx];
-                m_triangles[this_idx].set_division(num_of_split_sides, special_side);
-                perform_split(this_idx, neighbors, EnforcerBlockerType::NONE);
-                parents.push_back({this_idx, neighbors, 0, num_of_children});
-            } else {
-                // this triangle belongs to last split one
-                int child_idx = last.total_children - last.processed_children - 1;
-                m_triangles[m_triangles[last.facet_id].children[child_idx]].set_state(state);
-                ++last.processed_children;
-            }
+                // If all children of the past parent triangle are claimed, move to grandparent.
+                while (parents.back().processed_children == parents.back().total_children) {
+                    parents.pop_back();
+
+                    if (parents.empty())
+                        break;
 
-            // If all children of the past parent triangle are claimed, move to grandparent.
-            while (parents.back().processed_children == parents.back().total_children) {
-                parents.pop_back();
+                    // And increment the grandparent children counter, because
+                    // we have just finished that branch and got back here.
+                    ++parents.back().processed_children;
+                }
 
+                // In case we popped back the root, we should be done.
                 if (parents.empty())
                     break;
-
-                // And increment the grandparent children counter, because
-                // we have just finished that branch and got back here.
-                ++parents.back().processed_children;
             }
-
-            // In case we popped back the root, we should be done.
-            if (parents.empty())
-                break;
         }
+        assert(next_code == chunk_codes[chunk_idx].data() + chunk_codes[chunk_idx].size());
     }
 }
 
@@ -1822,6 +1887,32 @@ TriangleSelector::DoublePointCursor::DoublePointCursor(const Vec3f &first_center
     dir = (first_center - source).normalized();
 }
 
+TriangleSelector::StrokeCursor::StrokeCursor(std::vector<std::unique_ptr<Cursor>> &&cursors_)
+    : Cursor(*cursors_.front()), cursors(std::move(cursors_))
+{
+    assert(std::all_of(cursors.begin(), cursors.end(), [this](const std::unique_ptr<Cursor> &cursor) { return cursor->radius_sqr == this->radius_sqr; }));
+}
+
+bool TriangleSelector::StrokeCursor::is_mesh_point_inside(const Vec3f &point) const
+{
+    return std::any_of(cursors.begin(), cursors.end(), [&point](const std::unique_ptr<Cursor> &cursor) { return cursor->is_mesh_point_inside(point); });
+}
+
+bool TriangleSelector::StrokeCursor::is_pointer_in_triangle(const Vec3f &p1, const Vec3f &p2, const Vec3f &p3) const
+{
+    return std::any_of(cursors.begin(), cursors.end(), [&p1, &p2, &p3](const std::unique_ptr<Cursor> &cursor) { return cursor->is_pointer_in_triangle(p1, p2, p3); });
+}
+
+bool TriangleSelector::StrokeCursor::is_edge_inside_cursor(const Triangle &tr, const std::vector<Vertex> &vertices) const
+{
+    return std::any_of(cursors.begin(), cursors.end(), [&tr, &vertices](const std::unique_ptr<Cursor> &cursor) { return cursor->is_edge_inside_cursor(tr, vertices); });
+}
+
+bool TriangleSelector::StrokeCursor::is_facet_visible(int facet_idx, const std::vector<Vec3f> &face_normals) const
+{
+    return std::any_of(cursors.begin(), cursors.end(), [facet_idx, &face_normals](const std::unique_ptr<Cursor> &cursor) { return cursor->is_facet_visible(facet_idx, face_normals); });
+}
+
 // Returns true if clipping plane is not active or if the point not clipped by clipping plane.
 inline static bool is_mesh_point_not_clipped(const Vec3f &point, const TriangleSelector::ClippingPlane &clipping_plane)
 {
@@ -184,6 +184,24 @@ public:
         }
     };
 
+    // Union of cursors, used to paint a whole brush stroke by a single call of select_patch().
+    // Takes the camera direction, radius and transformation from the first cursor.
+    class StrokeCursor : public Cursor
+    {
+    public:
+        StrokeCursor() = delete;
+        explicit StrokeCursor(std::vector<std::unique_ptr<Cursor>> &&cursors_);
+        ~StrokeCursor() override = default;
+
+        bool is_mesh_point_inside(const Vec3f &point) const override;
+        bool is_pointer_in_triangle(const Vec3f &p1, const Vec3f &p2, const Vec3f &p3) const override;
+        bool is_edge_inside_cursor(const Triangle &tr, const std::vector<Vertex> &vertices) const override;
+        bool is_facet_visible(int facet_idx, const std::vector<Vec3f> &face_normals) const override;
+
+    private:
+        std::vector<std::unique_ptr<Cursor>> cursors;
+    };
+
     std::pair<std::vector<Vec3i>, std::vector<Vec3i>> precompute_all_neighbors() const;
     void precompute_all_neighbors_recursive(int facet_idx, const Vec3i &neighbors, const Vec3i &neighbors_propagated, std::vector<Vec3i> &neighbors_out, std::vector<Vec3i> &neighbors_normal_out) const;
 
@@ -207,6 +225,15 @@ public:
                       bool                      triangle_splitting,            // If triangles will be split base on the cursor or not
                       float                     highlight_by_angle_deg = 0.f); // The maximal angle of overhang. If it is set to a non-zero value, it is possible to paint only the triangles of overhang defined by this angle in degrees.
 
+    // Select all triangles inside a brush stroke formed by a sequence of cursors, subdivide where needed.
+    // Each triangle of the original mesh is visited at most once for the whole stroke, instead of once per cursor.
+    void select_stroke(const std::vector<int>              &facets_start,        // facets of the original mesh (unsplit) that the stroke points belong to
+                       std::vector<std::unique_ptr<Cursor>> &&cursors,            // Cursors covering the stroke, for example capsules between the consecutive stroke points.
+                       EnforcerBlockerType                   new_state,           // enforcer or blocker?
+                       const Transform3d                    &trafo_no_translate,  // matrix to get from mesh to world without translation
+                       bool                                  triangle_splitting,  // If triangles will be split base on the cursor or not
+                       float                                 highlight_by_angle_deg = 0.f);
+
     void seed_fill_select_triangles(const Vec3f        &hit,                          // point where to start
                                     int                 facet_start,                  // facet of the original mesh (unsplit) that the hit point belongs to
                                     const Transform3d  &trafo_no_translate,           // matrix to get from mesh to world without translation
@@ -345,6 +372,7 @@ protected:
 
     // Private functions:
 private:
+    void select_patch(const std::vector<int> &facets_start, std::unique_ptr<Cursor> &&cursor, EnforcerBlockerType new_state, const Transform3d &trafo_no_translate, bool triangle_splitting, float highlight_by_angle_deg);
     bool select_triangle(int facet_idx, EnforcerBlockerType type, bool triangle_splitting);
     bool select_triangle_recursive(int facet_idx, const Vec3i &neighbors, EnforcerBlockerType type, bool triangle_splitting);
     void undivide_triangle(int facet_idx);
@@ -570,11 +570,18 @@ bool GLGizmoPainterBase::gizmo_event(SLAGizmoEventType action, const Vec2d& mous
                     m_triangle_selectors[mesh_idx]->select_patch(int(first_position.facet_idx), std::move(cursor), new_state, trafo_matrix_not_translate,
                                                                  m_triangle_splitting_enabled, m_paint_on_overhangs_only ? m_highlight_by_angle_threshold_deg : 0.f);
                 } else {
+                    // Paint the whole stroke at once, so that each triangle is visited and split just once.
+                    std::vector<int>                                       facets_start;
+                    std::vector<std::unique_ptr<TriangleSelector::Cursor>> cursors;
+                    facets_start.reserve(projected_mouse_positions.size());
+                    cursors.reserve(projected_mouse_positions.size() - 1);
                     for (auto first_position_it = projected_mouse_positions.cbegin(); first_position_it != projected_mouse_positions.cend() - 1; ++first_position_it) {
                         auto second_position_it = first_position_it + 1;
-                        std::unique_ptr<TriangleSelector::Cursor> cursor = TriangleSelector::DoublePointCursor::cursor_factory(first_position_it->mesh_hit, second_position_it->mesh_hit, camera_pos, m_cursor_radius, m_cursor_type, trafo_matrix, clp);
-                        m_triangle_selectors[mesh_idx]->select_patch(int(first_position_it->facet_idx), std::move(cursor), new_state, trafo_matrix_not_translate, m_triangle_splitting_enabled, m_paint_on_overhangs_only ? m_highlight_by_angle_threshold_deg : 0.f);
+                        facets_start.emplace_back(int(first_position_it->facet_idx));
+                        cursors.emplace_back(TriangleSelector::DoublePointCursor::cursor_factory(first_position_it->mesh_hit, second_position_it->mesh_hit, camera_pos, m_cursor_radius, m_cursor_type, trafo_matrix, clp));
                     }
+                    facets_start.emplace_back(int(projected_mouse_positions.back().facet_idx));
+                    m_triangle_selectors[mesh_idx]->select_stroke(facets_start, std::move(cursors), new_state, trafo_matrix_not_translate, m_triangle_splitting_enabled, m_paint_on_overhangs_only ? m_highlight_by_angle_threshold_deg : 0.f);
                 }
             }
 
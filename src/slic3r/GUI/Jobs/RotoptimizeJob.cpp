@@ -53,7 +53,6 @@ void RotoptimizeJob::prepare()
 
 void RotoptimizeJob::process(Ctl &ctl)
 {
-    int prev_status = 0;
     auto statustxt = _u8L("Searching for optimal orientation");
     ctl.update_status(0, statustxt);
 
@@ -61,26 +60,26 @@ void RotoptimizeJob::process(Ctl &ctl)
         sla::RotOptimizeParams{}
             .accuracy(m_accuracy)
             .print_config(&m_default_print_cfg)
-            .statucb([this, &prev_status, &ctl, &statustxt](int s)
+            .statucb([&ctl, &statustxt](int s)
         {
             if (s > 0 && s < 100)
-                ctl.update_status(prev_status + s / m_selected_object_ids.size(),
-                                  statustxt);
+                ctl.update_status(s, statustxt);
 
             return !ctl.was_canceled();
         });
 
+    std::vector<const ModelObject *> objects;
+    objects.reserve(m_selected_object_ids.size());
+    for (const ObjRot &objrot : m_selected_object_ids)
+        objects.emplace_back(m_plater->model().objects[size_t(objrot.idx)]);
 
-    for (ObjRot &objrot : m_selected_object_ids) {
-        ModelObject *o = m_plater->model().objects[size_t(objrot.idx)];
-        if (!o) continue;
-
-        if (Methods[m_method_id].findfn)
-            objrot.rot = Methods[m_method_id].findfn(*o, params);
-
-        prev_status += 100 / m_selected_object_ids.size();
+    if (Methods[m_method_id].findfn) {
+        std::vector<Vec2d> rotations =
+            sla::find_rotations(objects, Methods[m_method_id].findfn, params);
 
-        if (ctl.was_canceled()) break;
+        for (size_t i = 0; i < objects.size(); ++i)
+            if (objects[i])
+                m_selected_object_ids[i].rot = rotations[i];
     }
 
     ctl.update_status(100, ctl.was_canceled() ?
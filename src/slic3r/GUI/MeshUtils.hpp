@@ -164,7 +164,9 @@ class MeshRaycaster {
 public:
     explicit MeshRaycaster(std::shared_ptr<const TriangleMesh> mesh)
         : m_mesh(std::move(mesh))
-        , m_emesh(*m_mesh, true) // calculate epsilon for triangle-ray intersection from an average edge length
+        // calculate epsilon for triangle-ray intersection from an average edge length,
+        // the index is shared with other raycasters of the same mesh
+        , m_emesh(std::shared_ptr<const indexed_triangle_set>(m_mesh, &m_mesh->its), true)
         , m_normals(its_face_normals(m_mesh->its))
     {
         assert(m_mesh);
@@ -262,7 +262,9 @@ void actualize(RaycastManager::Meshes &meshes, const ModelVolumePtrs &volumes, c
 
         // add new raycaster
         bool calculate_epsilon = true;
-        auto mesh = std::make_unique<AABBMesh>(volume->mesh(), calculate_epsilon);
+        std::shared_ptr<const TriangleMesh> volume_mesh = volume->mesh_ptr();
+        auto mesh = std::make_unique<AABBMesh>(
+            std::shared_ptr<const indexed_triangle_set>(volume_mesh, &volume_mesh->its), calculate_epsilon);
         meshes.emplace_back(std::make_pair(oid, std::move(mesh)));
         need_sort = true;        
     }
@@ -14,6 +14,7 @@
 #include <libslic3r/Arrange/Core/NFP/NFPConcave_CGAL.hpp>
 #include <libslic3r/Arrange/Core/NFP/NFPConcave_Tesselate.hpp>
 #include <libslic3r/Arrange/Core/NFP/CircularEdgeIterator.hpp>
+#include <libslic3r/Arrange/Core/NFP/NFPCache.hpp>
 
 #include <libslic3r/Arrange/Items/SimpleArrangeItem.hpp>
 #include <libslic3r/Arrange/Items/ArrangeItem.hpp>
@@ -463,6 +464,76 @@ TEST_CASE("NFP should be empty if item cannot fit into bed", "[arrange2]") {
     }
 }
 
+TEST_CASE("Cached NFPs of translated convex pairs match the computed ones", "[arrange2]") {
+    using namespace Slic3r;
+
+    NFPCache cache;
+
+    auto parts = prusa_parts();
+    parts.resize(std::min(parts.size(), size_t(20)));
+
+    // The cache keys: both polygons relative to their first vertex. Parts
+    // sharing their hulls share the keys as well.
+    std::vector<std::pair<Points, Points>> keys;
+    auto add_key = [&keys](const Polygon &fixed, const Polygon &movable) {
+        std::pair<Points, Points> key{fixed.points, movable.points};
+        for (Points *pts : {&key.first, &key.second})
+            if (! pts->empty()) {
+                const Point origin = pts->front();
+                for (Point &p : *pts)
+                    p -= origin;
+            }
+        if (std::find(keys.begin(), keys.end(), key) == keys.end())
+            keys.emplace_back(std::move(key));
+    };
+
+    size_t lookups = 0;
+    foreach_combo(range(parts), [&cache, &lookups, &add_key](auto &i1, auto &i2) {
+        Polygon fixed   = arr2::fixed_convex_hull(i1);
+        Polygon movable = arr2::envelope_convex_hull(i2);
+        add_key(fixed, movable);
+
+        REQUIRE(cache.nfp_convex_convex(fixed, movable) ==
+                nfp_convex_convex_legacy(fixed, movable));
+
+        fixed.translate(random_value<coord_t>(-scaled(100.), scaled(100.)),
+                        random_value<coord_t>(-scaled(100.), scaled(100.)));
+        movable.translate(random_value<coord_t>(-scaled(100.), scaled(100.)),
+                          random_value<coord_t>(-scaled(100.), scaled(100.)));
+
+        REQUIRE(cache.nfp_convex_convex(fixed, movable) ==
+                nfp_convex_convex_legacy(fixed, movable));
+
+        lookups += 2;
+    });
+
+    // Each key is computed once, all the other lookups are hits.
+    NFPCache::Stats stats = cache.stats();
+    REQUIRE(stats.hits + stats.misses == lookups);
+    REQUIRE(stats.misses == keys.size());
+
+    SECTION("A rotated polygon is a different key") {
+        Polygon fixed   = arr2::fixed_convex_hull(parts[0]);
+        Polygon movable = arr2::envelope_convex_hull(parts[1]);
+        movable.rotate(PI / 3.);
+
+        REQUIRE(cache.nfp_convex_convex(fixed, movable) ==
+                nfp_convex_convex_legacy(fixed, movable));
+        REQUIRE(cache.stats().misses == keys.size() + 1);
+    }
+
+    SECTION("Clearing when the limit is reached") {
+        cache.set_max_points(1);
+        cache.reset_stats();
+
+        Polygon fixed   = arr2::fixed_convex_hull(parts[0]);
+        Polygon movable = arr2::envelope_convex_hull(parts[1]);
+        cache.nfp_convex_convex(fixed, movable);
+
+        REQUIRE(cache.stats().misses == 1);
+    }
+}
+
 #include <boost/filesystem/path.hpp>
 #include <boost/filesystem.hpp>
 
@@ -614,6 +685,26 @@ TEST_CASE("EdgeCache tests", "[arrange2]") {
         REQUIRE(samples.size() == 1);
         REQUIRE(ep0.coords(samples[0]) == poly.contour.points[1]);
     }
+
+    SECTION("Bounding box of a part of the circumference") {
+        ExPolygon poly{arr2::to_rectangle(scaled(BoundingBoxf{{0., 0.}, {10., 10.}}))};
+
+        arr2::EdgeCache ep{&poly};
+
+        // Around the second corner of the rectangle
+        BoundingBox bb = ep.bounding_box({0, 0.125}, 0.375);
+        REQUIRE(bb.min == scaled(Vec2d{5., 0.}));
+        REQUIRE(bb.max == scaled(Vec2d{10., 5.}));
+
+        // Wrapping around the first corner
+        bb = ep.bounding_box({0, 0.875}, 0.125);
+        REQUIRE(bb.min == scaled(Vec2d{0., 0.}));
+        REQUIRE(bb.max == scaled(Vec2d{5., 5.}));
+
+        bb = ep.bounding_box({0, 0.}, 1.);
+        REQUIRE(bb.min == poly.contour.bounding_box().min);
+        REQUIRE(bb.max == poly.contour.bounding_box().max);
+    }
 }
 
 // Mock packing strategy that places N items to the center of the
@@ -1066,6 +1157,88 @@ TEMPLATE_TEST_CASE("Test if allowed item rotations are considered", "[arrange2]"
     REQUIRE(get_rotation(itm) == Approx(PI));
 }
 
+TEST_CASE("Batch fitness and fitness bounds of GravityKernel", "[arrange2]")
+{
+    using namespace Slic3r;
+
+    arr2::GravityKernel k{scaled(Vec2d{20., -30.})};
+    arr2::ArrangeItem   itm{arr2::DecomposedShape{arr2::to_rectangle(
+        BoundingBox{{0, 0}, scaled(Vec2d{15., 10.})})}};
+
+    std::vector<Vec2crd> transl;
+    for (double x = -50.; x <= 50.; x += 12.5)
+        for (double y = -50.; y <= 50.; y += 12.5)
+            transl.emplace_back(scaled(Vec2d{x, y}));
+
+    using KernelT = arr2::KernelTraits<arr2::GravityKernel>;
+
+    std::vector<double> fitness;
+    KernelT::placement_fitness_batch(k, itm, transl, fitness);
+
+    REQUIRE(fitness.size() == transl.size());
+    for (size_t i = 0; i < transl.size(); ++i)
+        REQUIRE(fitness[i] == KernelT::placement_fitness(k, itm, transl[i]));
+
+    BoundingBox bounds{scaled(Vec2d{25., -50.}), scaled(Vec2d{50., 0.})};
+    double bound = KernelT::fitness_upper_bound(k, itm, bounds);
+    for (size_t i = 0; i < transl.size(); ++i)
+        if (bounds.contains(transl[i]))
+            REQUIRE(fitness[i] <= bound);
+
+    // Kernels without a bound are never pruned
+    REQUIRE(std::isinf(arr2::KernelTraits<arr2::DummyArrangeKernel>::fitness_upper_bound(
+        arr2::DummyArrangeKernel{}, itm, bounds)));
+}
+
+TEST_CASE("Pruned nfp corner search finds the same spot as the full search", "[arrange2]")
+{
+    using namespace Slic3r;
+
+    // GravityKernel counting the evaluations of the fitness, without a bound
+    struct CountingKernel {
+        arr2::GravityKernel k;
+        size_t *count;
+
+        double placement_fitness(const arr2::ArrangeItem &itm, const Vec2crd &tr) const
+        {
+            ++(*count);
+            return k.placement_fitness(itm, tr);
+        }
+    };
+
+    // The same with the bound of GravityKernel
+    struct BoundedCountingKernel : public CountingKernel {
+        double fitness_upper_bound(const arr2::ArrangeItem &itm, const BoundingBox &bounds) const
+        {
+            return k.fitness_upper_bound(itm, bounds);
+        }
+    };
+
+    // Separate contours, only the one closest to the sink can hold the best spot.
+    ExPolygons nfp;
+    for (int i = 0; i < 8; ++i) {
+        nfp.emplace_back(make_circle_num_segments(scaled(30.), 200));
+        nfp.back().translate(scaled(100. * i), 0.);
+    }
+    Vec2crd sink = scaled(Vec2d{-10., 50.});
+
+    size_t count_full = 0, count_pruned = 0;
+    arr2::PackStrategyNFP full{CountingKernel{arr2::GravityKernel{sink}, &count_full}};
+    arr2::PackStrategyNFP pruned{BoundedCountingKernel{{arr2::GravityKernel{sink}, &count_pruned}}};
+
+    auto shape = arr2::to_rectangle(BoundingBox{{0, 0}, scaled(Vec2d{10., 10.})});
+    arr2::ArrangeItem itm_full{arr2::DecomposedShape{shape}};
+    arr2::ArrangeItem itm_pruned{arr2::DecomposedShape{shape}};
+
+    double score_full   = pick_best_spot_on_nfp(itm_full, nfp, arr2::InfiniteBed{}, full);
+    double score_pruned = pick_best_spot_on_nfp(itm_pruned, nfp, arr2::InfiniteBed{}, pruned);
+
+    // Only the optimizers which cannot beat the best corner are skipped.
+    REQUIRE(score_pruned == score_full);
+    REQUIRE(get_translation(itm_pruned) == get_translation(itm_full));
+    REQUIRE(count_pruned < count_full / 4);
+}
+
 //TEST_CASE("NFP optimizing test", "[arrange2]") {
 //    using namespace Slic3r;
 
@@ -4,6 +4,7 @@
 #include <libslic3r/Arrange/Arrange.hpp>
 #include <libslic3r/Arrange/Items/ArrangeItem.hpp>
 #include <libslic3r/Arrange/Tasks/ArrangeTask.hpp>
+#include <libslic3r/Arrange/Core/NFP/NFPCache.hpp>
 
 #include <libslic3r/Arrange/SceneBuilder.hpp>
 
@@ -12,6 +13,9 @@
 #include "libslic3r/Format/3mf.hpp"
 #include "libslic3r/ModelArrange.hpp"
 
+#include <chrono>
+#include <iostream>
+
 static Slic3r::Model get_example_model_with_20mm_cube()
 {
     using namespace Slic3r;
@@ -680,6 +684,93 @@ TEMPLATE_TEST_CASE("Bed needs to be completely filled with 1cm cubes",
         }));
 }
 
+static size_t fill_bed_with_10mm_boxes(size_t bed_size_mm)
+{
+    using namespace Slic3r;
+
+    Model m;
+
+    ModelObject* new_object = m.add_object();
+    new_object->name = "10mm_box";
+    new_object->add_instance();
+    TriangleMesh mesh = make_cube(10., 10., 10.);
+    ModelVolume* new_volume = new_object->add_volume(mesh);
+    new_volume->name = new_object->name;
+
+    arr2::ArrangeSettings settings;
+    settings.values().d_obj = 0.;
+    settings.values().d_bed = 0.;
+
+    arr2::FixedSelection sel({{true}});
+
+    arr2::Scene scene{arr2::SceneBuilder{}
+                          .set_model(m)
+                          .set_arrange_settings(settings)
+                          .set_selection(&sel)
+                          .set_bed(arr2::RectangleBed{scaled(double(bed_size_mm)),
+                                                      scaled(double(bed_size_mm))})};
+
+    auto task = arr2::FillBedTask<arr2::ArrangeItem>::create(scene);
+    auto result = task->process_native(arr2::DummyCtl{});
+    result->apply_on(scene.model());
+
+    return m.objects.front()->instances.size();
+}
+
+TEST_CASE("Repeated bed filling reuses the cached NFPs", "[arrange2][integration][bedfilling]")
+{
+    using namespace Slic3r;
+
+    NFPCache &cache = NFPCache::instance();
+    cache.clear();
+    cache.reset_stats();
+
+    size_t count = fill_bed_with_10mm_boxes(50);
+    NFPCache::Stats first = cache.stats();
+
+    REQUIRE(count == 25);
+    REQUIRE(first.misses > 0);
+
+    cache.reset_stats();
+    REQUIRE(fill_bed_with_10mm_boxes(50) == count);
+    NFPCache::Stats second = cache.stats();
+
+    // The second run arranges the same shapes again, nothing new to compute.
+    REQUIRE(second.misses == 0);
+    REQUIRE(second.hits > 0);
+
+    cache.set_enabled(false);
+    REQUIRE(fill_bed_with_10mm_boxes(50) == count);
+    cache.set_enabled(true);
+}
+
+TEST_CASE("Repeated bed filling time Benchmark", "[arrange2][integration][bedfilling][.]")
+{
+    using namespace Slic3r;
+
+    NFPCache &cache = NFPCache::instance();
+
+    for (bool enabled : {false, true}) {
+        cache.clear();
+        cache.set_enabled(enabled);
+
+        for (int run = 0; run < 3; ++run) {
+            cache.reset_stats();
+            auto   t0    = std::chrono::steady_clock::now();
+            size_t count = fill_bed_with_10mm_boxes(150);
+            auto   t1    = std::chrono::steady_clock::now();
+
+            NFPCache::Stats stats = cache.stats();
+            std::cout << "NFP cache " << (enabled ? "on " : "off") << ", run " << run << ": " << count
+                      << " items in " << std::chrono::duration<double>(t1 - t0).count() << " s, hit rate "
+                      << stats.hit_rate() << " (" << stats.hits << " hits, " << stats.misses << " misses)"
+                      << std::endl;
+        }
+    }
+
+    cache.set_enabled(true);
+}
+
 template<class It, class Fn>
 static void foreach_combo(const Slic3r::Range<It> &range, const Fn &fn)
 {
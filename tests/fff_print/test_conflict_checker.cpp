@@ -0,0 +1,97 @@
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+
+#include "libslic3r/GCode/ConflictChecker.hpp"
+
+using namespace Slic3r;
+
+// Extrusion lines of a single layer of a crowded plate: square objects placed on a grid, each with a perimeter and a dense zig-zag infill.
+static LineWithIDs crowded_plate_lines(int num_objects, double pitch, double size, double spacing)
+{
+    LineWithIDs lines;
+    const int columns = 8;
+    for (int obj_id = 0; obj_id < num_objects; ++ obj_id) {
+        const Vec2d origin(pitch * (obj_id % columns), pitch * (obj_id / columns));
+        Polyline perimeter { Point::new_scale(origin), Point::new_scale(origin + Vec2d(size, 0.)), Point::new_scale(origin + Vec2d(size, size)),
+                             Point::new_scale(origin + Vec2d(0., size)), Point::new_scale(origin) };
+        for (const Line &l : perimeter.lines())
+            lines.emplace_back(l, obj_id, 0, ExtrusionRole::ExternalPerimeter);
+        Polyline infill;
+        for (double y = spacing; y < size - spacing; y += spacing) {
+            const bool odd = (infill.size() / 2) % 2 == 1;
+            infill.points.emplace_back(Point::new_scale(origin + Vec2d(odd ? size - spacing : spacing, y)));
+            infill.points.emplace_back(Point::new_scale(origin + Vec2d(odd ? spacing : size - spacing, y)));
+        }
+        for (const Line &l : infill.lines())
+            lines.emplace_back(l, obj_id, 0, ExtrusionRole::SolidInfill);
+    }
+    return lines;
+}
+
+// Brute force reference: all pairs of intersecting lines of different objects.
+static std::vector<std::pair<int, int>> conflicting_objects(const LineWithIDs &lines)
+{
+    std::vector<std::pair<int, int>> out;
+    for (size_t i = 0; i < lines.size(); ++ i)
+        for (size_t j = 0; j < i; ++ j)
+            if (ConflictComputeOpt res = ConflictChecker::line_intersect(lines[i], lines[j]); res)
+                out.emplace_back(std::min(res->_obj1, res->_obj2), std::max(res->_obj1, res->_obj2));
+    sort_remove_duplicates(out);
+    return out;
+}
+
+TEST_CASE("Conflict checker ignores lines of the same object", "[ConflictChecker]")
+{
+    LineWithIDs lines;
+    lines.emplace_back(Line(Point::new_scale(0., 0.), Point::new_scale(10., 10.)), 0, 0, ExtrusionRole::Perimeter);
+    lines.emplace_back(Line(Point::new_scale(0., 10.), Point::new_scale(10., 0.)), 0, 0, ExtrusionRole::Perimeter);
+    REQUIRE(! ConflictChecker::find_inter_of_lines(lines).has_value());
+
+    SECTION("but reports crossing lines of another instance") {
+        lines.back()._inst_id = 1;
+        ConflictComputeOpt res = ConflictChecker::find_inter_of_lines(lines);
+        REQUIRE(res.has_value());
+        REQUIRE(res->_obj1 == 0);
+        REQUIRE(res->_obj2 == 0);
+    }
+}
+
+TEST_CASE("Conflict checker on a crowded plate", "[ConflictChecker]")
+{
+    SECTION("40 objects not touching each other") {
+        LineWithIDs lines = crowded_plate_lines(40, 22., 20., 0.5);
+        REQUIRE(! ConflictChecker::find_inter_of_lines(lines).has_value());
+    }
+    SECTION("40 objects, two of them overlapping") {
+        LineWithIDs lines = crowded_plate_lines(40, 22., 20., 0.5);
+        // Shift object 17 over its right neighbour.
+        for (LineWithID &l : lines)
+            if (l._obj_id == 17)
+                l._line.translate(Point::new_scale(3., 0.5));
+        std::vector<std::pair<int, int>> reference = conflicting_objects(lines);
+        REQUIRE(reference == std::vector<std::pair<int, int>>{ { 17, 18 } });
+        ConflictComputeOpt res = ConflictChecker::find_inter_of_lines(lines);
+        REQUIRE(res.has_value());
+        REQUIRE(std::min(res->_obj1, res->_obj2) == 17);
+        REQUIRE(std::max(res->_obj1, res->_obj2) == 18);
+    }
+}
+
+#if 0
+#include <iostream>
+#include "libnest2d/tools/benchmark.h"
+TEST_CASE("Conflict checker crowded plate time Benchmark", "[ConflictChecker]")
+{
+    // 40 objects with infill at 0.2mm spacing, 200 layers.
+    LineWithIDs lines = crowded_plate_lines(40, 22., 20., 0.2);
+    Benchmark bench;
+    bench.start();
+    size_t num_conflicts = 0;
+    for (int layer = 0; layer < 200; ++ layer)
+        num_conflicts += ConflictChecker::find_inter_of_lines(lines).has_value();
+    bench.stop();
+    std::cout << "Checking 200 layers of " << lines.size() << " lines took " << bench.getElapsedSec() << " seconds." << std::endl;
+    REQUIRE(num_conflicts == 0);
+}
+#endif
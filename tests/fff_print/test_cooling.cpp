@@ -100,6 +100,30 @@ SCENARIO("Cooling unit tests", "[Cooling]") {
         }
     }
 
+    WHEN("G-code block 4 with comments") {
+        const std::string gcode_src =
+            "G1 X50 F2500 ; travel\n"
+            "G1 F3000;_EXTRUDE_SET_SPEED ; infill\n"
+            "G1 X100 E1\n"
+            ";_EXTRUDE_END\n"
+            "G1 E4 F400";
+        const double print_time = 50. / (2500. / 60.) + 100. / (3000. / 60.) + 4. / (400. / 60.);
+        config.set_deserialize_strict({ { "slowdown_below_layer_time", { int(print_time * 1.001) } } });
+        GCodeGenerator gcodegen;
+        auto buffer = make_cooling_buffer(gcodegen, config);
+        std::string gcode = buffer->process_layer(gcode_src, 0, true);
+        THEN("speed is altered") {
+            REQUIRE(gcode.find("F3000") == gcode.npos);
+        }
+        THEN("cooling markers are removed from the comments") {
+            REQUIRE(gcode.find(";_EXTRUDE_SET_SPEED") == gcode.npos);
+        }
+        THEN("user comments are preserved") {
+            REQUIRE(gcode.find("; infill\n") != gcode.npos);
+            REQUIRE(gcode.find("; travel\n") != gcode.npos);
+        }
+    }
+
     WHEN("G-code block 1") {
         THEN("fan is not activated when elapsed time is greater than fan threshold") {
             config.set_deserialize_strict({
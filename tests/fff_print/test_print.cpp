@@ -127,6 +127,45 @@ SCENARIO("Print: Brim generation", "[Print]") {
     }
 }
 
+SCENARIO("Print: apply() reports the invalidated milestones", "[Print]") {
+    GIVEN("Two sliced 20mm cubes and default config") {
+        Slic3r::Print      print;
+        Slic3r::Model      model;
+        DynamicPrintConfig config = DynamicPrintConfig::full_print_config();
+        Slic3r::Test::init_print({ TestMesh::cube_20x20x20, TestMesh::cube_20x20x20 }, print, model, config);
+        print.process();
+        print.set_log_invalidated_steps(true);
+        auto print_object_of = [&print](const ModelObject *model_object) {
+            return std::find_if(print.objects().begin(), print.objects().end(), [model_object](const PrintObject *po){ return po->model_object()->id() == model_object->id(); });
+        };
+        WHEN("The same model and config is applied again") {
+            Print::ApplyStatus status = print.apply(model, config);
+            THEN("Nothing is invalidated") {
+                REQUIRE(status == Print::APPLY_STATUS_UNCHANGED);
+                REQUIRE(print.invalidated_steps().empty());
+            }
+        }
+        WHEN("Number of perimeters of the first object is changed") {
+            model.objects.front()->config.set("perimeters", 5);
+            Print::ApplyStatus status = print.apply(model, config);
+            const ObjectID changed   = (*print_object_of(model.objects.front()))->id();
+            const ObjectID unchanged = (*print_object_of(model.objects.back()))->id();
+            THEN("Perimeters of the first object are invalidated due to its region config change") {
+                REQUIRE(status == Print::APPLY_STATUS_INVALIDATED);
+                const std::vector<PrintBase::InvalidatedStep> &steps = print.invalidated_steps();
+                REQUIRE(std::find_if(steps.begin(), steps.end(), [changed](const PrintBase::InvalidatedStep &s) {
+                    return s.object_id == changed && s.step == posPerimeters && std::string(s.reason) == "region config changed"; }) != steps.end());
+                REQUIRE(std::find_if(steps.begin(), steps.end(), [changed](const PrintBase::InvalidatedStep &s) {
+                    return s.object_id == changed && s.step == posSlice; }) == steps.end());
+            }
+            THEN("The second object is not invalidated") {
+                const std::vector<PrintBase::InvalidatedStep> &steps = print.invalidated_steps();
+                REQUIRE(std::find_if(steps.begin(), steps.end(), [unchanged](const PrintBase::InvalidatedStep &s) { return s.object_id == unchanged; }) == steps.end());
+            }
+        }
+    }
+}
+
 SCENARIO("Ported from Perl", "[Print]") {
     GIVEN("20mm cube") {
         WHEN("Print center is set to 100x100 (test framework default)")  {
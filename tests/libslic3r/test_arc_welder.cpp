@@ -1,11 +1,15 @@
 #include <catch2/catch.hpp>
 #include <test_utils.hpp>
 
+#include <chrono>
+#include <iostream>
 #include <random>
 
 #include <libslic3r/Geometry/ArcWelder.hpp>
 #include <libslic3r/Geometry/Circle.hpp>
 #include <libslic3r/SVG.hpp>
+#include <libslic3r/TriangleMesh.hpp>
+#include <libslic3r/TriangleMeshSlicer.hpp>
 #include <libslic3r/libslic3r.h>
 
 using namespace Slic3r;
@@ -399,6 +403,61 @@ TEST_CASE("arc wedge test", "[ArcWelder]") {
     }
 }
 
+// Perimeters of an organic model sliced at regular intervals, closed to polylines as they are extruded.
+static std::vector<Points> sliced_perimeters(const std::string &obj_filename, const size_t num_layers)
+{
+    TriangleMesh        mesh = load_model(obj_filename);
+    const BoundingBoxf3 bbox = mesh.bounding_box();
+    std::vector<float>  zs;
+    for (size_t i = 0; i < num_layers; ++ i)
+        zs.emplace_back(float(bbox.min.z() + (bbox.max.z() - bbox.min.z()) * (double(i) + 0.5) / double(num_layers)));
+    std::vector<Points> out;
+    for (const Polygons &layer : slice_mesh(mesh.its, zs, MeshSlicingParams{}))
+        for (const Polygon &contour : layer) {
+            out.emplace_back(contour.points);
+            out.back().emplace_back(contour.points.front());
+        }
+    return out;
+}
+
+TEST_CASE("arc fitting of sliced perimeters", "[ArcWelder]") {
+    using namespace Slic3r::Geometry;
+    const double        tolerance  = ArcWelder::default_scaled_resolution;
+    std::vector<Points> perimeters = sliced_perimeters("frog_legs.obj", 20);
+    REQUIRE(! perimeters.empty());
+    for (const Points &pts : perimeters) {
+        ArcWelder::Path path = ArcWelder::fit_path(pts, tolerance, ArcWelder::default_arc_length_percent_tolerance);
+        REQUIRE(path.size() >= 2);
+        REQUIRE(path.front().point == pts.front());
+        REQUIRE(path.back().point == pts.back());
+        // Each segment interpolates a span of the source polyline, each arc fits its span
+        // up to the tolerance of the initial Douglas-Peucker simplification.
+        auto begin = pts.begin();
+        for (size_t i = 1; i < path.size(); ++ i) {
+            auto end = std::find(std::next(begin), pts.end(), path[i].point);
+            REQUIRE(end != pts.end());
+            if (! path[i].linear())
+                REQUIRE(std::abs(ArcWelder::arc_fit_max_deviation(path[i - 1].point, path[i].point, path[i].radius, path[i].ccw(), begin, std::next(end))) < 1.05 * tolerance);
+            begin = end;
+        }
+    }
+}
+
+TEST_CASE("arc fitting of sliced perimeters time Benchmark", "[ArcWelder][.]") {
+    using namespace Slic3r::Geometry;
+    std::vector<Points> perimeters = sliced_perimeters("frog_legs.obj", 200);
+    size_t num_points   = 0;
+    size_t num_segments = 0;
+    auto   t1           = std::chrono::high_resolution_clock::now();
+    for (const Points &pts : perimeters) {
+        num_points   += pts.size();
+        num_segments += ArcWelder::fit_path(pts, ArcWelder::default_scaled_resolution, ArcWelder::default_arc_length_percent_tolerance).size();
+    }
+    auto   t2           = std::chrono::high_resolution_clock::now();
+    std::cout << "Fitting " << perimeters.size() << " perimeters with " << num_points << " points to " << num_segments << " segments took " <<
+        std::chrono::duration<double>(t2 - t1).count() << " seconds." << std::endl;
+}
+
 #if 0
 // For quantization
 //#include <libslic3r/GCode/GCodeWriter.hpp>
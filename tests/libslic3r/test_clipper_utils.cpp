@@ -382,3 +382,50 @@ TEST_CASE("Traversing Clipper PolyTree", "[ClipperUtils]") {
         REQUIRE(count_polys(output) == reference.size());
     }
 }
+
+TEST_CASE("Clustered boolean operations match the plain ones", "[ClipperUtils]") {
+    // Grid of small islands, some of them overlapping their neighbors, one island inside a hole of another one.
+    ExPolygons islands;
+    for (coord_t ix = 0; ix < 20; ++ ix)
+        for (coord_t iy = 0; iy < 20; ++ iy) {
+            Polygon square{ { 0, 0 }, { 100, 0 }, { 100, 100 }, { 0, 100 } };
+            square.translate(ix * 150 + (iy % 3 == 0 ? 60 : 0), iy * 150);
+            islands.emplace_back(std::move(square));
+        }
+    ExPolygon frame({ { 5000, 5000 }, { 6000, 5000 }, { 6000, 6000 }, { 5000, 6000 } },
+                    { { 5200, 5200 }, { 5200, 5800 }, { 5800, 5800 }, { 5800, 5200 } });
+    islands.emplace_back(frame);
+    islands.push_back({ { { 5400, 5400 }, { 5600, 5400 }, { 5600, 5600 }, { 5400, 5600 } } });
+
+    // Few large regions, one of them not touching any island, one touching an island at its boundary only.
+    Polygons regions{
+        { { 50, 50 }, { 1500, 50 }, { 1500, 1000 }, { 50, 1000 } },
+        { { 2000, 1200 }, { 2800, 1200 }, { 2400, 2900 } },
+        { { 5100, 5100 }, { 5500, 5100 }, { 5500, 5500 }, { 5100, 5500 } },
+        { { 10000, 10000 }, { 11000, 10000 }, { 11000, 11000 }, { 10000, 11000 } },
+        { { 2950, 0 }, { 3500, 0 }, { 3500, 100 }, { 2950, 100 } }
+    };
+
+    auto same_area = [](const ExPolygons &clustered, const ExPolygons &plain) {
+        REQUIRE(area(clustered) == Approx(area(plain)));
+        REQUIRE(diff_ex(clustered, plain).empty());
+        REQUIRE(diff_ex(plain, clustered).empty());
+    };
+
+    SECTION("diff") {
+        same_area(diff_ex_clustered(islands, regions), diff_ex(islands, regions));
+        same_area(diff_ex_clustered(islands, regions, ApplySafetyOffset::Yes), diff_ex(islands, regions, ApplySafetyOffset::Yes));
+        same_area(diff_ex_clustered(to_polygons(islands), regions), diff_ex(to_polygons(islands), regions));
+        // As used by the infill generator to clip the surfaces of a layer by the preceding ones.
+        same_area(diff_ex_clustered(to_polygons(islands), regions, ApplySafetyOffset::Yes), diff_ex(to_polygons(islands), regions, ApplySafetyOffset::Yes));
+    }
+    SECTION("intersection") {
+        same_area(intersection_ex_clustered(islands, regions), intersection_ex(islands, regions));
+        same_area(intersection_ex_clustered(islands, regions, ApplySafetyOffset::Yes), intersection_ex(islands, regions, ApplySafetyOffset::Yes));
+        same_area(intersection_ex_clustered(islands, union_ex(regions)), intersection_ex(islands, union_ex(regions)));
+    }
+    SECTION("union") {
+        same_area(union_ex_clustered(islands), union_ex(islands));
+        same_area(union_ex_clustered(to_polygons(islands)), union_ex(to_polygons(islands)));
+    }
+}
@@ -245,3 +245,41 @@ SCENARIO("DynamicPrintConfig serialization", "[Config]") {
         }
     }
 }
+
+SCENARIO("DynamicPrintConfig copies share option values until modified", "[Config]") {
+    GIVEN("A full print config and its copy") {
+        const DynamicPrintConfig config = DynamicPrintConfig::full_print_config();
+        DynamicPrintConfig copy(config);
+        THEN("The copy is equal and does not differ") {
+            REQUIRE(copy == config);
+            REQUIRE(config.diff(copy).empty());
+            REQUIRE(config.equal(copy).size() == config.size());
+        }
+        WHEN("An option of the copy is modified through a mutable pointer") {
+            copy.option<ConfigOptionInt>("perimeters", true)->value = config.opt_int("perimeters") + 1;
+            THEN("The source config is not modified") {
+                REQUIRE(copy.opt_int("perimeters") == config.opt_int("perimeters") + 1);
+                REQUIRE(config.diff(copy) == t_config_option_keys{ "perimeters" });
+            }
+        }
+        WHEN("An option is modified through a pointer kept over a copy of the config") {
+            ConfigOptionInt *perimeters = copy.option<ConfigOptionInt>("perimeters", true);
+            DynamicPrintConfig copy2(copy);
+            perimeters->value = config.opt_int("perimeters") + 1;
+            THEN("Only the config the pointer was taken from is modified") {
+                REQUIRE(copy.opt_int("perimeters") == config.opt_int("perimeters") + 1);
+                REQUIRE(copy2.opt_int("perimeters") == config.opt_int("perimeters"));
+            }
+        }
+        WHEN("A config is applied over a config with a kept pointer") {
+            DynamicPrintConfig other(config);
+            ConfigOptionInt *perimeters = other.option<ConfigOptionInt>("perimeters", true);
+            copy.set_key_value("perimeters", new ConfigOptionInt(config.opt_int("perimeters") + 2));
+            other += copy;
+            THEN("The kept pointer sees the new value") {
+                REQUIRE(perimeters->value == config.opt_int("perimeters") + 2);
+                REQUIRE(other == copy);
+            }
+        }
+    }
+}
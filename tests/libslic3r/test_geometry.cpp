@@ -459,6 +459,45 @@ SCENARIO("Path chaining", "[Geometry]") {
 			}
 		}
 	}
+	GIVEN("Thousands of short segments on a grid") {
+		// Large enough for the KD tree of end points to be pruned while chaining.
+		const int grid_size = 60;
+		const coord_t spacing = 1000;
+		Polylines polylines;
+		Points    points;
+		// Interleave the rows to not feed the chaining with an already ordered input.
+		for (int row = 0; row < grid_size; ++ row)
+			for (int col = 0; col < grid_size; ++ col) {
+				Point pt((col * 7 % grid_size) * spacing, (row * 11 % grid_size) * spacing);
+				polylines.push_back({ pt, pt + Point(spacing / 10, 0) });
+				points.emplace_back(pt);
+			}
+		const double max_connection_length = 2. * spacing * double(polylines.size());
+		THEN("chain_polylines() orders all segments with short connections") {
+			Polylines chained = chain_polylines(polylines);
+			REQUIRE(chained.size() == polylines.size());
+			std::vector<Point> first_points;
+			double connection_length = 0.;
+			for (size_t i = 0; i < chained.size(); ++ i) {
+				first_points.emplace_back(std::min(chained[i].first_point(), chained[i].last_point()));
+				if (i > 0)
+					connection_length += (chained[i].first_point() - chained[i - 1].last_point()).cast<double>().norm();
+			}
+			std::sort(first_points.begin(), first_points.end());
+			REQUIRE(std::unique(first_points.begin(), first_points.end()) == first_points.end());
+			REQUIRE(connection_length < max_connection_length);
+		}
+		THEN("chain_points() orders all points with short connections") {
+			std::vector<size_t> indices = chain_points(points);
+			REQUIRE(indices.size() == points.size());
+			double connection_length = 0.;
+			for (size_t i = 1; i < indices.size(); ++ i)
+				connection_length += (points[indices[i]] - points[indices[i - 1]]).cast<double>().norm();
+			std::sort(indices.begin(), indices.end());
+			REQUIRE(std::unique(indices.begin(), indices.end()) == indices.end());
+			REQUIRE(connection_length < max_connection_length);
+		}
+	}
 }
 
 SCENARIO("Line distances", "[Geometry]"){
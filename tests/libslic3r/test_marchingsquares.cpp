@@ -2,6 +2,7 @@
 #include <test_utils.hpp>
 
 #include <fstream>
+#include <chrono>
 
 #include <libslic3r/MarchingSquares.hpp>
 #include <libslic3r/SLA/RasterToPolygons.hpp>
@@ -309,6 +310,137 @@ TEST_CASE("Circle with hole in the middle", "[MarchingSquares]") {
     test_expolys(create_raster({1000, 1000}), circle_with_hole(25.), W2x2, "circle_with_hole");   
 }
 
+// Raster with the pixels stored row by row
+struct PixelBuffer {
+    std::vector<uint8_t> px;
+    size_t rows = 0, cols = 0;
+};
+
+// The same raster accessible only pixel by pixel
+struct PixelAccessor {
+    const PixelBuffer *buf;
+};
+
+namespace marchsq {
+template<> struct _RasterTraits<PixelBuffer> {
+    using ValueType = uint8_t;
+    static uint8_t get(const PixelBuffer &rst, size_t row, size_t col) { return rst.px[row * rst.cols + col]; }
+    static const uint8_t *row(const PixelBuffer &rst, size_t row) { return rst.px.data() + row * rst.cols; }
+    static size_t rows(const PixelBuffer &rst) { return rst.rows; }
+    static size_t cols(const PixelBuffer &rst) { return rst.cols; }
+};
+
+template<> struct _RasterTraits<PixelAccessor> {
+    using ValueType = uint8_t;
+    static uint8_t get(const PixelAccessor &rst, size_t row, size_t col) { return rst.buf->px[row * rst.buf->cols + col]; }
+    static size_t rows(const PixelAccessor &rst) { return rst.buf->rows; }
+    static size_t cols(const PixelAccessor &rst) { return rst.buf->cols; }
+};
+} // namespace marchsq
+
+static bool is_same(const std::vector<marchsq::Ring> &rings1,
+                    const std::vector<marchsq::Ring> &rings2)
+{
+    if (rings1.size() != rings2.size())
+        return false;
+
+    for (size_t i = 0; i < rings1.size(); ++i) {
+        if (rings1[i].size() != rings2[i].size())
+            return false;
+
+        for (size_t j = 0; j < rings1[i].size(); ++j)
+            if (rings1[i][j].r != rings2[i][j].r || rings1[i][j].c != rings2[i][j].c)
+                return false;
+    }
+
+    return true;
+}
+
+static PixelBuffer to_pixel_buffer(const sla::RasterGrayscaleAA &rst)
+{
+    PixelBuffer buf;
+    buf.rows = rst.resolution().height_px;
+    buf.cols = rst.resolution().width_px;
+    buf.px.reserve(buf.rows * buf.cols);
+    for (size_t r = 0; r < buf.rows; ++r)
+        for (size_t c = 0; c < buf.cols; ++c)
+            buf.px.emplace_back(rst.read_pixel(c, r));
+
+    return buf;
+}
+
+TEST_CASE("Rings of the active raster region match the whole raster", "[MarchingSquares]") {
+    auto rst = create_raster({400, 300}, 100., 75.);
+    for (const ExPolygon &expoly : circle_with_hole(10., {scaled(30.), scaled(40.)}))
+        rst.draw(expoly);
+    rst.draw(square_with_hole(8., {scaled(55.), scaled(30.)}));
+
+    PixelBuffer buf = to_pixel_buffer(rst);
+
+    marchsq::Coord from{long(buf.rows), long(buf.cols)}, to{0, 0};
+    for (size_t r = 0; r < buf.rows; ++r)
+        for (size_t c = 0; c < buf.cols; ++c)
+            if (buf.px[r * buf.cols + c] >= 128) {
+                from.r = std::min(from.r, long(r));
+                from.c = std::min(from.c, long(c));
+                to.r   = std::max(to.r, long(r) + 1);
+                to.c   = std::max(to.c, long(c) + 1);
+            }
+
+    REQUIRE(from.r < to.r);
+
+    for (marchsq::Coord win : {marchsq::Coord{2, 2}, marchsq::Coord{3, 5},
+                               marchsq::Coord{4, 4}, marchsq::Coord{8, 8}}) {
+        std::vector<marchsq::Ring> rings = marchsq::execute(PixelAccessor{&buf}, uint8_t(128), win);
+
+        REQUIRE(!rings.empty());
+        REQUIRE(is_same(marchsq::execute_in_region(PixelAccessor{&buf}, uint8_t(128), from, to, win), rings));
+        REQUIRE(is_same(marchsq::execute_in_region(buf, uint8_t(128), from, to, win), rings));
+    }
+}
+
+TEST_CASE("Rasters with continuous rows give the same rings", "[MarchingSquares]") {
+    auto rst = create_raster({333, 257}, 100., 75.);
+    for (const ExPolygon &expoly : circle_with_hole(20., {scaled(40.), scaled(35.)}))
+        rst.draw(expoly);
+    rst.draw(square_with_hole(30., {scaled(80.), scaled(50.)}));
+
+    PixelBuffer buf = to_pixel_buffer(rst);
+
+    for (marchsq::Coord win : {marchsq::Coord{2, 2}, marchsq::Coord{2, 3},
+                               marchsq::Coord{5, 4}, marchsq::Coord{8, 8}}) {
+        std::vector<marchsq::Ring> rings = marchsq::execute(PixelAccessor{&buf}, uint8_t(128), win);
+
+        REQUIRE(!rings.empty());
+        REQUIRE(is_same(marchsq::execute(buf, uint8_t(128), win), rings));
+    }
+}
+
+TEST_CASE("Marching squares on a display sized raster time Benchmark", "[MarchingSquares][.]") {
+    auto rst = create_raster({2560, 1440}, 120.96, 68.04);
+    for (const ExPolygon &expoly : circle_with_hole(25., {scaled(40.), scaled(30.)}))
+        rst.draw(expoly);
+    rst.draw(square_with_hole(20., {scaled(90.), scaled(40.)}));
+
+    PixelBuffer buf = to_pixel_buffer(rst);
+
+    for (long w : {2l, 4l, 8l}) {
+        marchsq::Coord win{w, w};
+
+        auto t1 = std::chrono::high_resolution_clock::now();
+        std::vector<marchsq::Ring> rings = marchsq::execute(PixelAccessor{&buf}, uint8_t(128), win);
+        auto t2 = std::chrono::high_resolution_clock::now();
+        std::vector<marchsq::Ring> fast_rings = marchsq::execute(buf, uint8_t(128), win);
+        auto t3 = std::chrono::high_resolution_clock::now();
+
+        REQUIRE(is_same(fast_rings, rings));
+
+        std::cout << "Window " << w << "x" << w << ": pixel by pixel "
+                  << std::chrono::duration<double, std::milli>(t2 - t1).count() << " ms, by rows "
+                  << std::chrono::duration<double, std::milli>(t3 - t2).count() << " ms" << std::endl;
+    }
+}
+
 static void recreate_object_from_rasters(const std::string &objname, float lh) {
     TriangleMesh mesh = load_model(objname);
     
@@ -46,6 +46,28 @@ SCENARIO("Placeholder parser scripting", "[PlaceholderParser]") {
 
     SECTION("parsing string with escaped characters") { REQUIRE(parser.process("{\"hu\\nha\\\\\\\"ha\\\"\"}") == "hu\nha\\\"ha\""); }
 
+    // Templates are compiled into text blocks, simple variable expansions and code blocks processed by the grammar.
+    SECTION("simple variable expansions mixed with code blocks") {
+        REQUIRE(parser.process("T{foo}[bar] {temperature[bar]}{if foo == 0} zero{temperature[1]}{else} nonzero{endif} [temperature_3]") == "T02 363 zero359 378");
+    }
+    SECTION("local variable defined in one code block, referenced by a simple variable expansion") {
+        REQUIRE(parser.process("{local myint = 3 * 4}text {myint}", 0, nullptr, nullptr, nullptr) == "text 12");
+    }
+    SECTION("braces inside a string literal and a regular expression") {
+        REQUIRE(parser.process("{if \"{\" + \"}\" =~ /\\{}/}{bar}{endif}") == "2");
+    }
+    SECTION("repeated processing of the same template") {
+        const char *expected[] = { "0 357", "1 359", "2 363" };
+        for (int i = 0; i < 3; ++ i) {
+            parser.set("foo", i);
+            REQUIRE(parser.process("[foo] {temperature[foo]}") == expected[i]);
+        }
+    }
+    SECTION("error is reported relative to the complete template") {
+        REQUIRE_THROWS_WITH(parser.process("{foo}\n{nonexistent_variable}"), Catch::Contains("Parsing error at line 2"));
+        REQUIRE_THROWS_WITH(parser.process("{foo}\n{if foo == 0}\n{nonexistent_variable}{endif}"), Catch::Contains("Parsing error at line 3"));
+    }
+
     WHEN("An UTF-8 character is used inside the code block") {
         THEN("A std::runtime_error exception is thrown.") {
             // full-width plus sign instead of plain +
@@ -0,0 +1,139 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/PresetBundle.hpp"
+#include "libslic3r/Utils.hpp"
+
+#include <boost/algorithm/string/replace.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/nowide/fstream.hpp>
+
+using namespace Slic3r;
+
+namespace fs = boost::filesystem;
+
+static const char *test_vendor_bundle = R"(
+[vendor]
+name = CacheTest
+config_version = 0.0.1
+
+[printer_model:CT1]
+name = Cache Test 1
+variants = 0.4
+technology = FFF
+family = CacheTest
+
+[print:*common*]
+layer_height = 0.2
+perimeters = 3
+
+[print:0.20mm NORMAL @CT1]
+inherits = *common*
+fill_density = 20%
+
+[print:0.10mm DETAIL @CT1]
+inherits = *common*
+layer_height = 0.1
+
+[filament:Generic PLA @CT1]
+temperature = 215
+
+[printer:Cache Test 1]
+printer_model = CT1
+printer_variant = 0.4
+nozzle_diameter = 0.4
+)";
+
+static void write_file(const fs::path &path, const std::string &data)
+{
+    boost::nowide::ofstream ofs(path.string(), std::ios::binary | std::ios::trunc);
+    ofs << data;
+}
+
+// Installs the test vendor bundle into a temporary data directory.
+struct TestDataDir {
+    TestDataDir() : data_dir_old(data_dir()), dir(fs::temp_directory_path() / fs::unique_path()) {
+        fs::create_directories(dir / "vendor");
+        set_data_dir(dir.string());
+        write_file(bundle_path(), test_vendor_bundle);
+    }
+    ~TestDataDir() {
+        set_data_dir(data_dir_old);
+        boost::system::error_code ec;
+        fs::remove_all(dir, ec);
+    }
+    fs::path bundle_path() const { return dir / "vendor" / "CacheTest.ini"; }
+    fs::path cache_path()  const { return dir / "vendor" / "cache" / "CacheTest.cache"; }
+
+    std::string data_dir_old;
+    fs::path    dir;
+};
+
+static DynamicPrintConfig load_print_preset(const fs::path &bundle_path, PresetBundle::LoadConfigBundleAttributes flags, const std::string &name)
+{
+    PresetBundle bundle;
+    bundle.load_configbundle(bundle_path.string(), flags, ForwardCompatibilitySubstitutionRule::Disable);
+    const Preset *preset = bundle.prints.find_preset(name);
+    REQUIRE(preset != nullptr);
+    return preset->config;
+}
+
+static constexpr const PresetBundle::LoadConfigBundleAttribute LoadSystem  = PresetBundle::LoadConfigBundleAttribute::LoadSystem;
+static constexpr const PresetBundle::LoadConfigBundleAttribute CacheSystem = PresetBundle::LoadConfigBundleAttribute::CacheSystem;
+
+TEST_CASE("System config bundle loaded from its cache matches the parsed bundle", "[PresetBundle]")
+{
+    TestDataDir data;
+    DynamicPrintConfig parsed = load_print_preset(data.bundle_path(), LoadSystem | CacheSystem, "0.10mm DETAIL @CT1");
+    REQUIRE(fs::exists(data.cache_path()));
+    // Nothing is written next to the bundle.
+    REQUIRE(! fs::exists(fs::path(data.bundle_path()).replace_extension(".cache")));
+
+    // Backdate the cache to detect whether it is written again.
+    const std::time_t time_written = fs::last_write_time(data.cache_path()) - 3600;
+    fs::last_write_time(data.cache_path(), time_written);
+    DynamicPrintConfig cached = load_print_preset(data.bundle_path(), LoadSystem | CacheSystem, "0.10mm DETAIL @CT1");
+    REQUIRE(fs::last_write_time(data.cache_path()) == time_written);
+
+    REQUIRE(cached == parsed);
+    REQUIRE(cached.opt_float("layer_height") == Approx(0.1));
+    // Inherited from the abstract *common* preset.
+    REQUIRE(cached.opt_int("perimeters") == 3);
+}
+
+TEST_CASE("System config bundle cache is invalidated by a change of the bundle", "[PresetBundle]")
+{
+    TestDataDir data;
+    load_print_preset(data.bundle_path(), LoadSystem | CacheSystem, "0.10mm DETAIL @CT1");
+    REQUIRE(fs::exists(data.cache_path()));
+    const std::time_t time_written = fs::last_write_time(data.cache_path()) - 3600;
+
+    SECTION("Changed bundle") {
+        fs::last_write_time(data.cache_path(), time_written);
+        write_file(data.bundle_path(), boost::replace_first_copy(std::string(test_vendor_bundle), "layer_height = 0.1\n", "layer_height = 0.15\n"));
+        DynamicPrintConfig config = load_print_preset(data.bundle_path(), LoadSystem | CacheSystem, "0.10mm DETAIL @CT1");
+        REQUIRE(config.opt_float("layer_height") == Approx(0.15));
+        REQUIRE(fs::last_write_time(data.cache_path()) != time_written);
+    }
+
+    SECTION("Truncated cache") {
+        fs::resize_file(data.cache_path(), fs::file_size(data.cache_path()) / 2);
+        fs::last_write_time(data.cache_path(), time_written);
+        DynamicPrintConfig config = load_print_preset(data.bundle_path(), LoadSystem | CacheSystem, "0.10mm DETAIL @CT1");
+        REQUIRE(config.opt_float("layer_height") == Approx(0.1));
+        REQUIRE(fs::last_write_time(data.cache_path()) != time_written);
+    }
+}
+
+TEST_CASE("System config bundles outside of the data directory are not cached", "[PresetBundle]")
+{
+    TestDataDir data;
+    // Such as a bundle validated by the PresetUpdater or a bundle in the resources directory.
+    const fs::path other_dir  = data.dir / "other";
+    const fs::path other_path = other_dir / "Other.ini";
+    fs::create_directories(other_dir);
+    write_file(other_path, test_vendor_bundle);
+    DynamicPrintConfig config = load_print_preset(other_path, LoadSystem, "0.10mm DETAIL @CT1");
+    REQUIRE(config.opt_float("layer_height") == Approx(0.1));
+    REQUIRE(! fs::exists(fs::path(other_path).replace_extension(".cache")));
+    REQUIRE(! fs::exists(data.dir / "vendor" / "cache" / "Other.cache"));
+}
@@ -0,0 +1,131 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/Model.hpp"
+#include "libslic3r/TriangleMesh.hpp"
+#include "libslic3r/TriangleSelector.hpp"
+
+using namespace Slic3r;
+
+// Centroid of a facet, used as a point of a brush stroke.
+static Vec3f facet_centroid(const TriangleMesh &mesh, int facet_idx)
+{
+    const stl_triangle_vertex_indices &face = mesh.its.indices[facet_idx];
+    return (mesh.its.vertices[face(0)] + mesh.its.vertices[face(1)] + mesh.its.vertices[face(2)]) / 3.f;
+}
+
+// Paints a brush stroke over a chain of neighboring facets and returns the facets the stroke points belong to.
+static std::vector<int> stroke_facets(const TriangleMesh &mesh, int facet_start, size_t num_points)
+{
+    const std::vector<Vec3i> neighbors = its_face_neighbors(mesh.its);
+    std::vector<int>         facets { facet_start };
+    while (facets.size() < num_points) {
+        int next = -1;
+        for (int neighbor : neighbors[facets.back()])
+            if (neighbor >= 0 && std::find(facets.begin(), facets.end(), neighbor) == facets.end()) {
+                next = neighbor;
+                break;
+            }
+        if (next == -1)
+            break;
+        facets.emplace_back(next);
+    }
+    return facets;
+}
+
+static double area(const indexed_triangle_set &its)
+{
+    double area = 0.;
+    for (const stl_triangle_vertex_indices &face : its.indices)
+        area += 0.5 * (its.vertices[face(1)] - its.vertices[face(0)]).cast<double>().cross((its.vertices[face(2)] - its.vertices[face(0)]).cast<double>()).norm();
+    return area;
+}
+
+static void paint_stroke(TriangleSelector &selector, const TriangleMesh &mesh, const std::vector<int> &facets, EnforcerBlockerType state, bool as_single_stroke)
+{
+    const Transform3d trafo  = Transform3d::Identity();
+    const float       radius = 1.5f;
+    const Vec3f       camera = facet_centroid(mesh, facets.front()) + 100.f * its_face_normal(mesh.its, facets.front());
+    std::vector<std::unique_ptr<TriangleSelector::Cursor>> cursors;
+    for (size_t i = 0; i + 1 < facets.size(); ++ i)
+        cursors.emplace_back(TriangleSelector::DoublePointCursor::cursor_factory(facet_centroid(mesh, facets[i]), facet_centroid(mesh, facets[i + 1]),
+            camera, radius, TriangleSelector::CursorType::SPHERE, trafo, TriangleSelector::ClippingPlane()));
+    if (as_single_stroke)
+        selector.select_stroke(facets, std::move(cursors), state, trafo, true);
+    else
+        for (size_t i = 0; i < cursors.size(); ++ i)
+            selector.select_patch(facets[i], std::move(cursors[i]), state, trafo, true);
+}
+
+SCENARIO("TriangleSelector painting and serialization", "[TriangleSelector]") {
+    GIVEN("A sphere painted by a brush stroke") {
+        const TriangleMesh     mesh = make_sphere(10., PI / 18.);
+        const std::vector<int> facets = stroke_facets(mesh, 0, 6);
+        REQUIRE(facets.size() == 6);
+
+        TriangleSelector selector(mesh);
+        paint_stroke(selector, mesh, facets, EnforcerBlockerType::Extruder3, true);
+        paint_stroke(selector, mesh, stroke_facets(mesh, int(mesh.its.indices.size()) / 2, 4), EnforcerBlockerType::ENFORCER, true);
+
+        THEN("Painted facets are found") {
+            REQUIRE(selector.has_facets(EnforcerBlockerType::Extruder3));
+            REQUIRE(selector.has_facets(EnforcerBlockerType::ENFORCER));
+            REQUIRE(! selector.has_facets(EnforcerBlockerType::BLOCKER));
+        }
+        THEN("The stroke paints the same facets as the stroke painted segment by segment") {
+            TriangleSelector selector_segments(mesh);
+            paint_stroke(selector_segments, mesh, facets, EnforcerBlockerType::Extruder3, false);
+            // Both subdivide the triangles under the stroke down to the same limit.
+            REQUIRE(selector.num_facets(EnforcerBlockerType::Extruder3) == selector_segments.num_facets(EnforcerBlockerType::Extruder3));
+            REQUIRE(area(selector.get_facets_strict(EnforcerBlockerType::Extruder3)) == Approx(area(selector_segments.get_facets_strict(EnforcerBlockerType::Extruder3))).epsilon(1e-4));
+        }
+        WHEN("The painting is serialized and deserialized") {
+            const auto data = selector.serialize();
+            TriangleSelector selector2(mesh);
+            selector2.deserialize(data);
+            THEN("The deserialized painting is the same") {
+                REQUIRE(selector2.serialize() == data);
+                REQUIRE(TriangleSelector::has_facets(data, EnforcerBlockerType::Extruder3));
+                REQUIRE(selector2.num_facets(EnforcerBlockerType::Extruder3) == selector.num_facets(EnforcerBlockerType::Extruder3));
+                REQUIRE(selector2.num_facets(EnforcerBlockerType::ENFORCER) == selector.num_facets(EnforcerBlockerType::ENFORCER));
+            }
+        }
+    }
+}
+
+SCENARIO("TriangleSelector deserialization of many painted triangles", "[TriangleSelector]") {
+    GIVEN("A sphere with more painted triangles than a deserialization chunk") {
+        const TriangleMesh mesh = make_sphere(10., PI / 90.);
+        REQUIRE(mesh.its.indices.size() > 3 * 4096);
+
+        TriangleSelector selector(mesh);
+        // Leaf triangles of all the states, including the extended states encoded by 8 bits.
+        for (int i = 0; i < int(mesh.its.indices.size()); ++ i)
+            if (i % 3 != 0)
+                selector.set_facet(i, EnforcerBlockerType(1 + i % 5));
+        // Split triangles in several chunks.
+        for (int facet_start : { 100, int(mesh.its.indices.size()) / 2, int(mesh.its.indices.size()) - 100 })
+            paint_stroke(selector, mesh, stroke_facets(mesh, facet_start, 6), EnforcerBlockerType::Extruder7, true);
+
+        const auto data = selector.serialize();
+        REQUIRE(data.first.size() > 2 * 4096);
+
+        WHEN("The painting is deserialized") {
+            TriangleSelector selector2(mesh);
+            selector2.deserialize(data);
+            THEN("The deserialized painting is the same") {
+                REQUIRE(selector2.serialize() == data);
+                for (int state = 0; state <= int(EnforcerBlockerType::Extruder7); ++ state)
+                    REQUIRE(selector2.num_facets(EnforcerBlockerType(state)) == selector.num_facets(EnforcerBlockerType(state)));
+            }
+        }
+        WHEN("The painting is deserialized from triangles stored in reverse order") {
+            auto data_reversed = data;
+            std::reverse(data_reversed.first.begin(), data_reversed.first.end());
+            TriangleSelector selector2(mesh);
+            selector2.deserialize(data_reversed);
+            THEN("The deserialized painting is the same") {
+                REQUIRE(selector2.serialize() == data);
+            }
+        }
+    }
+}
@@ -2,12 +2,15 @@
 #include <random>
 #include <numeric>
 #include <cstdint>
+#include <chrono>
 
 #include "sla_test_utils.hpp"
 
 #include <libslic3r/TriangleMeshSlicer.hpp>
 #include <libslic3r/SLA/SupportTreeMesher.hpp>
 #include <libslic3r/BranchingTree/PointCloud.hpp>
+#include <libslic3r/SLA/Rotfinder.hpp>
+#include <libslic3r/Model.hpp>
 
 namespace {
 
@@ -149,6 +152,38 @@ TEST_CASE("DefaultSupports::FloorSupportsDoNotPierceModel", "[SLASupportGenerati
         test_support_model_collision(fname, supportcfg);
 }
 
+TEST_CASE("DefaultSupports::TreeSlicesMatchSupportMeshSlices", "[SLASupportGeneration]") {
+    sla::SupportTreeConfig supportcfg;
+    supportcfg.object_elevation_mm = 10.;
+
+    for (auto fname : SUPPORT_TEST_MODELS) {
+        SupportByproducts byproducts;
+        test_supports(fname, supportcfg, byproducts);
+
+        const sla::SupportTreeBuilder &builder = byproducts.suptree_builder;
+        std::vector<ExPolygons> mesh_slices =
+            sla::slice(builder.retrieve_mesh(sla::MeshType::Support), {},
+                       byproducts.slicegrid, CLOSING_RADIUS, {});
+        std::vector<ExPolygons> tree_slices =
+            sla::slice(builder.primitives(), {}, byproducts.slicegrid,
+                       CLOSING_RADIUS, {});
+
+        REQUIRE(tree_slices.size() == mesh_slices.size());
+
+        // The slices differ only by the discretization of the meshed
+        // primitives along their axes.
+        double mesh_area = 0., diff_area = 0.;
+        for (size_t n = 0; n < mesh_slices.size(); ++n) {
+            mesh_area += area(mesh_slices[n]);
+            diff_area += area(diff(mesh_slices[n], tree_slices[n])) +
+                         area(diff(tree_slices[n], mesh_slices[n]));
+        }
+
+        REQUIRE(mesh_area > 0.);
+        REQUIRE(diff_area < 0.01 * mesh_area);
+    }
+}
+
 //TEST_CASE("BranchingSupports::ElevatedSupportGeometryIsValid", "[SLASupportGeneration][Branching]") {
 //    sla::SupportTreeConfig supportcfg;
 //    supportcfg.object_elevation_mm = 10.;
@@ -271,3 +306,169 @@ TEST_CASE("Test concurrency")
 
     REQUIRE(s == Approx(ref));
 }
+
+TEST_CASE("Hollowing voxel scale is lowered to fit into the grid memory limit", "[Hollowing]")
+{
+    indexed_triangle_set cube = its_make_cube(20., 20., 20.);
+    double volume = its_volume(cube);
+    double area   = its_area(cube);
+
+    REQUIRE(area == Approx(6. * 20. * 20.));
+
+    sla::HollowingConfig hc;
+    hc.max_grid_memory = 0;
+    double scale = sla::get_voxel_scale(volume, area, hc);
+    REQUIRE(scale == Approx(sla::get_voxel_scale(volume, hc)));
+
+    sla::InteriorPtr interior = sla::generate_interior(cube, hc);
+    REQUIRE(interior);
+    size_t peak = sla::get_peak_grid_memory(*interior);
+    REQUIRE(peak > 0);
+
+    hc.max_grid_memory = size_t(sla::estimate_grid_memory(area, scale, hc) / 4.);
+    double limited_scale = sla::get_voxel_scale(volume, area, hc);
+    REQUIRE(limited_scale < scale);
+    REQUIRE(sla::estimate_grid_memory(area, limited_scale, hc) <= double(hc.max_grid_memory));
+    REQUIRE(sla::estimate_grid_memory(area, limited_scale, hc) > 0.99 * hc.max_grid_memory);
+
+    sla::InteriorPtr limited_interior = sla::generate_interior(cube, hc);
+    REQUIRE(limited_interior);
+    REQUIRE(!sla::get_mesh(*limited_interior).empty());
+    REQUIRE(sla::get_peak_grid_memory(*limited_interior) < peak);
+
+    // The wall has to be sampled by a few voxels even if the limit is exceeded.
+    hc.quality = 0.;
+    double min_scale = sla::get_voxel_scale(volume, hc);
+    hc.quality = 0.5;
+    hc.max_grid_memory = size_t(sla::estimate_grid_memory(area, min_scale, hc) / 2.);
+    REQUIRE(sla::get_voxel_scale(volume, area, hc) == Approx(min_scale));
+}
+
+TEST_CASE("Rotations of a batch of objects match the single object search", "[SLARotfinder]")
+{
+    Model model;
+
+    // A standing plate and an elongated block, both lowest when lying flat
+    TriangleMesh plate = make_cube(20., 20., 2.);
+    plate.rotate_x(float(PI / 2.));
+    TriangleMesh block = make_cube(10., 10., 30.);
+
+    std::vector<const ModelObject *> objects;
+    for (const TriangleMesh *mesh : {&plate, &block}) {
+        ModelObject *mo = model.add_object();
+        mo->add_volume(*mesh);
+        mo->add_instance();
+        objects.emplace_back(mo);
+    }
+    objects.insert(objects.begin() + 1, nullptr);
+
+    int  last_status = 0;
+    bool monotonic   = true;
+    auto params = sla::RotOptimizeParams{}.accuracy(0.75f).statucb([&](int s) {
+        if (s >= 0) {
+            monotonic = monotonic && s > last_status && s <= 100;
+            last_status = s;
+        }
+        return true;
+    });
+
+    std::vector<Vec2d> rotations =
+        sla::find_rotations(objects, sla::find_min_z_height_rotation, params);
+
+    REQUIRE(rotations.size() == objects.size());
+    REQUIRE(rotations[1] == Vec2d::Zero());
+    REQUIRE(monotonic);
+    REQUIRE(last_status == 100);
+
+    for (double height : {2., 10.}) {
+        size_t idx = height < 5. ? 0 : 2;
+        REQUIRE(rotations[idx] == sla::find_min_z_height_rotation(*objects[idx]));
+
+        TriangleMesh mesh = objects[idx]->raw_mesh();
+        mesh.rotate_x(float(rotations[idx].x()));
+        mesh.rotate_y(float(rotations[idx].y()));
+        REQUIRE(mesh.bounding_box().size().z() == Approx(height).margin(1e-3));
+    }
+
+    std::vector<Vec2d> supp_rotations =
+        sla::find_rotations(objects, sla::find_least_supports_rotation);
+    REQUIRE(supp_rotations[0] == sla::find_least_supports_rotation(*objects[0]));
+    REQUIRE(supp_rotations[2] == sla::find_least_supports_rotation(*objects[2]));
+}
+
+// Footprints of a grid of columns, nx by ny, distance apart and shifted by
+// the offset.
+static ExPolygons column_footprints(size_t nx, size_t ny, double distance,
+                                    const Vec2d &offset)
+{
+    ExPolygons ret;
+    for (size_t x = 0; x < nx; ++x)
+        for (size_t y = 0; y < ny; ++y) {
+            Polygon circle = make_circle_num_segments(scaled(1.), 16);
+            circle.translate(scaled(offset.x() + x * distance),
+                             scaled(offset.y() + y * distance));
+            ret.emplace_back(circle);
+        }
+
+    return ret;
+}
+
+TEST_CASE("Pads of distant footprint groups are built separately", "[SLAPad]")
+{
+    sla::PadConfig padcfg;
+
+    ExPolygons group_a = column_footprints(3, 3, 4., Vec2d::Zero());
+    ExPolygons group_b = column_footprints(2, 4, 4., Vec2d{200., 50.});
+
+    indexed_triangle_set pad_a, pad_b, pad_ab;
+    sla::create_pad(group_a, {}, pad_a, padcfg);
+    sla::create_pad(group_b, {}, pad_b, padcfg);
+
+    ExPolygons group_ab = group_a;
+    append(group_ab, group_b);
+    sla::create_pad(group_ab, {}, pad_ab, padcfg);
+
+    REQUIRE(!pad_a.empty());
+    REQUIRE(!pad_b.empty());
+    REQUIRE(pad_ab.indices.size() == pad_a.indices.size() + pad_b.indices.size());
+    REQUIRE(its_volume(pad_ab) == Approx(its_volume(pad_a) + its_volume(pad_b)));
+}
+
+TEST_CASE("Pad of a large plate time Benchmark", "[SLAPad][.]")
+{
+    sla::PadConfig padcfg;
+    padcfg.max_merge_dist_mm = 10.;
+
+    // Groups of columns spread over a large plate, too far from each other
+    // to share a pad
+    ExPolygons footprints;
+    indexed_triangle_set columns;
+    for (size_t gx = 0; gx < 8; ++gx)
+        for (size_t gy = 0; gy < 6; ++gy) {
+            Vec2d offset{gx * 40., gy * 40.};
+            append(footprints, column_footprints(5, 5, 4., offset));
+
+            for (size_t x = 0; x < 5; ++x)
+                for (size_t y = 0; y < 5; ++y) {
+                    indexed_triangle_set column = its_make_cylinder(1., 5., 2. * PI / 16.);
+                    for (Vec3f &v : column.vertices)
+                        v += Vec3f(offset.x() + x * 4., offset.y() + y * 4., 0.);
+                    its_merge(columns, column);
+                }
+        }
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+    ExPolygons blueprint;
+    sla::pad_blueprint(columns, blueprint, 1.f, 0.1f);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    indexed_triangle_set pad;
+    sla::create_pad(footprints, {}, pad, padcfg);
+    auto t3 = std::chrono::high_resolution_clock::now();
+
+    REQUIRE(!blueprint.empty());
+    REQUIRE(!pad.empty());
+
+    std::cout << "Pad blueprint of " << footprints.size() << " columns took "
+              << std::chrono::duration<double>(t2 - t1).count() << " s, the pad took "
+              << std::chrono::duration<double>(t3 - t2).count() << " s" << std::endl;
+}
@@ -94,3 +94,94 @@ TEST_CASE("Raycaster with loaded drillholes", "[sla_raycast]")
     test_support_model_collision("20mm_cube.obj", {}, hcfg, holes);
 }
 #endif
+
+TEST_CASE("AABBMeshes of a shared mesh share the index", "[sla_raycast]")
+{
+    AABBMeshCache &cache = AABBMeshCache::instance();
+    cache.clear();
+    cache.reset_stats();
+
+    auto sphere = std::make_shared<const indexed_triangle_set>(its_make_sphere(10., PI / 32.));
+
+    AABBMesh emesh1{sphere};
+    AABBMesh emesh2{sphere};
+    REQUIRE(cache.stats().misses == 1);
+    REQUIRE(cache.stats().hits == 1);
+    REQUIRE(emesh1.shares_index_with(emesh2));
+
+    // Differently computed epsilon is a different index.
+    AABBMesh emesh3{sphere, true};
+    REQUIRE(! emesh3.shares_index_with(emesh1));
+
+    AABBMesh emesh_copy{*sphere};
+    auto hit1 = emesh1.query_ray_hit({1., 2., 0.}, {0., 0., 1.});
+    auto hit2 = emesh2.query_ray_hit({1., 2., 0.}, {0., 0., 1.});
+    auto hit3 = emesh_copy.query_ray_hit({1., 2., 0.}, {0., 0., 1.});
+    REQUIRE(hit1.is_hit());
+    REQUIRE(hit1.face() == hit2.face());
+    REQUIRE(hit1.face() == hit3.face());
+    REQUIRE(hit1.distance() == Approx(hit3.distance()));
+
+    SECTION("Transformed mesh is indexed separately") {
+        Transform3d trafo = Transform3d::Identity();
+        trafo.translate(Vec3d{0., 0., 5.});
+
+        AABBMesh moved1{sphere, trafo};
+        AABBMesh moved2{sphere, trafo};
+        REQUIRE(moved1.shares_index_with(moved2));
+        REQUIRE(! moved1.shares_index_with(emesh1));
+
+        auto hit = moved1.query_ray_hit({1., 2., 0.}, {0., 0., 1.});
+        REQUIRE(hit.is_hit());
+        REQUIRE(hit.distance() == Approx(hit1.distance() + 5.));
+    }
+
+    SECTION("Released mesh is dropped from the cache") {
+        std::weak_ptr<const indexed_triangle_set> wsphere = sphere;
+        emesh1 = emesh_copy;
+        emesh2 = emesh_copy;
+        emesh3 = emesh_copy;
+        sphere.reset();
+        REQUIRE(wsphere.expired());
+
+        AABBMesh other{std::make_shared<const indexed_triangle_set>(its_make_cube(1., 1., 1.))};
+        REQUIRE(cache.size() == 1);
+    }
+
+    SECTION("Index is not retained by the cache") {
+        emesh1 = emesh_copy;
+        emesh2 = emesh_copy;
+        emesh3 = emesh_copy;
+
+        AABBMesh other{sphere};
+        REQUIRE(cache.stats().misses == 3);
+        REQUIRE(cache.size() == 1);
+    }
+}
+
+TEST_CASE("Batched ray queries give the same hits as single queries", "[sla_raycast]")
+{
+    TriangleMesh cube = load_model("20mm_cube.obj");
+    AABBMesh emesh{cube};
+
+    std::vector<Vec3d> sources, dirs;
+    for (int i = 0; i < 1000; ++i) {
+        sources.emplace_back(0.02 * i, 0.01 * i, -10.);
+        dirs.emplace_back(Vec3d{0.001 * i, 0.0005 * i, 1.}.normalized());
+    }
+
+    std::vector<AABBMesh::hit_result> hits = emesh.query_ray_hit(sources, dirs);
+    std::vector<AABBMesh::hit_result> hits_up = emesh.query_ray_hit(sources, Vec3d::UnitZ());
+    REQUIRE(hits.size() == sources.size());
+    REQUIRE(hits_up.size() == sources.size());
+
+    for (size_t i = 0; i < sources.size(); ++i) {
+        auto hit = emesh.query_ray_hit(sources[i], dirs[i]);
+        REQUIRE(hits[i].face() == hit.face());
+        REQUIRE(hits[i].distance() == hit.distance());
+
+        auto hit_up = emesh.query_ray_hit(sources[i], Vec3d::UnitZ());
+        REQUIRE(hits_up[i].face() == hit_up.face());
+        REQUIRE(hits_up[i].distance() == hit_up.distance());
+    }
+}
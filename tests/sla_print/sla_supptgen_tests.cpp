@@ -4,6 +4,7 @@
 #include <libslic3r/ExPolygon.hpp>
 #include <libslic3r/BoundingBox.hpp>
 #include <libslic3r/SLA/SpatIndex.hpp>
+#include <libslic3r/TriangleMeshSlicer.hpp>
 
 #include "sla_test_utils.hpp"
 
@@ -139,4 +140,60 @@ TEST_CASE("Two parallel plates should be supported", "[SupGen][Hollowed]")
     REQUIRE(!pts.empty());
 }
 
+TEST_CASE("Support points placed onto reused layers match a fresh run", "[SupGen]")
+{
+    // Plates far from each other form independent island chains, the two
+    // close ones have to share a chain.
+    TriangleMesh mesh = make_cube(10., 10., 1.);
+    for (Vec3d offs : {Vec3d{30., 0., 0.}, Vec3d{0., 30., 5.}, Vec3d{10.5, 0., 2.}}) {
+        TriangleMesh plate = make_cube(10., 10., 1.);
+        plate.translate(offs.cast<float>());
+        mesh.merge(plate);
+    }
+    mesh.translate(0., 0., 5.);
+
+    auto                    bb      = cast<float>(mesh.bounding_box());
+    std::vector<float>      heights = grid(bb.min.z(), bb.max.z(), 0.1f);
+    std::vector<ExPolygons> slices  = slice_mesh_ex(mesh.its, heights, CLOSING_RADIUS);
+    AABBMesh                emesh{mesh};
+
+    auto calc = [&](const sla::SupportPointGenerator::Config &cfg,
+                    sla::SupportPointGenerator::Layers       *layers) {
+        sla::SupportPointGenerator spgen{emesh, cfg, []{}, [](int){}};
+        spgen.seed(0);
+        if (layers)
+            spgen.execute(*layers);
+        else
+            spgen.execute(slices, heights);
+
+        return spgen.output();
+    };
+
+    auto same_points = [](const sla::SupportPoints &a, const sla::SupportPoints &b) {
+        return a.size() == b.size() &&
+               std::equal(a.begin(), a.end(), b.begin(), [](auto &p, auto &q) {
+                   return p.pos == q.pos && p.head_front_radius == q.head_front_radius;
+               });
+    };
+
+    sla::SupportPointGenerator::Layers layers =
+        sla::SupportPointGenerator::make_layers(slices, heights, []{});
+
+    sla::SupportPointGenerator::Config cfg, cfg_dense;
+    cfg_dense.density_relative = 2.f;
+    cfg_dense.minimal_distance = 0.5f;
+
+    sla::SupportPoints pts       = calc(cfg, nullptr);
+    sla::SupportPoints pts_dense = calc(cfg_dense, nullptr);
+
+    REQUIRE(!pts.empty());
+    REQUIRE(pts_dense.size() > pts.size());
+    REQUIRE(min_point_distance(pts) >= cfg.minimal_distance);
+
+    // The same layers are used for both configs, in both orders.
+    REQUIRE(same_points(calc(cfg, &layers), pts));
+    REQUIRE(same_points(calc(cfg_dense, &layers), pts_dense));
+    REQUIRE(same_points(calc(cfg, &layers), pts));
+}
+
 }} // namespace Slic3r::sla